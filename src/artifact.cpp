@@ -1159,26 +1159,24 @@ void it_artifact_armor::deserialize(JsonObject &jo)
     }
 }
 
-bool save_artifacts( const std::string &path )
+void serialize_artifacts( std::ostream &fout )
 {
-    return write_to_file_exclusive( path, [&]( std::ostream &fout ) {
-        JsonOut json( fout );
-        json.start_array();
-        // We only want runtime types, otherwise static artifacts are loaded twice (on init and then on game load)
-        for( const itype *e : item_controller->get_runtime_types() ) {
-            if( !e->artifact ) {
-                continue;
-            }
+    JsonOut json( fout );
+    json.start_array();
+    // We only want runtime types, otherwise static artifacts are loaded twice (on init and then on game load)
+    for( const itype *e : item_controller->get_runtime_types() ) {
+        if( !e->artifact ) {
+            continue;
+        }
 
-            if( e->tool ) {
-                json.write( it_artifact_tool( *e ) );
+        if( e->tool ) {
+            json.write( it_artifact_tool( *e ) );
 
-            } else if( e->armor ) {
-                json.write( it_artifact_armor( *e ) );
-            }
+        } else if( e->armor ) {
+            json.write( it_artifact_armor( *e ) );
         }
-        json.end_array();
-    }, _( "artifact file" ) );
+    }
+    json.end_array();
 }
 
 template<typename E>
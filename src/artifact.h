@@ -107,7 +107,7 @@ std::string architects_cube();
 
 // note: needs to be called by main() before MAPBUFFER.load
 void load_artifacts( const std::string &filename );
-// save artifact definitions to json, path must be the same as for loading.
-bool save_artifacts( const std::string &path );
+// save artifact definitions to json, the file must be loaded with load_artifacts.
+void serialize_artifacts( std::ostream &fout );
 
 #endif
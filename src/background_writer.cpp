@@ -0,0 +1,144 @@
+#include "background_writer.h"
+
+#include "debug.h"
+#include "filesystem.h"
+#include "mapsharing.h"
+
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#if !defined _WIN32 && !defined __WIN32__
+#   include <unistd.h>
+#else
+#   include <io.h>
+#endif
+
+background_writer background_saves;
+
+void write_file_atomic( const std::string &path, const std::string &contents )
+{
+    // Same lock as fopen_exclusive, for shared maps.
+    const std::string lock_path = path + ".lock";
+    const int lock = getLock( lock_path.c_str() );
+    if( lock == -1 ) {
+        throw std::runtime_error( "file is locked" );
+    }
+    const std::string temp_path = path + ".tmp";
+    FILE *const file = fopen( temp_path.c_str(), "wb" );
+    bool ok = file != nullptr;
+    if( ok ) {
+        ok = fwrite( contents.data(), 1, contents.size(), file ) == contents.size();
+        ok = fflush( file ) == 0 && ok;
+        // Make sure the data is on the disk before the old file is replaced.
+#if !defined _WIN32 && !defined __WIN32__
+        ok = fsync( fileno( file ) ) == 0 && ok;
+#else
+        ok = _commit( _fileno( file ) ) == 0 && ok;
+#endif
+        ok = fclose( file ) == 0 && ok;
+    }
+    ok = ok && rename_file( temp_path, path );
+    releaseLock( lock, lock_path.c_str() );
+    if( !ok ) {
+        remove_file( temp_path );
+        throw std::runtime_error( "writing to file failed" );
+    }
+}
+
+background_writer::~background_writer()
+{
+    // Errors can't be reported anymore.
+    join();
+}
+
+void background_writer::add( const std::string &path, std::string contents )
+{
+    // std::function needs a copyable function object, share the contents instead of copying them.
+    const auto data = std::make_shared<std::string>( std::move( contents ) );
+    add( path, [path, data]() {
+        write_file_atomic( path, *data );
+    } );
+}
+
+void background_writer::add( const std::string &path, std::function<void()> job )
+{
+    added.emplace_back( path, std::move( job ) );
+}
+
+void background_writer::discard()
+{
+    added.clear();
+}
+
+void background_writer::join()
+{
+    if( worker.joinable() ) {
+        worker.join();
+    }
+    done = true;
+}
+
+void background_writer::start()
+{
+    // Errors of the previous batch are kept for wait or check.
+    join();
+    if( added.empty() ) {
+        return;
+    }
+    writing.clear();
+    writing.swap( added );
+    writing_paths.clear();
+    for( auto &job : writing ) {
+        writing_paths.insert( job.first );
+    }
+    done = false;
+    const auto write_all = [this]() {
+        for( auto &file : writing ) {
+            try {
+                file.second();
+            } catch( const std::exception &err ) {
+                errors.push_back( file.first + ": " + err.what() );
+            }
+        }
+        done = true;
+    };
+    try {
+        worker = std::thread( write_all );
+    } catch( const std::system_error &err ) {
+        DebugLog( D_WARNING, D_MAIN ) << "could not start the save thread: " << err.what();
+        write_all();
+    }
+}
+
+void background_writer::wait()
+{
+    start();
+    join();
+    writing.clear();
+    writing_paths.clear();
+    if( !errors.empty() ) {
+        std::string message = errors.front();
+        if( errors.size() > 1 ) {
+            message += " (and " + std::to_string( errors.size() - 1 ) + " more files)";
+        }
+        errors.clear();
+        throw std::runtime_error( message );
+    }
+}
+
+void background_writer::wait_for( const std::string &path )
+{
+    if( !done && writing_paths.count( path ) > 0 ) {
+        join();
+    }
+}
+
+bool background_writer::check()
+{
+    if( done ) {
+        wait();
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#ifndef BACKGROUND_WRITER_H
+#define BACKGROUND_WRITER_H
+
+#include <atomic>
+#include <functional>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#if (defined _WIN32 || defined WINDOWS) && !defined _MSC_VER
+#   include "mingw.thread.h"
+#endif
+
+/**
+ * Writes @p contents to @p path through a temporary file that is renamed over @p path,
+ * so a crash leaves either the old or the new file. Throws std::runtime_error on failure.
+ */
+void write_file_atomic( const std::string &path, const std::string &contents );
+
+/**
+ * Writes save files on a background thread, so that saving only has to serialize the
+ * game state into memory. Files are collected with @ref add and written in one batch
+ * by @ref start, in the order they were added.
+ * All functions must be called from the main thread. Code that reads a file which may
+ * still be written must call @ref wait_for first.
+ */
+class background_writer
+{
+    public:
+        background_writer() = default;
+        /** Finishes writing the current batch. */
+        ~background_writer();
+
+        /** Adds a file to the next batch, it is written with @ref write_file_atomic. */
+        void add( const std::string &path, std::string contents );
+        /**
+         * Adds a job that changes the file at @p path to the next batch, it is run on the
+         * background thread and may throw std::exception.
+         */
+        void add( const std::string &path, std::function<void()> job );
+        /**
+         * Drops the files added since the last @ref start, for a save that failed before
+         * all of its files were added. The batch that is being written is not affected.
+         */
+        void discard();
+        /**
+         * Starts writing the files added since the last call. The previous batch is
+         * finished first (see @ref wait). If no thread can be started, the files are
+         * written right away.
+         */
+        void start();
+        /**
+         * Starts the added files (if any) and blocks until all files are written.
+         * Throws std::runtime_error if writing a file of the finished batch failed.
+         */
+        void wait();
+        /**
+         * If the batch that is being written contains @p path, blocks until it is written.
+         * Errors are kept for the next @ref wait or @ref check.
+         */
+        void wait_for( const std::string &path );
+        /**
+         * Does not block. If the current batch is written, throws std::runtime_error if
+         * writing one of its files failed.
+         * @return Whether all files so far were written, false if they are still being written.
+         */
+        bool check();
+
+    private:
+        void join();
+
+        using job_list = std::vector<std::pair<std::string, std::function<void()>>>;
+        /** Jobs for the next batch, with the paths of their files. */
+        job_list added;
+        /** The batch that the thread runs, only touched by the main thread when it's done. */
+        job_list writing;
+        /** Paths of the files in @ref writing. */
+        std::set<std::string> writing_paths;
+        /** Errors of the current batch, written by the thread. */
+        std::vector<std::string> errors;
+        std::atomic<bool> done{ true };
+        std::thread worker;
+};
+
+extern background_writer background_saves;
+
+#endif
@@ -1118,7 +1118,8 @@ void cata_tiles::process_minimap_cache_updates()
     SDL_Rect rectangle;
     bool draw_with_dots = false;
 
-    const std::string mode = get_option<std::string>( "PIXEL_MINIMAP_MODE" );
+    static const cached_option<std::string> minimap_mode( "PIXEL_MINIMAP_MODE" );
+    const std::string &mode = minimap_mode.get();
     if( mode == "solid" ) {
         rectangle.w = minimap_tile_size.x;
         rectangle.h = minimap_tile_size.y;
@@ -1211,7 +1212,8 @@ void cata_tiles::init_minimap( int destx, int desty, int width, int height )
     minimap_tile_size.x = std::max( width / minimap_tiles_range.x, 1 );
     minimap_tile_size.y = std::max( height / minimap_tiles_range.y, 1 );
     //maintain a square "pixel" shape
-    if( get_option<bool>( "PIXEL_MINIMAP_RATIO" ) ) {
+    static const cached_option<bool> minimap_ratio( "PIXEL_MINIMAP_RATIO" );
+    if( minimap_ratio ) {
         int smallest_size = std::min( minimap_tile_size.x, minimap_tile_size.y );
         minimap_tile_size.x = smallest_size;
         minimap_tile_size.y = smallest_size;
@@ -1277,7 +1279,8 @@ void cata_tiles::draw_minimap( int destx, int desty, const tripoint &center, int
     auto vision_cache = g->u.get_vision_modes();
     bool nv_goggle = vision_cache[NV_GOGGLES];
 
-    const int brightness = get_option<int>( "PIXEL_MINIMAP_BRIGHTNESS" );
+    static const cached_option<int> minimap_brightness( "PIXEL_MINIMAP_BRIGHTNESS" );
+    const int brightness = minimap_brightness;
     //check all of exposed submaps (MAPSIZE*MAPSIZE submaps) and apply new color changes to the cache
     for( int y = 0; y < MAPSIZE * SEEY; y++ ) {
         for( int x = 0; x < MAPSIZE * SEEX; x++ ) {
@@ -1374,7 +1377,8 @@ void cata_tiles::draw_minimap( int destx, int desty, const tripoint &center, int
 
     //handles the enemy faction red highlights
     //this value should be divisible by 200
-    const int indicator_length = get_option<int>( "PIXEL_MINIMAP_BLINK" ) * 200; //default is 2000 ms, 2 seconds
+    static const cached_option<int> minimap_blink( "PIXEL_MINIMAP_BLINK" );
+    const int indicator_length = minimap_blink * 200; //default is 2000 ms, 2 seconds
 
     int flicker = 100;
     int mixture = 0;
@@ -2102,7 +2106,7 @@ bool cata_tiles::draw_field_or_item( const tripoint &p, lit_level ll, int &heigh
         if( !g->m.sees_some_items( p, g->u ) ) {
             return false;
         }
-        const maptile &cur_maptile = g->m.maptile_at( p );
+        const const_maptile &cur_maptile = g->m.read_only().maptile_at( p );
         // get the last item in the stack, it will be used for display
         const item &displayed_item = cur_maptile.get_uppermost_item();
         // get the item's name, as that is the key used to find it in the map
@@ -643,6 +643,7 @@ comp_selection<item_comp> player::select_item_component( const std::vector<item_
 
     for( const auto &component : components ) {
         itype_id type = component.type;
+        const itype_int_id index = component.type_index();
         int count = ( component.count > 0 ) ? component.count * batch : abs( component.count );
         bool pl = false, mp = false;
 
@@ -651,11 +652,11 @@ comp_selection<item_comp> player::select_item_component( const std::vector<item_
                 player_has.push_back( component );
                 pl = true;
             }
-            if( map_inv.has_charges( type, count ) ) {
+            if( map_inv.has_charges( index, count ) ) {
                 map_has.push_back( component );
                 mp = true;
             }
-            if( !pl && !mp && charges_of( type ) + map_inv.charges_of( type ) >= count ) {
+            if( !pl && !mp && charges_of( type ) + map_inv.charges_of( index ) >= count ) {
                 mixed.push_back( component );
             }
         } else { // Counting by units, not charges
@@ -664,11 +665,11 @@ comp_selection<item_comp> player::select_item_component( const std::vector<item_
                 player_has.push_back( component );
                 pl = true;
             }
-            if( map_inv.has_components( type, count ) ) {
+            if( map_inv.has_components( index, count ) ) {
                 map_has.push_back( component );
                 mp = true;
             }
-            if( !pl && !mp && amount_of( type ) + map_inv.amount_of( type ) >= count ) {
+            if( !pl && !mp && amount_of( type ) + map_inv.amount_of( index ) >= count ) {
                 mixed.push_back( component );
             }
 
@@ -850,15 +851,16 @@ player::select_tool_component( const std::vector<tool_comp> &tools, int batch, i
     // Use charges of any tools that require charges used
     for( auto it = tools.begin(); it != tools.end() && !found_nocharge; ++it ) {
         itype_id type = it->type;
+        const itype_int_id index = it->type_index();
         if( it->count > 0 ) {
             long count = it->count * batch;
             if( has_charges( type, count ) ) {
                 player_has.push_back( *it );
             }
-            if( map_inv.has_charges( type, count ) ) {
+            if( map_inv.has_charges( index, count ) ) {
                 map_has.push_back( *it );
             }
-        } else if( has_amount( type, 1 ) || map_inv.has_tools( type, 1 ) ) {
+        } else if( has_amount( type, 1 ) || map_inv.has_tools( index, 1 ) ) {
             selected.comp = *it;
             found_nocharge = true;
         }
@@ -1007,8 +1009,8 @@ ret_val<bool> player::can_disassemble( const item &obj, const inventory &inv ) c
     for( const auto &opts : dis.get_tools() ) {
         const bool found = std::any_of( opts.begin(), opts.end(),
         [&]( const tool_comp & tool ) {
-            return ( tool.count <= 0 && inv.has_tools( tool.type, 1 ) ) ||
-                   ( tool.count >  0 && inv.has_charges( tool.type, tool.count ) );
+            return ( tool.count <= 0 && inv.has_tools( tool.type_index(), 1 ) ) ||
+                   ( tool.count >  0 && inv.has_charges( tool.type_index(), tool.count ) );
         } );
 
         if( !found ) {
@@ -1116,7 +1118,7 @@ item_comp find_component( const std::vector<item_comp> &altercomps, const item &
 {
     for( auto &comp : altercomps ) {
         for( auto &elem : dis_item.components ) {
-            if( elem.typeId() == comp.type ) {
+            if( elem.typeIndex() == comp.type_index() ) {
                 return comp;
             }
         }
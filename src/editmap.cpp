@@ -1768,6 +1768,7 @@ int editmap::mapgen_preview( real_coords &tc, uimenu &gmenu )
                             submap *srcsm = tmpmap.get_submap_at_grid( x, y, target.z );
                             destsm->is_uniform = false;
                             srcsm->is_uniform = false;
+                            destsm->mark_modified();
 
                             for( auto &v : destsm->vehicles ) {
                                 auto &ch = g->m.access_cache( v->smz );
@@ -1809,7 +1810,9 @@ int editmap::mapgen_preview( real_coords &tc, uimenu &gmenu )
                             std::memcpy( destsm->lum, srcsm->lum, sizeof( srcsm->lum ) ); // emissive items
                             for( int x = 0; x < SEEX; ++x ) {
                                 for( int y = 0; y < SEEY; ++y ) {
-                                    destsm->itm[x][y].swap( srcsm->itm[x][y] );
+                                    if( destsm->has_items( x, y ) || srcsm->has_items( x, y ) ) {
+                                        destsm->get_items( x, y ).swap( srcsm->get_items( x, y ) );
+                                    }
                                     destsm->cosmetics[x][y].swap( srcsm->cosmetics[x][y] );
                                 }
                             }
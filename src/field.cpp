@@ -469,8 +469,9 @@ bool map::process_fields()
         zlev_dirty = false;
         for( int x = 0; x < my_MAPSIZE; x++ ) {
             for( int y = 0; y < my_MAPSIZE; y++ ) {
-                submap * const current_submap = get_submap_at_grid( x, y, z );
-                if( current_submap->field_count > 0 ) {
+                if( read_only().get_submap_at_grid( x, y, z )->field_count > 0 ) {
+                    submap *const current_submap = get_submap_at_grid( x, y, z );
+                    current_submap->mark_modified();
                     const bool cur_dirty = process_fields_in_submap( current_submap, x, y, z );
                     zlev_dirty |= cur_dirty;
                 }
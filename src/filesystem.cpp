@@ -92,15 +92,9 @@ bool remove_file(const std::string &path)
 #if (defined _WIN32 || defined __WIN32__)
 bool rename_file(const std::string &old_path, const std::string &new_path)
 {
-    // Windows rename function does not override existing targets, so we
-    // have to remove the target to make it compatible with the linux rename
-    if (file_exist(new_path)) {
-        if(!remove_file(new_path)) {
-            return false;
-        }
-    }
-
-    return rename(old_path.c_str(), new_path.c_str()) == 0;
+    // Windows rename function does not override existing targets, MoveFileEx replaces
+    // them in one step like the linux rename, so the target is never missing.
+    return MoveFileEx( old_path.c_str(), new_path.c_str(), MOVEFILE_REPLACE_EXISTING ) != 0;
 }
 #else
 bool rename_file(const std::string &old_path, const std::string &new_path)
@@ -4,9 +4,43 @@
 
 #include <map>
 #include <algorithm>
+#include <deque>
+#include <unordered_map>
 
 std::map<std::string, json_flag> json_flags_all;
 
+namespace
+{
+/** The definitions in @ref json_flags_all by the int ids of their names. */
+std::vector<const json_flag *> json_flags_by_id;
+
+/** The names of all interned flags by their int ids, see @ref json_flag::intern. */
+struct flag_names {
+    std::unordered_map<std::string, int> ids;
+    // A deque, so the names don't move when more flags are interned.
+    std::deque<std::string> names;
+};
+
+flag_names &interned_flags()
+{
+    // Items with flags may be created during static initialization.
+    static flag_names instance;
+    return instance;
+}
+}
+
+template<>
+bool int_id<json_flag>::is_valid() const
+{
+    return _id >= 0 && static_cast<size_t>( _id ) < interned_flags().names.size();
+}
+
+template<>
+const json_flag &int_id<json_flag>::obj() const
+{
+    return json_flag::get( *this );
+}
+
 const json_flag &json_flag::get( const std::string &id )
 {
     static json_flag null_flag;
@@ -14,6 +48,41 @@ const json_flag &json_flag::get( const std::string &id )
     return iter != json_flags_all.end() ? iter->second : null_flag;
 }
 
+const json_flag &json_flag::get( const flag_int_id &id )
+{
+    static json_flag null_flag;
+    if( id.to_i() >= 0 && static_cast<size_t>( id.to_i() ) < json_flags_by_id.size() &&
+        json_flags_by_id[id.to_i()] != nullptr ) {
+        return *json_flags_by_id[id.to_i()];
+    }
+    return null_flag;
+}
+
+flag_int_id json_flag::intern( const std::string &flag )
+{
+    flag_names &flags = interned_flags();
+    const auto iter = flags.ids.find( flag );
+    if( iter != flags.ids.end() ) {
+        return flag_int_id( iter->second );
+    }
+    const int id = flags.names.size();
+    flags.names.push_back( flag );
+    flags.ids.emplace( flag, id );
+    return flag_int_id( id );
+}
+
+flag_int_id json_flag::find( const std::string &flag )
+{
+    const flag_names &flags = interned_flags();
+    const auto iter = flags.ids.find( flag );
+    return flag_int_id( iter != flags.ids.end() ? iter->second : -1 );
+}
+
+const std::string &json_flag::name( const flag_int_id &flag )
+{
+    return interned_flags().names[flag.to_i()];
+}
+
 void json_flag::load( JsonObject &jo )
 {
     auto id = jo.get_string( "id" );
@@ -22,6 +91,12 @@ void json_flag::load( JsonObject &jo )
     jo.read( "info", f.info_ );
     jo.read( "conflicts", f.conflicts_ );
     jo.read( "inherit", f.inherit_ );
+
+    const flag_int_id fid = intern( id );
+    if( json_flags_by_id.size() <= static_cast<size_t>( fid.to_i() ) ) {
+        json_flags_by_id.resize( fid.to_i() + 1, nullptr );
+    }
+    json_flags_by_id[fid.to_i()] = &f;
 }
 
 void json_flag::check_consistency()
@@ -43,4 +118,84 @@ void json_flag::check_consistency()
 void json_flag::reset()
 {
     json_flags_all.clear();
+    json_flags_by_id.clear();
+}
+
+size_t flag_set::count( const flag_int_id &flag ) const
+{
+    if( flag.to_i() < 0 ) {
+        return 0;
+    } else if( static_cast<size_t>( flag.to_i() ) < bit_count ) {
+        return bits[flag.to_i()];
+    }
+    return std::binary_search( spill.begin(), spill.end(), flag );
+}
+
+size_t flag_set::count( const std::string &flag ) const
+{
+    return count( json_flag::find( flag ) );
+}
+
+void flag_set::insert( const flag_int_id &flag )
+{
+    if( static_cast<size_t>( flag.to_i() ) < bit_count ) {
+        bits.set( flag.to_i() );
+        return;
+    }
+    const auto iter = std::lower_bound( spill.begin(), spill.end(), flag );
+    if( iter == spill.end() || *iter != flag ) {
+        spill.insert( iter, flag );
+    }
+}
+
+void flag_set::insert( const std::string &flag )
+{
+    insert( json_flag::intern( flag ) );
+}
+
+void flag_set::erase( const flag_int_id &flag )
+{
+    if( flag.to_i() < 0 ) {
+        return;
+    } else if( static_cast<size_t>( flag.to_i() ) < bit_count ) {
+        bits.reset( flag.to_i() );
+        return;
+    }
+    const auto iter = std::lower_bound( spill.begin(), spill.end(), flag );
+    if( iter != spill.end() && *iter == flag ) {
+        spill.erase( iter );
+    }
+}
+
+void flag_set::erase( const std::string &flag )
+{
+    erase( json_flag::find( flag ) );
+}
+
+std::set<std::string> flag_set::names() const
+{
+    std::set<std::string> result;
+    for( size_t i = 0; i < bit_count; i++ ) {
+        if( bits[i] ) {
+            result.insert( json_flag::name( flag_int_id( i ) ) );
+        }
+    }
+    for( const flag_int_id &flag : spill ) {
+        result.insert( json_flag::name( flag ) );
+    }
+    return result;
+}
+
+void flag_set::serialize( JsonOut &jsout ) const
+{
+    jsout.write( names() );
+}
+
+void flag_set::deserialize( JsonIn &jsin )
+{
+    clear();
+    jsin.start_array();
+    while( !jsin.end_array() ) {
+        insert( jsin.get_string() );
+    }
 }
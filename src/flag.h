@@ -3,8 +3,19 @@
 #define FLAG_H
 
 #include "json.h"
+#include "int_id.h"
 
+#include <bitset>
 #include <set>
+#include <string>
+#include <vector>
+
+class json_flag;
+/**
+ * Dense int id of a flag name, see @ref json_flag::intern. Every flag that is stored in a
+ * @ref flag_set has one. They are not stable between game starts and must not be saved.
+ */
+using flag_int_id = int_id<json_flag>;
 
 class json_flag
 {
@@ -13,6 +24,22 @@ class json_flag
     public:
         /** Fetches flag definition (or null flag if not found) */
         static const json_flag &get( const std::string &id );
+        /** @copydoc get(const std::string &) */
+        static const json_flag &get( const flag_int_id &id );
+
+        /**
+         * Returns the int id of the flag name, giving it the next free one if it has none yet.
+         * Flags defined in JSON get theirs when they are loaded, so they have the smallest ids.
+         * The ids are kept when the game data is unloaded. Main thread only.
+         */
+        static flag_int_id intern( const std::string &flag );
+        /**
+         * Returns the int id of the flag name, or an invalid one if it has none, which means
+         * it's not in any @ref flag_set.
+         */
+        static flag_int_id find( const std::string &flag );
+        /** The name of an interned flag. */
+        static const std::string &name( const flag_int_id &flag );
 
         /** Get identifier of flag as specified in JSON */
         const std::string &id() const {
@@ -52,4 +79,51 @@ class json_flag
         static void reset();
 };
 
+/**
+ * A set of flag names, stored as bits indexed by their @ref flag_int_id. The few flags whose
+ * ids don't fit into the bits are kept in a sorted list. The string functions mirror those
+ * of `std::set<std::string>`.
+ */
+class flag_set
+{
+    public:
+        /** Flags with smaller ids are stored as bits. */
+        static const size_t bit_count = 256;
+
+        size_t count( const flag_int_id &flag ) const;
+        size_t count( const std::string &flag ) const;
+        void insert( const flag_int_id &flag );
+        void insert( const std::string &flag );
+        void erase( const flag_int_id &flag );
+        void erase( const std::string &flag );
+
+        bool empty() const {
+            return bits.none() && spill.empty();
+        }
+        size_t size() const {
+            return bits.count() + spill.size();
+        }
+        void clear() {
+            bits.reset();
+            spill.clear();
+        }
+        /** The names of the flags, sorted like a `std::set<std::string>`. */
+        std::set<std::string> names() const;
+
+        bool operator==( const flag_set &rhs ) const {
+            return bits == rhs.bits && spill == rhs.spill;
+        }
+        bool operator!=( const flag_set &rhs ) const {
+            return !operator==( rhs );
+        }
+
+        /** Written as an array of the names, like a `std::set<std::string>`. */
+        void serialize( JsonOut &jsout ) const;
+        void deserialize( JsonIn &jsin );
+
+    private:
+        std::bitset<bit_count> bits;
+        std::vector<flag_int_id> spill;
+};
+
 #endif
@@ -1,5 +1,6 @@
 #include "game.h"
 
+#include "background_writer.h"
 #include "coordinate_conversions.h"
 #include "rng.h"
 #include "input.h"
@@ -1030,7 +1031,9 @@ bool game::cleanup_at_end()
         save_artifacts();
 
         // and the overmap, and the local map.
-        save_maps(); //Omap also contains the npcs who need to be saved.
+        if( save_maps() ) { //Omap also contains the npcs who need to be saved.
+            write_saves( false );
+        }
     }
 
     if (uquit == QUIT_DIED || uquit == QUIT_SUICIDE) {
@@ -1293,7 +1296,8 @@ static int veh_lumi( vehicle &veh )
 
 void game::calc_driving_offset(vehicle *veh)
 {
-    if (veh == nullptr || !get_option<bool>( "DRIVING_VIEW_OFFSET" ) ) {
+    static const cached_option<bool> driving_view_option( "DRIVING_VIEW_OFFSET" );
+    if( veh == nullptr || !driving_view_option ) {
         set_driving_view_offset(point(0, 0));
         return;
     }
@@ -1432,9 +1436,13 @@ bool game::do_turn()
 
     u.update_body();
 
+    check_background_save();
+    // Unload parts of the map the player left long ago if they use too much memory.
+    MAPBUFFER.evict();
     // Auto-save if autosave is enabled
-    if (get_option<bool>( "AUTOSAVE" ) &&
-        calendar::once_every(get_option<int>( "AUTOSAVE_TURNS" ) ) &&
+    static const cached_option<bool> autosave_enabled( "AUTOSAVE" );
+    static const cached_option<int> autosave_turns( "AUTOSAVE_TURNS" );
+    if( autosave_enabled && calendar::once_every( autosave_turns ) &&
         !u.is_dead_state()) {
         autosave();
     }
@@ -1513,7 +1521,9 @@ bool game::do_turn()
 
     // Process power and fuel consumption for all vehicles, including off-map ones.
     // m.vehmove used to do this, but now it only give them moves instead.
-    for( auto &elem : MAPBUFFER ) {
+    // Off-map vehicles with nothing running sleep until they are in the reality bubble
+    // again, vehicle::update_time passes the time they spent outside then.
+    for( auto &elem : MAPBUFFER.vehicle_submaps() ) {
         tripoint sm_loc = elem.first;
         point sm_topleft = sm_to_ms_copy(sm_loc.x, sm_loc.y);
         point in_reality = m.getlocal(sm_topleft);
@@ -1521,9 +1531,18 @@ bool game::do_turn()
         submap *sm = elem.second;
 
         const bool in_bubble_z = m.has_zlevels() || sm_loc.z == get_levz();
+        const bool in_bubble = in_bubble_z && m.inbounds( in_reality.x, in_reality.y );
         for( auto &veh : sm->vehicles ) {
+            if( in_bubble ) {
+                veh->asleep = false;
+            } else if( veh->asleep ) {
+                continue;
+            } else if( !veh->needs_processing_off_map() ) {
+                veh->asleep = true;
+                continue;
+            }
             veh->power_parts();
-            veh->idle( in_bubble_z && m.inbounds(in_reality.x, in_reality.y) );
+            veh->idle( in_bubble );
         }
     }
     m.process_fields();
@@ -1538,7 +1557,8 @@ bool game::do_turn()
     monmove();
     update_stair_monsters();
     u.process_turn();
-    if( u.moves < 0 && get_option<bool>( "FORCE_REDRAW" ) ) {
+    static const cached_option<bool> force_redraw( "FORCE_REDRAW" );
+    if( u.moves < 0 && force_redraw ) {
         draw();
         refresh_display();
     }
@@ -2213,7 +2233,10 @@ input_context game::get_player_input(std::string &action)
 
     user_turn current_turn;
 
-    if (get_option<bool>( "ANIMATIONS" ) ) {
+    static const cached_option<bool> animations( "ANIMATIONS" );
+    static const cached_option<bool> animation_rain( "ANIMATION_RAIN" );
+    static const cached_option<bool> animation_sct( "ANIMATION_SCT" );
+    if( animations ) {
         int iStartX = (TERRAIN_WINDOW_WIDTH > 121) ? (TERRAIN_WINDOW_WIDTH - 121) / 2 : 0;
         int iStartY = (TERRAIN_WINDOW_HEIGHT > 121) ? (TERRAIN_WINDOW_HEIGHT - 121) / 2 : 0;
         int iEndX = (TERRAIN_WINDOW_WIDTH > 121) ? TERRAIN_WINDOW_WIDTH - (TERRAIN_WINDOW_WIDTH - 121) / 2 :
@@ -2265,7 +2288,7 @@ input_context game::get_player_input(std::string &action)
                 break;
             }
 
-            if( bWeatherEffect && get_option<bool>( "ANIMATION_RAIN" ) ) {
+            if( bWeatherEffect && animation_rain ) {
                 /*
                 Location to add rain drop animation bits! Since it refreshes w_terrain it can be added to the animation section easily
                 Get tile information from above's weather information:
@@ -2311,7 +2334,7 @@ input_context game::get_player_input(std::string &action)
                 }
             }
             // don't bother calculating SCT if we won't show it
-            if (uquit != QUIT_WATCH && get_option<bool>( "ANIMATION_SCT" ) ) {
+            if( uquit != QUIT_WATCH && animation_sct ) {
 #ifdef TILES
                 if (!use_tiles) {
 #endif
@@ -3631,6 +3654,7 @@ bool game::load_master(std::string worldname)
 {
     using namespace std::placeholders;
     const auto datafile = world_generator->get_world( worldname )->world_path + "/master.gsav";
+    background_saves.wait_for( datafile );
     return read_from_file_optional( datafile, std::bind( &game::unserialize_master, this, _1 ) );
 }
 
@@ -3680,6 +3704,9 @@ void game::load(std::string worldname, const save_t &name)
     // This should be initialized more globally (in player/Character constructor)
     u.ret_null = item( "null", 0 );
     u.weapon = item("null", 0);
+    background_saves.wait_for( worldpath + name.base_path() + ".weather" );
+    background_saves.wait_for( worldpath + name.base_path() + ".log" );
+    background_saves.wait_for( playerfile );
     if( !read_from_file( playerfile, std::bind( &game::unserialize, this, _1 ) ) ) {
         return;
     }
@@ -3756,6 +3783,7 @@ void game::load_world_modfiles( WORLDPTR world, loading_ui &ui )
             mods.insert( mods.begin(), "dda" );
         }
 
+        background_saves.wait_for( world->world_path + "/artifacts.gsav" );
         load_artifacts(world->world_path + "/artifacts.gsav");
         // this code does not care about mod dependencies,
         // it assumes that those dependencies are static and
@@ -3815,33 +3843,56 @@ bool game::load_packs( const std::string &msg, const std::vector<std::string>& p
 }
 
 //Saves all factions and missions and npcs.
-bool game::save_factions_missions_npcs()
+void game::save_factions_missions_npcs()
 {
     std::string masterfile = world_generator->active_world->world_path + "/master.gsav";
-    return write_to_file_exclusive( masterfile, [&]( std::ostream &fout ) {
-        serialize_master(fout);
-    }, _( "factions data" ) );
+    std::ostringstream fout;
+    serialize_master( fout );
+    background_saves.add( masterfile, fout.str() );
 }
 
-bool game::save_artifacts()
+void game::save_artifacts()
 {
     std::string artfilename = world_generator->active_world->world_path + "/artifacts.gsav";
-    return ::save_artifacts( artfilename );
+    std::ostringstream fout;
+    serialize_artifacts( fout );
+    background_saves.add( artfilename, fout.str() );
 }
 
 bool game::save_maps()
 {
     try {
         m.save();
-        overmap_buffer.save(); // can throw
-        MAPBUFFER.save(); // can throw
+        overmap_buffer.save( true ); // can throw
+        MAPBUFFER.save( false, get_option<bool>( "SAVE_UNCHANGED_MAP" ), true ); // can throw
         return true;
     } catch( const std::exception &err ) {
+        // Don't write half of the save with the next batch. The quads that were
+        // already added are marked as saved, so the next save writes all of them.
+        background_saves.discard();
+        MAPBUFFER.write_failed();
         popup( _( "Failed to save the maps: %s" ), err.what() );
         return false;
     }
 }
 
+bool game::write_saves( const bool in_background )
+{
+    try {
+        if( in_background ) {
+            background_saves.start();
+        } else {
+            background_saves.wait(); // can throw
+            MAPBUFFER.write_confirmed();
+        }
+        return true;
+    } catch( const std::exception &err ) {
+        MAPBUFFER.write_failed();
+        popup( _( "Failed to save the game: %s" ), err.what() );
+        return false;
+    }
+}
+
 bool game::save_uistate()
 {
     std::string savefile = world_generator->active_world->world_path + "/uistate.json";
@@ -3850,30 +3901,31 @@ bool game::save_uistate()
     }, _( "uistate data" ) );
 }
 
-bool game::save_player_data()
+void game::save_player_data()
 {
     const std::string playerfile = world_generator->active_world->world_path + "/" + base64_encode(u.name);
 
-    const bool saved_data = write_to_file( playerfile + ".sav", [&]( std::ostream &fout ) {
-        serialize(fout);
-    }, _( "player data" ) );
-    const bool saved_weather = write_to_file( playerfile + ".weather", [&]( std::ostream &fout ) {
-        save_weather(fout);
-    }, _( "weather state" ) );
-    const bool saved_log = write_to_file( playerfile + ".log", [&]( std::ostream &fout ) {
-        fout << u.dump_memorial();
-    }, _( "player memorial" ) );
-
-    return saved_data && saved_weather && saved_log;
+    std::ostringstream weather;
+    save_weather( weather );
+    background_saves.add( playerfile + ".weather", weather.str() );
+    background_saves.add( playerfile + ".log", u.dump_memorial() );
+    std::ostringstream data;
+    serialize( data );
+    background_saves.add( playerfile + ".sav", data.str() );
 }
 
-bool game::save()
+bool game::save( const bool in_background )
 {
     try {
-        if ( !save_player_data() ||
-             !save_factions_missions_npcs() ||
-             !save_artifacts() ||
-             !save_maps() ||
+        // All files of the game state are written in one batch, the player file last. If the
+        // game crashes while they are written, the player file is the one of the last save.
+        if( !save_maps() ) {
+            return false;
+        }
+        save_artifacts();
+        save_factions_missions_npcs();
+        save_player_data();
+        if ( !write_saves( in_background ) ||
              !get_auto_pickup().save_character() ||
              !get_safemode().save_character() ||
              !save_uistate()){
@@ -3883,6 +3935,8 @@ bool game::save()
             return true;
         }
     } catch (std::ios::failure &err) {
+        background_saves.discard();
+        MAPBUFFER.write_failed();
         popup(_("Failed to save game data"));
         return false;
     }
@@ -13027,6 +13081,8 @@ void game::update_map(int &x, int &y)
 
     // Update what parts of the world map we can see
     update_overmap_seen();
+    // Start preparing the next overmap before we need it
+    overmap_buffer.prefetch_near( u.global_omt_location() );
 }
 
 void game::update_overmap_seen()
@@ -13571,7 +13627,7 @@ void game::quicksave()
     time_t now = time(nullptr);    //timestamp for start of saving procedure
 
     //perform save
-    save();
+    save( get_option<bool>( "SAVE_IN_BACKGROUND" ) );
     //Now reset counters for autosaving, so we don't immediately autosave after a quicksave or autosave.
     moves_since_last_save = 0;
     last_save_timestamp = now;
@@ -13600,6 +13656,18 @@ void game::quickload()
     }
 }
 
+void game::check_background_save()
+{
+    try {
+        if( background_saves.check() ) {
+            MAPBUFFER.write_confirmed();
+        }
+    } catch( const std::exception &err ) {
+        MAPBUFFER.write_failed();
+        popup( _( "Failed to save the game: %s" ), err.what() );
+    }
+}
+
 void game::autosave()
 {
     //Don't autosave if the min-autosave interval has not passed since the last autosave/quicksave.
@@ -194,9 +194,22 @@ class game
 
         /** write statisics to stdout and @return true if sucessful */
         bool dump_stats( const std::string& what, dump_mode mode, const std::vector<std::string> &opts );
+        /**
+         * Generate and save the overmaps from @p om_min to @p om_max (overmap coordinates)
+         * of the given world, and every map square within @p radius overmap terrain tiles
+         * of the center of that area. Overmaps are generated on all cores, the result only
+         * depends on @p world_seed. Progress is written to stdout.
+         * @return true if successful
+         */
+        bool pregenerate_world( const std::string &worldname, const point &om_min, const point &om_max,
+                                int radius, unsigned int world_seed );
 
-        /** Returns false if saving failed. */
-        bool save();
+        /**
+         * Returns false if saving failed.
+         * @param in_background Write the files on a background thread, see
+         * @ref background_saves. Errors are reported by @ref check_background_save.
+         */
+        bool save( bool in_background = false );
         /** Returns a list of currently active character saves. */
         std::vector<std::string> list_active_characters();
         void write_memorial_file(std::string sLastWords);
@@ -838,13 +851,14 @@ class game
         void start_special_game(special_game_id gametype); // See gamemode.cpp
 
         //private save functions.
-        // returns false if saving failed for whatever reason
-        bool save_factions_missions_npcs();
+        // these add the files to background_saves, they are written by write_saves
+        void save_factions_missions_npcs();
         void serialize_master(std::ostream &fout);
-        // returns false if saving failed for whatever reason
-        bool save_artifacts();
+        void save_artifacts();
         // returns false if saving failed for whatever reason
         bool save_maps();
+        // writes the files added to background_saves, returns false if saving failed
+        bool write_saves( bool in_background );
         void save_weather(std::ostream &fout);
         // returns false if saving failed for whatever reason
         bool save_uistate();
@@ -1028,6 +1042,8 @@ private:
         //  int autosave_timeout();  // If autosave enabled, how long we should wait for user inaction before saving.
         void autosave();         // automatic quicksaves - Performs some checks before calling quicksave()
         void quicksave();        // Saves the game without quitting
+        /** Reports errors of the files that were written in the background, does not block. */
+        void check_background_save();
         void quickload();        // Loads the previously saved game if it exists
 
         // Input related
@@ -1094,7 +1110,7 @@ private:
         Creature *is_hostile_within(int distance);
 
         void move_save_to_graveyard();
-        bool save_player_data();
+        void save_player_data();
 };
 
 #endif
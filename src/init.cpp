@@ -38,6 +38,7 @@
 #include "ammo.h"
 #include "debug.h"
 #include "path_info.h"
+#include "cata_utility.h"
 #include "requirements.h"
 #include "start_location.h"
 #include "scenario.h"
@@ -67,11 +68,22 @@
 #include "loading_ui.h"
 
 #include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iterator>
+#include <memory>
 #include <string>
+#include <system_error>
+#include <thread>
 #include <vector>
 #include <fstream>
 #include <sstream> // for throwing errors
 #include <locale> // for loading names
+#if (defined _WIN32 || defined WINDOWS) && !defined _MSC_VER
+#   include "mingw.thread.h"
+#endif
 
 DynamicDataLoader::DynamicDataLoader()
 {
@@ -88,23 +100,89 @@ DynamicDataLoader &DynamicDataLoader::get_instance()
 
 void DynamicDataLoader::load_object( JsonObject &jo, const std::string &src )
 {
+    const auto start = timing_start();
     std::string type = jo.get_string("type");
     t_type_function_map::iterator it = type_function_map.find(type);
     if (it == type_function_map.end()) {
         jo.throw_error( "unrecognized JSON object", "type" );
     }
     it->second( jo, src );
+    add_timing( "type", type, start, 1 );
+}
+
+std::chrono::steady_clock::time_point DynamicDataLoader::timing_start() const
+{
+    return timing ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+}
+
+void DynamicDataLoader::add_timing( const std::string &category, const std::string &name,
+                                    const std::chrono::steady_clock::time_point start, const int objects )
+{
+    if( timing ) {
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        timing->add( category, name, elapsed.count(), objects );
+    }
+}
+
+void DynamicDataLoader::record_timing( const std::string &path, const bool tsv )
+{
+    timing.reset( new load_timing() );
+    timing_path = path;
+    timing_tsv = tsv;
+}
+
+void load_timing::add( const std::string &category, const std::string &name, const double seconds,
+                       const int objects )
+{
+    entry &e = entries[std::make_pair( category, name )];
+    e.objects += objects;
+    e.seconds += seconds;
+}
+
+void load_timing::write_tsv( std::ostream &out ) const
+{
+    out << "category\tname\tobjects\tseconds\n";
+    for( const auto &e : entries ) {
+        out << e.first.first << "\t" << e.first.second << "\t" << e.second.objects << "\t" <<
+            e.second.seconds << "\n";
+    }
+}
+
+void load_timing::write_report( std::ostream &out ) const
+{
+    std::map<std::string, std::vector<std::pair<std::string, entry>>> categories;
+    for( const auto &e : entries ) {
+        categories[e.first.first].emplace_back( e.first.second, e.second );
+    }
+    for( auto &c : categories ) {
+        auto &list = c.second;
+        std::sort( list.begin(), list.end(), []( const std::pair<std::string, entry> &a,
+        const std::pair<std::string, entry> &b ) {
+            return a.second.seconds > b.second.seconds;
+        } );
+        double total = 0;
+        for( const auto &e : list ) {
+            total += e.second.seconds;
+        }
+        out << string_format( "%s (%.3f s)\n", c.first.c_str(), total );
+        for( const auto &e : list ) {
+            out << string_format( "  %-40s %8d objects %10.3f s\n", e.first.c_str(), e.second.objects,
+                                  e.second.seconds );
+        }
+        out << "\n";
+    }
 }
 
 void DynamicDataLoader::load_deferred( deferred_json& data )
 {
+    const auto start = timing_start();
+    const int objects = data.size();
     while( !data.empty() ) {
         const size_t n = data.size();
         auto it = data.begin();
         for( size_t idx = 0; idx != n; ++idx ) {
             try {
-                std::istringstream str( it->first );
-                JsonIn jsin( str );
+                JsonIn jsin( it->first.data(), it->first.size() );
                 JsonObject jo = jsin.get_object();
                 load_object( jo, it->second );
             } catch( const std::exception &err ) {
@@ -121,9 +199,10 @@ void DynamicDataLoader::load_deferred( deferred_json& data )
             debugmsg( "JSON contains circular dependency. Discarded %i objects:\n%s",
                       data.size(), discarded.str().c_str() );
             data.clear();
-            return; // made no progress on this cycle so abort
+            break; // made no progress on this cycle so abort
         }
     }
+    add_timing( "stage", "deferred objects", start, objects );
 }
 
 void load_ignored_type(JsonObject &jo)
@@ -267,7 +346,80 @@ void DynamicDataLoader::initialize()
     add( "morale_type", &morale_type_data::load_type );
 }
 
-void DynamicDataLoader::load_data_from_path( const std::string &path, const std::string &src, loading_ui &ui )
+namespace
+{
+
+/** A data file and its objects, see @ref parse_json_file. */
+struct json_file {
+    std::string path;
+    std::string contents;
+    std::unique_ptr<JsonIn> jsin;
+    /** The objects of the file, in order, with their members already indexed. */
+    std::deque<JsonObject> objects;
+    /** Why the file could not be parsed, empty if it could. */
+    std::string error;
+};
+
+/**
+ * Reads the file and indexes its objects, the file may contain a single object
+ * or an array of objects. Only touches `file`, so files can be parsed in parallel.
+ */
+void parse_json_file( json_file &file )
+{
+    std::ifstream infile( file.path.c_str(), std::ifstream::in | std::ifstream::binary );
+    file.contents.assign( std::istreambuf_iterator<char>( infile ), std::istreambuf_iterator<char>() );
+    try {
+        file.jsin.reset( new JsonIn( file.contents.data(), file.contents.size() ) );
+        JsonIn &jsin = *file.jsin;
+        if( jsin.test_object() ) {
+            file.objects.emplace_back( jsin );
+            // if there's anything else in the file, it's an error.
+            jsin.eat_whitespace();
+            if( jsin.good() ) {
+                jsin.error( string_format( "expected single-object file but found '%c'", jsin.peek() ) );
+            }
+        } else if( jsin.test_array() ) {
+            jsin.start_array();
+            while( !jsin.end_array() ) {
+                file.objects.emplace_back( jsin );
+            }
+        } else {
+            // not an object or an array?
+            jsin.error( "expected object or array" );
+        }
+    } catch( const JsonError &err ) {
+        file.error = err.what();
+    }
+}
+
+/** Parses all the files, on as many threads as there are cores. */
+void parse_json_files( std::vector<json_file> &files )
+{
+    std::atomic<size_t> next( 0 );
+    const auto work = [&files, &next]() {
+        for( size_t i = next++; i < files.size(); i = next++ ) {
+            parse_json_file( files[i] );
+        }
+    };
+    std::vector<std::thread> workers;
+    const size_t threads = std::min<size_t>( std::thread::hardware_concurrency(), files.size() );
+    try {
+        while( workers.size() + 1 < threads ) {
+            workers.emplace_back( work );
+        }
+    } catch( const std::system_error &err ) {
+        DebugLog( D_WARNING, D_MAIN ) << "could not start json parsing thread: " << err.what();
+    }
+    // This thread helps too, and does all the work if no threads could be started.
+    work();
+    for( auto &worker : workers ) {
+        worker.join();
+    }
+}
+
+} // namespace
+
+void DynamicDataLoader::load_data_from_path( const std::string &path, const std::string &src, loading_ui & )
 {
     assert( !finalized && "Can't load additional data after finalization. Must be unloaded first." );
     // We assume that each folder is consistent in itself,
@@ -286,52 +438,35 @@ void DynamicDataLoader::load_data_from_path( const std::string &path, const std:
             files.push_back(path);
         }
     }
-    // iterate over each file
-    for( auto &files_i : files ) {
-        const std::string &file = files_i;
-        // open the file as a stream
-        std::ifstream infile(file.c_str(), std::ifstream::in | std::ifstream::binary);
-        // and stuff it into ram
-        std::istringstream iss(
-            std::string(
-                (std::istreambuf_iterator<char>(infile)),
-                std::istreambuf_iterator<char>()
-            )
-        );
-        try {
-            // parse it
-            JsonIn jsin(iss);
-            load_all_from_json( jsin, src, ui );
-        } catch( const JsonError &err ) {
-            throw std::runtime_error( file + ": " + err.what() );
-        }
+    // Read and parse the files on worker threads, they only touch their own files.
+    std::vector<json_file> parsed( files.size() );
+    for( size_t i = 0; i < files.size(); i++ ) {
+        parsed[i].path = files[i];
     }
-}
-
-void DynamicDataLoader::load_all_from_json( JsonIn &jsin, const std::string &src, loading_ui & )
-{
-    if( jsin.test_object() ) {
-        // find type and dispatch single object
-        JsonObject jo = jsin.get_object();
-        load_object( jo, src );
-        jo.finish();
-        // if there's anything else in the file, it's an error.
-        jsin.eat_whitespace();
-        if (jsin.good()) {
-            jsin.error( string_format( "expected single-object file but found '%c'", jsin.peek() ) );
+    const auto start = timing_start();
+    parse_json_files( parsed );
+    add_timing( "stage", "read and parse " + src, start, parsed.size() );
+
+    // Load the objects here, in the same order as before.
+    int objects = 0;
+    for( auto &file : parsed ) {
+        if( !file.error.empty() ) {
+            throw std::runtime_error( file.path + ": " + file.error );
         }
-    } else if( jsin.test_array() ) {
-        jsin.start_array();
-        // find type and dispatch each object until array close
-        while (!jsin.end_array()) {
-            JsonObject jo = jsin.get_object();
-            load_object( jo, src );
-            jo.finish();
+        objects += file.objects.size();
+        try {
+            for( auto &jo : file.objects ) {
+                load_object( jo, src );
+            }
+        } catch( const JsonError &err ) {
+            throw std::runtime_error( file.path + ": " + err.what() );
         }
-    } else {
-        // not an object or an array?
-        jsin.error( "expected object or array" );
+        file.objects.clear();
+        file.jsin.reset();
+        file.contents.clear();
+        file.contents.shrink_to_fit();
     }
+    add_timing( "mod", src, start, objects );
 }
 
 void DynamicDataLoader::unload_data()
@@ -411,41 +546,55 @@ void DynamicDataLoader::finalize_loaded_data( loading_ui &ui )
 
     using named_entry = std::pair<std::string, std::function<void()>>;
     const std::vector<named_entry> entries = {{
-        { _( "Body parts" ), &body_part_struct::finalize_all },
-        { _( "Items" ), []() { item_controller->finalize(); } },
-        { _( "Crafting requirements" ), []() { requirement_data::finalize(); } },
-        { _( "Vehicle parts" ), &vpart_info::finalize },
-        { _( "Traps" ), &trap::finalize },
-        { _( "Terrain" ), &set_ter_ids },
-        { _( "Furniture" ), &set_furn_ids },
-        { _( "Overmap terrain" ), &overmap_terrains::finalize },
-        { _( "Overmap connections" ), &overmap_connections::finalize },
-        { _( "Overmap specials" ), &overmap_specials::finalize },
-        { _( "Vehicle prototypes" ), &vehicle_prototype::finalize },
-        { _( "Mapgen weights" ), &calculate_mapgen_weights },
-        { _( "Monster types" ), []() { MonsterGenerator::generator().finalize_mtypes(); } },
-        { _( "Monster groups" ), &MonsterGroupManager::FinalizeMonsterGroups },
-        { _( "Monster factions" ), &monfactions::finalize },
-        { _( "Crafting recipes" ), &recipe_dictionary::finalize },
-        { _( "Martial arts" ), &finialize_martial_arts },
-        { _( "Constructions" ), &finalize_constructions },
-        { _( "NPC classes" ), &npc_class::finalize_all },
-        { _( "Harvest lists" ), &harvest_list::finalize_all },
-        { _( "Anatomies" ), &anatomy::finalize_all }
+        { translate_marker( "Body parts" ), &body_part_struct::finalize_all },
+        { translate_marker( "Items" ), []() { item_controller->finalize(); } },
+        { translate_marker( "Crafting requirements" ), []() { requirement_data::finalize(); } },
+        { translate_marker( "Vehicle parts" ), &vpart_info::finalize },
+        { translate_marker( "Traps" ), &trap::finalize },
+        { translate_marker( "Terrain" ), &set_ter_ids },
+        { translate_marker( "Furniture" ), &set_furn_ids },
+        { translate_marker( "Overmap terrain" ), &overmap_terrains::finalize },
+        { translate_marker( "Overmap connections" ), &overmap_connections::finalize },
+        { translate_marker( "Overmap specials" ), &overmap_specials::finalize },
+        { translate_marker( "Vehicle prototypes" ), &vehicle_prototype::finalize },
+        { translate_marker( "Mapgen weights" ), &calculate_mapgen_weights },
+        { translate_marker( "Monster types" ), []() { MonsterGenerator::generator().finalize_mtypes(); } },
+        { translate_marker( "Monster groups" ), &MonsterGroupManager::FinalizeMonsterGroups },
+        { translate_marker( "Monster factions" ), &monfactions::finalize },
+        { translate_marker( "Crafting recipes" ), &recipe_dictionary::finalize },
+        { translate_marker( "Martial arts" ), &finialize_martial_arts },
+        { translate_marker( "Constructions" ), &finalize_constructions },
+        { translate_marker( "NPC classes" ), &npc_class::finalize_all },
+        { translate_marker( "Harvest lists" ), &harvest_list::finalize_all },
+        { translate_marker( "Anatomies" ), &anatomy::finalize_all }
     }};
 
     for( const named_entry &e : entries ) {
-        ui.add_entry( e.first );
+        ui.add_entry( _( e.first.c_str() ) );
     }
 
     ui.show();
     for( const named_entry &e : entries ) {
+        const auto start = timing_start();
         e.second();
+        add_timing( "finalize", e.first, start );
         ui.proceed();
     }
 
+    const auto start = timing_start();
     check_consistency( ui );
+    add_timing( "stage", "check consistency", start );
     finalized = true;
+
+    if( timing ) {
+        write_to_file( timing_path, [this]( std::ostream & fout ) {
+            if( timing_tsv ) {
+                timing->write_tsv( fout );
+            } else {
+                timing->write_report( fout );
+            }
+        }, _( "load timing" ) );
+    }
 }
 
 void DynamicDataLoader::check_consistency( loading_ui &ui )
@@ -454,48 +603,50 @@ void DynamicDataLoader::check_consistency( loading_ui &ui )
 
     using named_entry = std::pair<std::string, std::function<void()>>;
     const std::vector<named_entry> entries = {{
-        { _( "Flags" ), &json_flag::check_consistency },
-        { _( "Crafting requirements" ), []() { requirement_data::check_consistency(); } },
-        { _( "Vitamins" ), &vitamin::check_consistency },
-        { _( "Emissions" ), &emit::check_consistency },
-        { _( "Activities" ), &activity_type::check_consistency },
-        { _( "Items" ), []() { item_controller->check_definitions(); } },
-        { _( "Materials" ), &materials::check },
-        { _( "Engine faults" ), &fault::check_consistency },
-        { _( "Vehicle parts" ), &vpart_info::check },
-        { _( "Monster types" ), []() { MonsterGenerator::generator().check_monster_definitions(); } },
-        { _( "Monster groups" ), &MonsterGroupManager::check_group_definitions },
-        { _( "Furniture and terrain" ), &check_furniture_and_terrain },
-        { _( "Constructions" ), &check_constructions },
-        { _( "Professions" ), &profession::check_definitions },
-        { _( "Scenarios" ), &scenario::check_definitions },
-        { _( "Martial arts" ), &check_martialarts },
-        { _( "Mutations" ), &mutation_branch::check_consistency },
-        { _( "Mutation Categories" ), &mutation_category_trait::check_consistency },
-        { _( "Overmap connections" ), &overmap_connections::check_consistency },
-        { _( "Overmap terrain" ), &overmap_terrains::check_consistency },
-        { _( "Overmap locations" ), &overmap_locations::check_consistency },
-        { _( "Overmap specials" ), &overmap_specials::check_consistency },
-        { _( "Ammunition types" ), &ammunition_type::check_consistency },
-        { _( "Traps" ), &trap::check_consistency },
-        { _( "Bionics" ), &check_bionics },
-        { _( "Gates" ), &gates::check },
-        { _( "NPC classes" ), &npc_class::check_consistency },
-        { _( "Mission types" ), &mission_type::check_consistency },
-        { _( "Item actions" ), []() { item_action_generator::generator().check_consistency(); } },
-        { _( "Harvest lists" ), &harvest_list::check_consistency },
-        { _( "NPC templates" ), &npc_template::check_consistency },
-        { _( "Body parts" ), &body_part_struct::check_consistency },
-        { _( "Anatomies" ), &anatomy::check_consistency }
+        { translate_marker( "Flags" ), &json_flag::check_consistency },
+        { translate_marker( "Crafting requirements" ), []() { requirement_data::check_consistency(); } },
+        { translate_marker( "Vitamins" ), &vitamin::check_consistency },
+        { translate_marker( "Emissions" ), &emit::check_consistency },
+        { translate_marker( "Activities" ), &activity_type::check_consistency },
+        { translate_marker( "Items" ), []() { item_controller->check_definitions(); } },
+        { translate_marker( "Materials" ), &materials::check },
+        { translate_marker( "Engine faults" ), &fault::check_consistency },
+        { translate_marker( "Vehicle parts" ), &vpart_info::check },
+        { translate_marker( "Monster types" ), []() { MonsterGenerator::generator().check_monster_definitions(); } },
+        { translate_marker( "Monster groups" ), &MonsterGroupManager::check_group_definitions },
+        { translate_marker( "Furniture and terrain" ), &check_furniture_and_terrain },
+        { translate_marker( "Constructions" ), &check_constructions },
+        { translate_marker( "Professions" ), &profession::check_definitions },
+        { translate_marker( "Scenarios" ), &scenario::check_definitions },
+        { translate_marker( "Martial arts" ), &check_martialarts },
+        { translate_marker( "Mutations" ), &mutation_branch::check_consistency },
+        { translate_marker( "Mutation Categories" ), &mutation_category_trait::check_consistency },
+        { translate_marker( "Overmap connections" ), &overmap_connections::check_consistency },
+        { translate_marker( "Overmap terrain" ), &overmap_terrains::check_consistency },
+        { translate_marker( "Overmap locations" ), &overmap_locations::check_consistency },
+        { translate_marker( "Overmap specials" ), &overmap_specials::check_consistency },
+        { translate_marker( "Ammunition types" ), &ammunition_type::check_consistency },
+        { translate_marker( "Traps" ), &trap::check_consistency },
+        { translate_marker( "Bionics" ), &check_bionics },
+        { translate_marker( "Gates" ), &gates::check },
+        { translate_marker( "NPC classes" ), &npc_class::check_consistency },
+        { translate_marker( "Mission types" ), &mission_type::check_consistency },
+        { translate_marker( "Item actions" ), []() { item_action_generator::generator().check_consistency(); } },
+        { translate_marker( "Harvest lists" ), &harvest_list::check_consistency },
+        { translate_marker( "NPC templates" ), &npc_template::check_consistency },
+        { translate_marker( "Body parts" ), &body_part_struct::check_consistency },
+        { translate_marker( "Anatomies" ), &anatomy::check_consistency }
     }};
 
     for( const named_entry &e : entries ) {
-        ui.add_entry( e.first );
+        ui.add_entry( _( e.first.c_str() ) );
     }
 
     ui.show();
     for( const named_entry &e : entries ) {
+        const auto start = timing_start();
         e.second();
+        add_timing( "check", e.first, start );
         ui.proceed();
     }
 }
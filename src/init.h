@@ -4,14 +4,40 @@
 
 #include "json.h"
 
+#include <chrono>
 #include <string>
 #include <vector>
 #include <list>
+#include <map>
 #include <memory>
+#include <iosfwd>
 #include <functional>
 
 class loading_ui;
 
+/**
+ * Wall time and object counts of loading the data, per JSON type, per mod and per
+ * stage of finalizing and checking. Entries of different categories overlap, e.g.
+ * deferred objects are loaded while the items are finalized.
+ */
+class load_timing
+{
+    public:
+        /** Adds `seconds` and `objects` to the entry `name` of `category`. */
+        void add( const std::string &category, const std::string &name, double seconds, int objects );
+        /** One line per entry: category, name, objects and seconds, separated by tabs. */
+        void write_tsv( std::ostream &out ) const;
+        /** The entries of each category as a table, the slowest first. */
+        void write_report( std::ostream &out ) const;
+
+    private:
+        struct entry {
+            int objects = 0;
+            double seconds = 0;
+        };
+        std::map<std::pair<std::string, std::string>, entry> entries;
+};
+
 /**
  * This class is used to load (and unload) the dynamic
  * (and modable) data from json files.
@@ -64,6 +90,16 @@ class DynamicDataLoader
 
     private:
         bool finalized = false;
+        /** Measurements of loading, null unless enabled with @ref record_timing. */
+        std::unique_ptr<load_timing> timing;
+        /** Where @ref timing is written to after the data has been finalized. */
+        std::string timing_path;
+        bool timing_tsv = false;
+        /** The start of a measurement for @ref add_timing, only read from the clock if enabled. */
+        std::chrono::steady_clock::time_point timing_start() const;
+        /** Adds to @ref timing (if enabled) the time since `start`. */
+        void add_timing( const std::string &category, const std::string &name,
+                         std::chrono::steady_clock::time_point start, int objects = 0 );
 
     protected:
         /**
@@ -73,16 +109,6 @@ class DynamicDataLoader
         t_type_function_map type_function_map;
         void add( const std::string &type, std::function<void( JsonObject & )> f );
         void add( const std::string &type, std::function<void( JsonObject &, const std::string & )> f );
-        /**
-         * Load all the types from that json data.
-         * @param jsin Might contain single object,
-         * or an array of objects. Each object must have a
-         * "type", that is part of the @ref type_function_map
-         * @param src String identifier for mod this data comes from
-         * @param ui Finalization status display.
-         * @throws std::exception on all kind of errors.
-         */
-        void load_all_from_json( JsonIn &jsin, const std::string &src, loading_ui &ui );
         /**
          * Load a single object from a json object.
          * @param jo The json object to load the C++-object from.
@@ -118,6 +144,9 @@ class DynamicDataLoader
          * @param src String identifier for mod this data comes from
          * @param ui Finalization status display.
          * @throws std::exception on all kind of errors.
+         *
+         * The files are read and parsed on worker threads, the objects are then
+         * loaded on this thread in the order of the files.
          */
         /*@{*/
         void load_data_from_path( const std::string &path, const std::string &src, loading_ui &ui );
@@ -153,6 +182,13 @@ class DynamicDataLoader
         bool is_data_finalized() const {
             return finalized;
         }
+
+        /**
+         * Measures loading from now on, see @ref load_timing. Everything measured so far
+         * is written to `path` whenever the data has been finalized.
+         * @param tsv Whether to write TSV instead of a report.
+         */
+        void record_timing( const std::string &path, bool tsv );
 };
 
 #endif
@@ -687,6 +687,21 @@ bool inventory::has_charges(itype_id it, long quantity) const
     return (charges_of(it) >= quantity);
 }
 
+bool inventory::has_tools( const itype_int_id &it, int quantity ) const
+{
+    return has_amount( it, quantity, true );
+}
+
+bool inventory::has_components( const itype_int_id &it, int quantity ) const
+{
+    return has_amount( it, quantity, false );
+}
+
+bool inventory::has_charges( const itype_int_id &it, long quantity ) const
+{
+    return charges_of( it ) >= quantity;
+}
+
 int inventory::leak_level(std::string flag) const
 {
     int ret = 0;
@@ -976,7 +991,7 @@ const itype_bin &inventory::get_binned_items() const
     // Hack warning
     inventory *this_nonconst = const_cast<inventory *>( this );
     this_nonconst->visit_items( [ this ]( item *e ) {
-        binned_items[ e->typeId() ].push_back( e );
+        binned_items[ e->typeIndex() ].push_back( e );
         return VisitResponse::NEXT;
     } );
 
@@ -20,7 +20,7 @@ typedef std::list< std::list<item> > invstack;
 typedef std::vector< std::list<item>* > invslice;
 typedef std::vector< const std::list<item>* > const_invslice;
 typedef std::vector< std::pair<std::list<item>*, int> > indexed_invslice;
-typedef std::unordered_map< itype_id, std::list<const item *> > itype_bin;
+typedef std::unordered_map< itype_int_id, std::list<const item *> > itype_bin;
 
 class salvage_actor;
 
@@ -135,6 +135,9 @@ class inventory : public visitable<inventory>
         bool has_tools( itype_id it, int quantity ) const;
         bool has_components( itype_id it, int quantity ) const;
         bool has_charges( itype_id it, long quantity ) const;
+        bool has_tools( const itype_int_id &it, int quantity ) const;
+        bool has_components( const itype_int_id &it, int quantity ) const;
+        bool has_charges( const itype_int_id &it, long quantity ) const;
 
         int leak_level( std::string flag ) const; // level of leaked bad stuff from items
 
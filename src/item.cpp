@@ -52,6 +52,9 @@
 #include <tuple>
 #include <iterator>
 #include <cassert>
+#include <cstdlib>
+#include <deque>
+#include <unordered_map>
 
 static const std::string GUN_MODE_VAR_NAME( "item::mode" );
 
@@ -102,6 +105,229 @@ std::string const& rad_badge_color(int const rad)
 
 light_emission nolight = {0, 0, 0};
 
+namespace
+{
+/** The names of all item variables by their int keys, see @ref item_var_map. */
+struct item_var_names {
+    std::unordered_map<std::string, int> keys;
+    // A deque, so the names don't move when more are interned.
+    std::deque<std::string> names;
+};
+
+item_var_names &interned_item_vars()
+{
+    // Items with variables may be created during static initialization.
+    static item_var_names instance;
+    return instance;
+}
+
+int intern_item_var( const std::string &name )
+{
+    item_var_names &vars = interned_item_vars();
+    const auto iter = vars.keys.find( name );
+    if( iter != vars.keys.end() ) {
+        return iter->second;
+    }
+    const int key = vars.names.size();
+    vars.names.push_back( name );
+    vars.keys.emplace( name, key );
+    return key;
+}
+
+/** Returns -1 if no item ever had a variable of that name. */
+int find_item_var( const std::string &name )
+{
+    const item_var_names &vars = interned_item_vars();
+    const auto iter = vars.keys.find( name );
+    return iter != vars.keys.end() ? iter->second : -1;
+}
+}
+
+std::string item_var_map::entry::str() const
+{
+    switch( kind ) {
+        case value_kind::integer:
+            return std::to_string( integer );
+        case value_kind::real:
+            return string_format( "%f", real );
+        case value_kind::text:
+            break;
+    }
+    return text;
+}
+
+bool item_var_map::entry::operator==( const entry &rhs ) const
+{
+    if( key != rhs.key ) {
+        return false;
+    } else if( kind == value_kind::integer && rhs.kind == value_kind::integer ) {
+        return integer == rhs.integer;
+    } else if( kind == value_kind::text && rhs.kind == value_kind::text ) {
+        return text == rhs.text;
+    }
+    // Compare as the strings they used to be stored as, e.g. 1 and "1" are the same.
+    return str() == rhs.str();
+}
+
+const item_var_map::entry *item_var_map::find( const std::string &name ) const
+{
+    if( entries.empty() ) {
+        return nullptr;
+    }
+    const int key = find_item_var( name );
+    for( const entry &e : entries ) {
+        if( e.key == key ) {
+            return &e;
+        }
+    }
+    return nullptr;
+}
+
+item_var_map::entry &item_var_map::add( const std::string &name )
+{
+    const int key = intern_item_var( name );
+    for( entry &e : entries ) {
+        if( e.key == key ) {
+            return e;
+        }
+    }
+    entries.emplace_back();
+    entries.back().key = key;
+    return entries.back();
+}
+
+size_t item_var_map::count( const std::string &name ) const
+{
+    return find( name ) != nullptr;
+}
+
+void item_var_map::erase( const std::string &name )
+{
+    const entry *const e = find( name );
+    if( e != nullptr ) {
+        entries.erase( entries.begin() + ( e - entries.data() ) );
+    }
+}
+
+void item_var_map::set( const std::string &name, const std::string &value )
+{
+    entry &e = add( name );
+    e.kind = value_kind::text;
+    e.text = value;
+}
+
+void item_var_map::set( const std::string &name, const long value )
+{
+    entry &e = add( name );
+    e.kind = value_kind::integer;
+    e.integer = value;
+    e.text.clear();
+}
+
+void item_var_map::set( const std::string &name, const double value )
+{
+    entry &e = add( name );
+    e.kind = value_kind::real;
+    e.real = value;
+    e.text.clear();
+}
+
+bool item_var_map::get( const std::string &name, std::string &value ) const
+{
+    const entry *const e = find( name );
+    if( e == nullptr ) {
+        return false;
+    }
+    value = e->str();
+    return true;
+}
+
+bool item_var_map::get( const std::string &name, double &value ) const
+{
+    const entry *const e = find( name );
+    if( e == nullptr ) {
+        return false;
+    }
+    switch( e->kind ) {
+        case value_kind::integer:
+            value = e->integer;
+            break;
+        case value_kind::real:
+            value = e->real;
+            break;
+        case value_kind::text:
+            value = atof( e->text.c_str() );
+            break;
+    }
+    return true;
+}
+
+bool item_var_map::operator==( const item_var_map &rhs ) const
+{
+    if( entries.size() != rhs.entries.size() ) {
+        return false;
+    }
+    // Keys are unique, so every entry must have an equal one in rhs.
+    return std::all_of( entries.begin(), entries.end(), [&rhs]( const entry & e ) {
+        return std::find( rhs.entries.begin(), rhs.entries.end(), e ) != rhs.entries.end();
+    } );
+}
+
+void item_var_map::serialize( JsonOut &jsout ) const
+{
+    // Sorted by name, like the map that was saved here before.
+    std::map<std::string, std::string> sorted;
+    for( const entry &e : entries ) {
+        sorted.emplace( interned_item_vars().names[e.key], e.str() );
+    }
+    jsout.write( sorted );
+}
+
+void item_var_map::deserialize( JsonIn &jsin )
+{
+    clear();
+    jsin.start_object();
+    while( !jsin.end_object() ) {
+        const std::string name = jsin.get_member_name();
+        const std::string value = jsin.get_string();
+        // Numbers are read back as numbers if that gives the very same string when saved again.
+        char *end = nullptr;
+        const long integer = strtol( value.c_str(), &end, 10 );
+        const double real = atof( value.c_str() );
+        if( !value.empty() && *end == '\0' && std::to_string( integer ) == value ) {
+            set( name, integer );
+        } else if( !value.empty() && string_format( "%f", real ) == value ) {
+            set( name, real );
+        } else {
+            set( name, value );
+        }
+    }
+}
+
+bool item_cold_data::is_default() const
+{
+    return item_vars.empty() && corpse == nullptr && corpse_name.empty() && techniques.empty() &&
+           light.luminance == nolight.luminance && light.width == nolight.width &&
+           light.direction == nolight.direction;
+}
+
+const item_cold_data &item::cold() const
+{
+    static const item_cold_data no_cold_data;
+    return cold_ ? *cold_ : no_cold_data;
+}
+
+item_cold_data &item::cold_mut()
+{
+    if( !cold_ ) {
+        cold_ = std::make_shared<item_cold_data>();
+    } else if( cold_.use_count() > 1 ) {
+        // Copies of an item share the data until one of them changes it.
+        cold_ = std::make_shared<item_cold_data>( *cold_ );
+    }
+    return *cold_;
+}
+
 // Returns the default item type, used for the null item (default constructed),
 // the returned pointer is always valid, it's never cleared by the @ref Item_factory.
 static const itype *nullitem()
@@ -120,7 +346,9 @@ item::item()
 item::item( const itype *type, int turn, long qty ) : type( type )
 {
     bday = turn >= 0 ? turn : int( calendar::turn );
-    corpse = typeId() == "corpse" ? &mtype_id::NULL_ID().obj() : nullptr;
+    if( typeId() == "corpse" ) {
+        cold_mut().corpse = &mtype_id::NULL_ID().obj();
+    }
     item_counter = type->countdown_interval;
 
     if( qty >= 0 ) {
@@ -187,16 +415,18 @@ item item::make_corpse( const mtype_id& mt, int turn, const std::string &name )
     }
 
     item result( "corpse", turn >= 0 ? turn : int( calendar::turn ) );
-    result.corpse = &mt.obj();
+    result.cold_mut().corpse = &mt.obj();
 
-    result.active = result.corpse->has_flag( MF_REVIVES );
+    result.active = mt->has_flag( MF_REVIVES );
     if( result.active && one_in( 20 ) ) {
         result.item_tags.insert( "REVIVE_SPECIAL" );
     }
 
     // This is unconditional because the item constructor above sets result.name to
     // "human corpse".
-    result.corpse_name = name;
+    if( !name.empty() ) {
+        result.cold_mut().corpse_name = name;
+    }
 
     return result;
 }
@@ -519,11 +749,15 @@ bool item::stacks_with( const item &rhs ) const
     if( faults != rhs.faults ) {
         return false;
     }
-    if( techniques != rhs.techniques ) {
-        return false;
-    }
-    if( item_vars != rhs.item_vars ) {
-        return false;
+    if( cold_ != rhs.cold_ ) {
+        const item_cold_data &cold_data = cold();
+        const item_cold_data &rhs_cold_data = rhs.cold();
+        if( cold_data.techniques != rhs_cold_data.techniques ) {
+            return false;
+        }
+        if( cold_data.item_vars != rhs_cold_data.item_vars ) {
+            return false;
+        }
     }
     if( goes_bad() ) {
         // If this goes bad, the other item should go bad, too. It only depends on the item type.
@@ -540,11 +774,13 @@ bool item::stacks_with( const item &rhs ) const
             return false;
         }
     }
-    if( ( corpse == nullptr && rhs.corpse != nullptr ) ||
-        ( corpse != nullptr && rhs.corpse == nullptr ) ) {
+    const mtype *const corpse = cold().corpse;
+    const mtype *const rhs_corpse = rhs.cold().corpse;
+    if( ( corpse == nullptr && rhs_corpse != nullptr ) ||
+        ( corpse != nullptr && rhs_corpse == nullptr ) ) {
         return false;
     }
-    if( corpse != nullptr && rhs.corpse != nullptr && corpse->id != rhs.corpse->id ) {
+    if( corpse != nullptr && rhs_corpse != nullptr && corpse->id != rhs_corpse->id ) {
         return false;
     }
     if( contents.size() != rhs.contents.size() ) {
@@ -580,46 +816,36 @@ void item::put_in(item payload)
 
 void item::set_var( const std::string &name, const int value )
 {
-    std::ostringstream tmpstream;
-    tmpstream.imbue( std::locale::classic() );
-    tmpstream << value;
-    item_vars[name] = tmpstream.str();
+    cold_mut().item_vars.set( name, static_cast<long>( value ) );
 }
 
 void item::set_var( const std::string &name, const long value )
 {
-    std::ostringstream tmpstream;
-    tmpstream.imbue( std::locale::classic() );
-    tmpstream << value;
-    item_vars[name] = tmpstream.str();
+    cold_mut().item_vars.set( name, value );
 }
 
 void item::set_var( const std::string &name, const double value )
 {
-    item_vars[name] = string_format( "%f", value );
+    cold_mut().item_vars.set( name, value );
 }
 
 double item::get_var( const std::string &name, const double default_value ) const
 {
-    const auto it = item_vars.find( name );
-    if( it == item_vars.end() ) {
-        return default_value;
-    }
-    return atof( it->second.c_str() );
+    double value = default_value;
+    cold().item_vars.get( name, value );
+    return value;
 }
 
 void item::set_var( const std::string &name, const std::string &value )
 {
-    item_vars[name] = value;
+    cold_mut().item_vars.set( name, value );
 }
 
 std::string item::get_var( const std::string &name, const std::string &default_value ) const
 {
-    const auto it = item_vars.find( name );
-    if( it == item_vars.end() ) {
-        return default_value;
-    }
-    return it->second;
+    std::string value = default_value;
+    cold().item_vars.get( name, value );
+    return value;
 }
 
 std::string item::get_var( const std::string &name ) const
@@ -629,22 +855,26 @@ std::string item::get_var( const std::string &name ) const
 
 bool item::has_var( const std::string &name ) const
 {
-    return item_vars.count( name ) > 0;
+    return cold().item_vars.count( name ) > 0;
 }
 
 void item::erase_var( const std::string &name )
 {
-    item_vars.erase( name );
+    if( has_var( name ) ) {
+        cold_mut().item_vars.erase( name );
+    }
 }
 
 void item::clear_vars()
 {
-    item_vars.clear();
+    if( !cold().item_vars.empty() ) {
+        cold_mut().item_vars.clear();
+    }
 }
 
 const char ivaresc = 001;
 
-bool itag2ivar( std::string &item_tag, std::map<std::string, std::string> &item_vars )
+bool itag2ivar( std::string &item_tag, item_var_map &item_vars )
 {
     size_t pos = item_tag.find('=');
     if(item_tag.at(0) == ivaresc && pos != std::string::npos && pos >= 2 ) {
@@ -675,7 +905,7 @@ bool itag2ivar( std::string &item_tag, std::map<std::string, std::string> &item_
                 val_decoded.append(1, item_tag[s]);
             }
         }
-        item_vars[var_name]=val_decoded;
+        item_vars.set( var_name, val_decoded );
         return true;
     } else {
         return false;
@@ -840,10 +1070,10 @@ std::string item::info( bool showtext, std::vector<iteminfo> &info, int batch )
         }
 
         info.push_back( iteminfo( "FOOD", _( "Portions: " ), "", abs( int( food_item->charges ) * batch ) ) );
-        if( food_item->corpse != NULL && ( debug == true || ( g != NULL &&
+        if( food_item->get_mtype() != NULL && ( debug == true || ( g != NULL &&
                                            ( g->u.has_bionic( bionic_id( "bio_scent_vision" ) ) || g->u.has_trait( trait_id( "CARNIVORE" ) ) ||
                                              g->u.has_artifact_with( AEP_SUPER_CLAIRVOYANCE ) ) ) ) ) {
-            info.push_back( iteminfo( "FOOD", _( "Smells like: " ) + food_item->corpse->nname() ) );
+            info.push_back( iteminfo( "FOOD", _( "Smells like: " ) + food_item->get_mtype()->nname() ) );
         }
 
         const auto vits = g->u.vitamins_from( *food_item );
@@ -1513,19 +1743,16 @@ std::string item::info( bool showtext, std::vector<iteminfo> &info, int batch )
     }
 
     if( showtext && !is_null() ) {
-        const std::map<std::string, std::string>::const_iterator idescription =
-            item_vars.find( "description" );
         insert_separation_line();
         if( !type->snippet_category.empty() ) {
             // Just use the dynamic description
             info.push_back( iteminfo( "DESCRIPTION", SNIPPET.get( note ) ) );
-        } else if( idescription != item_vars.end() ) {
-            info.push_back( iteminfo( "DESCRIPTION", idescription->second ) );
+        } else if( has_var( "description" ) ) {
+            info.push_back( iteminfo( "DESCRIPTION", get_var( "description" ) ) );
         } else {
             info.push_back( iteminfo( "DESCRIPTION", _( type->description.c_str() ) ) );
         }
-        auto all_techniques = type->techniques;
-        all_techniques.insert( techniques.begin(), techniques.end() );
+        const auto all_techniques = get_techniques();
         if( !all_techniques.empty() ) {
             insert_separation_line();
             info.push_back( iteminfo( "DESCRIPTION", _( "Techniques: " ) +
@@ -1620,8 +1847,9 @@ std::string item::info( bool showtext, std::vector<iteminfo> &info, int batch )
 
         // concatenate base and acquired flags...
         std::vector<std::string> flags;
+        const std::set<std::string> own_flags = item_tags.names();
         std::set_union( type->item_tags.begin(), type->item_tags.end(),
-                        item_tags.begin(), item_tags.end(),
+                        own_flags.begin(), own_flags.end(),
                         std::back_inserter( flags ) );
 
         // ...and display those which have an info description
@@ -1790,20 +2018,16 @@ std::string item::info( bool showtext, std::vector<iteminfo> &info, int batch )
             }
         }
 
-        std::map<std::string, std::string>::const_iterator item_note = item_vars.find( "item_note" );
-        std::map<std::string, std::string>::const_iterator item_note_type =
-            item_vars.find( "item_note_type" );
-
-        if( item_note != item_vars.end() ) {
+        if( has_var( "item_note" ) ) {
             insert_separation_line();
             std::string ntext = "";
-            if( item_note_type != item_vars.end() ) {
+            if( has_var( "item_note_type" ) ) {
                 ntext += string_format( _( "%1$s on the %2$s is: " ),
-                                        item_note_type->second.c_str(), tname().c_str() );
+                                        get_var( "item_note_type" ).c_str(), tname().c_str() );
             } else {
                 ntext += _( "Note: " );
             }
-            info.push_back( iteminfo( "DESCRIPTION", ntext + item_note->second ) );
+            info.push_back( iteminfo( "DESCRIPTION", ntext + get_var( "item_note" ) ) );
         }
 
         // describe contents
@@ -2231,7 +2455,7 @@ std::string item::tname( unsigned int quantity, bool with_prefix ) const
     }
 
     std::string maintext;
-    if( is_corpse() || typeId() == "blood" || item_vars.find( "name" ) != item_vars.end() ) {
+    if( is_corpse() || typeId() == "blood" || has_var( "name" ) ) {
         maintext = type_name( quantity );
     } else if( is_gun() || is_tool() || is_magazine() ) {
         ret.str("");
@@ -2340,7 +2564,7 @@ std::string item::tname( unsigned int quantity, bool with_prefix ) const
     ret << string_format( _( "%1$s%2$s%3$s%4$s%5$s%6$s" ), damtext.c_str(), burntext.c_str(),
                           modtext.c_str(), vehtext.c_str(), maintext.c_str(), tagtext.c_str() );
 
-    if( item_vars.find( "item_note" ) != item_vars.end() ) {
+    if( has_var( "item_note" ) ) {
         //~ %s is an item name. This style is used to denote items with notes.
         return string_format( _( "*%s*" ), ret.str().c_str() );
     } else {
@@ -2397,7 +2621,7 @@ nc_color item::color() const
     if( is_null() )
         return c_black;
     if( is_corpse() ) {
-        return corpse->color;
+        return get_mtype()->color;
     }
     return type->color;
 }
@@ -2459,7 +2683,7 @@ units::mass item::weight( bool include_contents ) const
         ret *= charges;
 
     } else if( is_corpse() ) {
-        switch( corpse->size ) {
+        switch( get_mtype()->size ) {
             case MS_TINY:   ret =   1000_gram;  break;
             case MS_SMALL:  ret =  40750_gram;  break;
             case MS_MEDIUM: ret =  81500_gram;  break;
@@ -2469,7 +2693,7 @@ units::mass item::weight( bool include_contents ) const
         if( made_of( material_id( "veggy" ) ) ) {
             ret /= 3;
         }
-        if( corpse->in_species( FISH ) || corpse->in_species( BIRD ) || corpse->in_species( INSECT ) || made_of( material_id( "bone" ) ) ) {
+        if( get_mtype()->in_species( FISH ) || get_mtype()->in_species( BIRD ) || get_mtype()->in_species( INSECT ) || made_of( material_id( "bone" ) ) ) {
             ret /= 8;
         } else if ( made_of( material_id( "iron" ) ) || made_of( material_id( "steel" ) ) || made_of( material_id( "stone" ) ) ) {
             ret *= 7;
@@ -2527,7 +2751,7 @@ units::volume item::base_volume() const
     }
 
     if( is_corpse() ) {
-        return corpse_volume( corpse->size );
+        return corpse_volume( get_mtype()->size );
     }
 
     return type->volume;
@@ -2540,7 +2764,7 @@ units::volume item::volume( bool integral ) const
     }
 
     if( is_corpse() ) {
-        return corpse_volume( corpse->size );
+        return corpse_volume( get_mtype()->size );
     }
 
     const int local_volume = get_var( "volume", -1 );
@@ -2704,9 +2928,14 @@ void item::unset_flags()
 
 bool item::has_flag( const std::string &f ) const
 {
-    bool ret = false;
+    // Flags without an int id are in no flag set.
+    const flag_int_id id = json_flag::find( f );
+    return id.is_valid() && has_flag( id );
+}
 
-    if( json_flag::get( f ).inherit() ) {
+bool item::has_flag( const flag_int_id &f ) const
+{
+    if( !contents.empty() && json_flag::get( f ).inherit() ) {
         for( const auto e : is_gun() ? gunmods() : toolmods() ) {
             // gunmods fired separately do not contribute to base gun flags
             if( !e->is_gun() && e->has_flag( f ) ) {
@@ -2715,15 +2944,8 @@ bool item::has_flag( const std::string &f ) const
         }
     }
 
-    // other item type flags
-    ret = type->item_tags.count(f);
-    if (ret) {
-        return ret;
-    }
-
-    // now check for item specific flags
-    ret = item_tags.count(f);
-    return ret;
+    // other item type flags, then item specific flags
+    return type->item_flags.count( f ) || item_tags.count( f );
 }
 
 bool item::has_any_flag( const std::vector<std::string>& flags ) const
@@ -2790,12 +3012,12 @@ int item::get_quality( const quality_id &id ) const
 
 bool item::has_technique( const matec_id & tech ) const
 {
-    return type->techniques.count( tech ) > 0 || techniques.count( tech ) > 0;
+    return type->techniques.count( tech ) > 0 || cold().techniques.count( tech ) > 0;
 }
 
 void item::add_technique( const matec_id & tech )
 {
-    techniques.insert( tech );
+    cold_mut().techniques.insert( tech );
 }
 
 std::vector<item *> item::toolmods()
@@ -2829,7 +3051,7 @@ std::vector<const item *> item::toolmods() const
 std::set<matec_id> item::get_techniques() const
 {
     std::set<matec_id> result = type->techniques;
-    result.insert( techniques.begin(), techniques.end() );
+    result.insert( cold().techniques.begin(), cold().techniques.end() );
     return result;
 }
 
@@ -3050,7 +3272,7 @@ const std::vector<itype_id> &item::brewing_results() const
 
 bool item::can_revive() const
 {
-    if( is_corpse() && corpse->has_flag( MF_REVIVES ) && damage() < max_damage() ) {
+    if( is_corpse() && get_mtype()->has_flag( MF_REVIVES ) && damage() < max_damage() ) {
         return true;
     }
     return false;
@@ -3413,7 +3635,7 @@ bool item::is_two_handed( const player &u ) const
 const std::vector<material_id> &item::made_of() const
 {
     if( is_corpse() ) {
-        return corpse->mat;
+        return get_mtype()->mat;
     }
     return type->materials;
 }
@@ -3566,12 +3788,12 @@ bool item::is_food_container() const
 
 bool item::is_corpse() const
 {
-    return typeId() == "corpse" && corpse != nullptr;
+    return typeId() == "corpse" && get_mtype() != nullptr;
 }
 
 const mtype *item::get_mtype() const
 {
-    return corpse;
+    return cold().corpse;
 }
 
 void item::set_mtype( const mtype * const m )
@@ -3581,7 +3803,7 @@ void item::set_mtype( const mtype * const m )
         debugmsg( "setting item::corpse of %s to NULL", tname().c_str() );
         return;
     }
-    corpse = m;
+    cold_mut().corpse = m;
 }
 
 bool item::is_ammo_container() const
@@ -3781,7 +4003,7 @@ bool item::is_funnel_container(units::volume &bigger_than) const
 
 bool item::is_emissive() const
 {
-    return light.luminance > 0 || type->light_emission > 0;
+    return cold().light.luminance > 0 || type->light_emission > 0;
 }
 
 bool item::is_tool() const
@@ -4897,7 +5119,7 @@ bool item::burn( fire_data &frd, bool contained)
         const mtype *mt = get_mtype();
         if( active && mt != nullptr && burnt + burn_added > mt->hp &&
             !mt->burn_into.is_null() && mt->burn_into.is_valid() ) {
-            corpse = &get_mtype()->burn_into.obj();
+            cold_mut().corpse = &get_mtype()->burn_into.obj();
             // Delay rezing
             set_age( 0 );
             burnt = 0;
@@ -4969,9 +5191,10 @@ std::ostream & operator<<(std::ostream & out, const item & it)
     return out;
 }
 
-itype_id item::typeId() const
+const itype_id &item::typeId() const
 {
-    return type ? type->get_id() : "null";
+    static const itype_id null_id( "null" );
+    return type ? type->get_id() : null_id;
 }
 
 bool item::getlight(float & luminance, int & width, int & direction ) const
@@ -4979,6 +5202,7 @@ bool item::getlight(float & luminance, int & width, int & direction ) const
     luminance = 0;
     width = 0;
     direction = 0;
+    const light_emission &light = cold().light;
     if ( light.luminance > 0 ) {
         luminance = (float)light.luminance;
         if ( light.width > 0 ) { // width > 0 is a light arc
@@ -5358,26 +5582,27 @@ bool item_compare_by_charges( const item& left, const item& right)
 static const std::string USED_BY_IDS( "USED_BY_IDS" );
 bool item::already_used_by_player(const player &p) const
 {
-    const auto it = item_vars.find( USED_BY_IDS );
-    if( it == item_vars.end() ) {
+    std::string used_by_ids;
+    if( !cold().item_vars.get( USED_BY_IDS, used_by_ids ) ) {
         return false;
     }
     // USED_BY_IDS always starts *and* ends with a ';', the search string
     // ';<id>;' matches at most one part of USED_BY_IDS, and only when exactly that
     // id has been added.
     const std::string needle = string_format( ";%d;", p.getID() );
-    return it->second.find( needle ) != std::string::npos;
+    return used_by_ids.find( needle ) != std::string::npos;
 }
 
 void item::mark_as_used_by_player(const player &p)
 {
-    std::string &used_by_ids = item_vars[ USED_BY_IDS ];
+    std::string used_by_ids = get_var( USED_BY_IDS );
     if( used_by_ids.empty() ) {
         // *always* start with a ';'
         used_by_ids = ";";
     }
     // and always end with a ';'
     used_by_ids += string_format( "%d;", p.getID() );
+    set_var( USED_BY_IDS, used_by_ids );
 }
 
 bool item::can_holster ( const item& obj, bool ignore ) const {
@@ -5468,7 +5693,7 @@ void item::process_artifact( player *carrier, const tripoint & /*pos*/ )
 bool item::process_corpse( player *carrier, const tripoint &pos )
 {
     // some corpses rez over time
-    if( corpse == nullptr ) {
+    if( get_mtype() == nullptr ) {
         return false;
     }
     if( !ready_to_revive( pos ) ) {
@@ -5479,7 +5704,7 @@ bool item::process_corpse( player *carrier, const tripoint &pos )
     if( rng( 0, volume() / units::legacy_volume_factor ) > burnt && g->revive_corpse( pos, *this ) ) {
         if( carrier == nullptr ) {
             if( g->u.sees( pos ) ) {
-                if( corpse->in_species( ROBOT ) ) {
+                if( get_mtype()->in_species( ROBOT ) ) {
                     add_msg( m_warning, _( "A nearby robot has repaired itself and stands up!" ) );
                 } else {
                     add_msg( m_warning, _( "A nearby corpse rises and moves towards you!" ) );
@@ -5490,7 +5715,7 @@ bool item::process_corpse( player *carrier, const tripoint &pos )
             carrier->add_memorial_log( pgettext( "memorial_male", "Had a %s revive while carrying it." ),
                                        pgettext( "memorial_female", "Had a %s revive while carrying it." ),
                                        tname().c_str() );
-            if( corpse->in_species( ROBOT ) ) {
+            if( get_mtype()->in_species( ROBOT ) ) {
                 carrier->add_msg_if_player( m_warning, _( "Oh dear god, a robot you're carrying has started moving!" ) );
             } else {
                 carrier->add_msg_if_player( m_warning, _( "Oh dear god, a corpse you're carrying has started moving!" ) );
@@ -5860,7 +6085,7 @@ bool item::is_dangerous() const
 
 bool item::is_tainted() const
 {
-    return corpse && corpse->has_flag( MF_POISON );
+    return get_mtype() && get_mtype()->has_flag( MF_POISON );
 }
 
 bool item::is_soft() const
@@ -5891,16 +6116,18 @@ bool item::is_reloadable() const
 
 std::string item::type_name( unsigned int quantity ) const
 {
-    const auto iter = item_vars.find( "name" );
+    const item_cold_data &cold_data = cold();
+    const mtype *const corpse = cold_data.corpse;
+    std::string var_name;
     if( corpse != nullptr && typeId() == "corpse" ) {
-        if( corpse_name.empty() ) {
+        if( cold_data.corpse_name.empty() ) {
             return string_format( npgettext( "item name", "%s corpse",
                                          "%s corpses", quantity ),
                                corpse->nname().c_str() );
         } else {
             return string_format( npgettext( "item name", "%s corpse of %s",
                                          "%s corpses of %s", quantity ),
-                               corpse->nname().c_str(), corpse_name.c_str() );
+                               corpse->nname().c_str(), cold_data.corpse_name.c_str() );
         }
     } else if( typeId() == "blood" ) {
         if( corpse == nullptr || corpse->id.is_null() ) {
@@ -5911,8 +6138,8 @@ std::string item::type_name( unsigned int quantity ) const
                                          "%s blood",  quantity ),
                                corpse->nname().c_str() );
         }
-    } else if( iter != item_vars.end() ) {
-        return iter->second;
+    } else if( cold_data.item_vars.get( "name", var_name ) ) {
+        return var_name;
     } else {
         return type->nname( quantity );
     }
@@ -5930,6 +6157,16 @@ bool item::count_by_charges( const itype_id &id )
     return t->count_by_charges();
 }
 
+itype_int_id item::typeIndex() const
+{
+    return type->get_index();
+}
+
+bool item::count_by_charges( const itype_int_id &id )
+{
+    return id->count_by_charges();
+}
+
 bool item::type_is_defined( const itype_id &id )
 {
     return item_controller->has_template( id );
@@ -5940,6 +6177,11 @@ const itype * item::find_type( const itype_id& type )
     return item_controller->find_template( type );
 }
 
+itype_int_id item::find_type_index( const itype_id &id )
+{
+    return item_controller->find_index( id );
+}
+
 int item::get_gun_ups_drain() const
 {
     int draincount = 0;
@@ -6,15 +6,19 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <map>
+#include <memory>
 #include <bitset>
 #include <unordered_set>
 #include <set>
 #include "visitable.h"
 #include "enums.h"
 #include "json.h"
+#include "flag.h"
 #include "color.h"
 #include "bodypart.h"
 #include "string_id.h"
+#include "int_id.h"
 #include "item_location.h"
 #include "ret_val.h"
 #include "damage.h"
@@ -39,6 +43,7 @@ class item_category;
 class ammunition_type;
 using ammotype = string_id<ammunition_type>;
 using itype_id = std::string;
+using itype_int_id = int_id<itype>;
 class ma_technique;
 using matec_id = string_id<ma_technique>;
 class Skill;
@@ -61,6 +66,85 @@ struct light_emission {
 };
 extern light_emission nolight;
 
+/**
+ * The variables of an item (see @ref item::set_var), keyed by their names interned into ints.
+ * Numbers are kept as numbers and only formatted when read as string or saved, the result is
+ * the same string the value was stored as before.
+ * Items rarely have more than a few variables, so they live in a small unsorted vector.
+ */
+class item_var_map
+{
+    public:
+        bool empty() const {
+            return entries.empty();
+        }
+        size_t size() const {
+            return entries.size();
+        }
+        void clear() {
+            entries.clear();
+        }
+
+        size_t count( const std::string &name ) const;
+        void erase( const std::string &name );
+
+        void set( const std::string &name, const std::string &value );
+        void set( const std::string &name, long value );
+        void set( const std::string &name, double value );
+        /** Stores the value as string in @p value, returns false (and leaves it alone) if unset. */
+        bool get( const std::string &name, std::string &value ) const;
+        /** Stores the value as number in @p value, returns false (and leaves it alone) if unset. */
+        bool get( const std::string &name, double &value ) const;
+
+        bool operator==( const item_var_map &rhs ) const;
+        bool operator!=( const item_var_map &rhs ) const {
+            return !operator==( rhs );
+        }
+
+        /** Saved as an object of strings, the same as the map of strings it replaces. */
+        void serialize( JsonOut &jsout ) const;
+        void deserialize( JsonIn &jsin );
+
+    private:
+        enum class value_kind : char {
+            text,
+            integer,
+            real,
+        };
+        struct entry {
+            int key;
+            value_kind kind;
+            union {
+                long integer;
+                double real;
+            };
+            std::string text;
+
+            std::string str() const;
+            bool operator==( const entry &rhs ) const;
+        };
+
+        const entry *find( const std::string &name ) const;
+        entry &add( const std::string &name );
+
+        std::vector<entry> entries;
+};
+
+/**
+ * Item data that most items leave at its default, kept out of the item itself.
+ * Items share it until one of them changes it, see @ref item::cold_mut.
+ */
+struct item_cold_data {
+    item_var_map item_vars;
+    const mtype *corpse = nullptr;
+    std::string corpse_name;       // Name of the late lamented
+    std::set<matec_id> techniques; // item specific techniques
+    light_emission light = nolight;
+
+    /** Whether all members have their default value, so the item needs no cold data. */
+    bool is_default() const;
+};
+
 namespace io {
 struct object_archive_tag;
 }
@@ -1003,7 +1087,9 @@ public:
     std::string components_to_string() const;
 
     /** return the unique identifier of the items underlying type */
-    itype_id typeId() const;
+    const itype_id &typeId() const;
+    /** The int id of the items underlying type, cheaper to compare than @ref typeId */
+    itype_int_id typeIndex() const;
 
  const itype* type;
  std::list<item> contents;
@@ -1136,9 +1222,13 @@ public:
          * item itself (@ref item_tags). The item has the flag if it appears in either set.
          *
          * Gun mods that are attached to guns also contribute their flags to the gun item.
+         *
+         * Checking a flag by its int id (see @ref json_flag::intern) doesn't touch any strings,
+         * use it where flags are checked often.
          */
         /*@{*/
         bool has_flag( const std::string& flag ) const;
+        bool has_flag( const flag_int_id &flag ) const;
         bool has_any_flag( const std::vector<std::string>& flags ) const;
 
         /** Idempotent filter setting an item specific flag. */
@@ -1648,11 +1738,18 @@ public:
          * Returns the item type of the given identifier. Never returns null.
          */
         static const itype *find_type( const itype_id &id );
+        /**
+         * Returns the int id of the given item type, or an invalid one if the type is not
+         * known. Unlike @ref find_type this does not create the type.
+         */
+        static itype_int_id find_type_index( const itype_id &id );
         /**
          * Whether the item is counted by charges, this is a static wrapper
          * around @ref count_by_charges, that does not need an items instance.
          */
         static bool count_by_charges( const itype_id &id );
+        /** @copydoc count_by_charges(const itype_id &) */
+        static bool count_by_charges( const itype_int_id &id );
         /**
          * Check whether the type id refers to a known type.
          * This should be used either before instantiating an item when it's possible
@@ -1682,11 +1779,13 @@ public:
     private:
         double damage_ = 0;
         const itype* curammo = nullptr;
-        std::map<std::string, std::string> item_vars;
-        const mtype* corpse = nullptr;
-        std::string corpse_name;       // Name of the late lamented
-        std::set<matec_id> techniques; // item specific techniques
-        light_emission light = nolight;
+        /** Rarely used data, null while all of it has its default value. */
+        std::shared_ptr<item_cold_data> cold_;
+
+        /** The cold data of this item, or the shared default if it has none. */
+        const item_cold_data &cold() const;
+        /** The cold data of this item for writing, allocated or unshared first if needed. */
+        item_cold_data &cold_mut();
 
 public:
     static const long INFINITE_CHARGES;
@@ -1712,7 +1811,7 @@ public:
     /** What faults (if any) currently apply to this item */
     std::set<fault_id> faults;
 
- std::set<std::string> item_tags; // generic item specific flags
+ flag_set item_tags; // generic item specific flags
     unsigned item_counter = 0; // generic counter to be used with item flags
     int mission_id = -1; // Refers to a mission in game's master list
     int player_id = -1; // Only give a mission to the right player!
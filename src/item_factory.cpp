@@ -162,7 +162,9 @@ void Item_factory::finalize_pre( itype &obj )
     if( obj.volume <= 0 ) {
         obj.volume = units::from_milliliter( 1 );
     }
+    obj.item_flags.clear();
     for( const auto &tag : obj.item_tags ) {
+        obj.item_flags.insert( tag );
         if( tag.size() > 6 && tag.substr( 0, 6 ) == "LIGHT_" ) {
             obj.light_emission = std::max( atoi( tag.substr( 6 ).c_str() ), 0 );
         }
@@ -358,12 +360,58 @@ void Item_factory::finalize() {
         finalize_post( e.second );
     }
 
+    // Ordered by id, so the int ids don't depend on the order of the hash map.
+    std::vector<itype *> sorted;
+    sorted.reserve( m_templates.size() );
+    for( auto &e : m_templates ) {
+        sorted.push_back( &e.second );
+    }
+    std::sort( sorted.begin(), sorted.end(), []( const itype * a, const itype * b ) {
+        return a->id < b->id;
+    } );
+    m_by_index.clear();
+    for( itype *def : sorted ) {
+        assign_index( *def );
+    }
+
     // We may actually have some runtimes here - ones loaded from saved game
     // @todo support for runtimes that repair
     for( auto &e : m_runtimes ) {
         finalize_pre( *e.second );
         finalize_post( *e.second );
+        assign_index( *e.second );
+    }
+}
+
+void Item_factory::assign_index( itype &def ) const
+{
+    def.index = itype_int_id( m_by_index.size() );
+    m_by_index.push_back( &def );
+}
+
+template<>
+const itype &int_id<itype>::obj() const
+{
+    return *item_controller->find_template( *this );
+}
+
+template<>
+bool int_id<itype>::is_valid() const
+{
+    return item_controller->has_template( *this );
+}
+
+itype_int_id Item_factory::find_index( const itype_id &id ) const
+{
+    const auto found = m_templates.find( id );
+    if( found != m_templates.end() ) {
+        return found->second.get_index();
     }
+    const auto rt = m_runtimes.find( id );
+    if( rt != m_runtimes.end() ) {
+        return rt->second->get_index();
+    }
+    return itype_int_id( -1 );
 }
 
 void Item_factory::finalize_item_blacklist()
@@ -471,6 +519,7 @@ void Item_factory::add_item_type( const itype &def ) {
     if( frozen ) {
         finalize_pre( *new_item_ptr );
         finalize_post( *new_item_ptr );
+        assign_index( *new_item_ptr );
     }
 }
 
@@ -1003,6 +1052,7 @@ const itype * Item_factory::find_template( const itype_id& id ) const
     def->description = string_format( "Missing item definition for %s.", id.c_str() );
 
     m_runtimes[ id ].reset( def );
+    assign_index( *def );
     return def;
 }
 
@@ -1885,7 +1935,9 @@ void Item_factory::migrate_item( const itype_id& id, item& obj )
 {
     auto iter = migrations.find( id );
     if( iter != migrations.end() ) {
-        std::copy( iter->second.flags.begin(), iter->second.flags.end(), std::inserter( obj.item_tags, obj.item_tags.begin() ) );
+        for( const auto &flag : iter->second.flags ) {
+            obj.item_tags.insert( flag );
+        }
         obj.charges = iter->second.charges;
 
         for( const auto& c: iter->second.contents ) {
@@ -1958,6 +2010,7 @@ void Item_factory::clear()
 
     m_templates.clear();
     m_runtimes.clear();
+    m_by_index.clear();
 
     item_blacklist.clear();
 
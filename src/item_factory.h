@@ -206,6 +206,23 @@ class Item_factory
          * @param id Item type id (@ref itype::id).
          */
         const itype *find_template( const itype_id &id ) const;
+        /**
+         * Returns the int id of the item type with the given id, or an invalid int id
+         * if there is no such type (unlike @ref find_template, this doesn't create one).
+         */
+        itype_int_id find_index( const itype_id &id ) const;
+        /**
+         * Returns the item type with the given int id, it must be valid.
+         */
+        const itype *find_template( const itype_int_id &id ) const {
+            return m_by_index[id.to_i()];
+        }
+        /**
+         * Whether the int id refers to an item type.
+         */
+        bool has_template( const itype_int_id &id ) const {
+            return id.to_i() >= 0 && static_cast<size_t>( id.to_i() ) < m_by_index.size();
+        }
 
         /**
          * Add a passed in itype to the collection of item types.
@@ -250,6 +267,11 @@ class Item_factory
 
         mutable std::map<itype_id, std::unique_ptr<itype>> m_runtimes;
 
+        /** All finalized types, static and runtime, by their @ref itype::index. */
+        mutable std::vector<const itype *> m_by_index;
+        /** Gives the type the next int id, called when it's finalized. */
+        void assign_index( itype &def ) const;
+
         typedef std::map<Group_tag, Item_spawn_data *> GroupMap;
         GroupMap m_template_groups;
 
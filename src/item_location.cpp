@@ -121,8 +121,13 @@ class item_location::impl::item_on_map : public item_location::impl
         map_cursor cur;
 
     public:
-        item_on_map( const map_cursor &cur, item *which ) : impl( which ), cur( cur ) {}
-        item_on_map( const map_cursor &cur, int idx ) : impl( idx ), cur( cur ) {}
+        // Items are located to be used or changed, so their submap has to be saved again.
+        item_on_map( const map_cursor &cur, item *which ) : impl( which ), cur( cur ) {
+            g->m.mark_items_modified( cur );
+        }
+        item_on_map( const map_cursor &cur, int idx ) : impl( idx ), cur( cur ) {
+            g->m.mark_items_modified( cur );
+        }
 
         bool valid() const override {
             return target() && cur.has_item( *target() );
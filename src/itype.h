@@ -9,11 +9,13 @@
 #include "pldata.h" // add_type
 #include "bodypart.h" // body_part::num_bp
 #include "string_id.h"
+#include "int_id.h"
 #include "explosion.h"
 #include "vitamin.h"
 #include "units.h"
 #include "damage.h"
 #include "translations.h"
+#include "flag.h"
 
 #include <string>
 #include <vector>
@@ -43,6 +45,11 @@ enum art_effect_passive : int;
 class material_type;
 using material_id = string_id<material_type>;
 typedef std::string itype_id;
+/**
+ * Dense integer id of a loaded item type (@ref itype::index). They are assigned when the
+ * types are finalized and are not stable between game starts, only the @ref itype_id is saved.
+ */
+using itype_int_id = int_id<itype>;
 class ammunition_type;
 using ammotype = string_id<ammunition_type>;
 class fault;
@@ -636,6 +643,8 @@ struct itype {
 
 protected:
     std::string id = "null"; /** unique string identifier for this type */
+    /** Assigned by the @ref Item_factory when the type is finalized, used for fast comparisons. */
+    itype_int_id index = itype_int_id( -1 );
 
     // private because is should only be accessed through itype::nname!
     // name and name_plural are not translated automatically
@@ -682,6 +691,8 @@ public:
     std::set<emit_id> emits;
 
     std::set<std::string> item_tags;
+    /** The @ref item_tags as bits, filled when the type is finalized. */
+    flag_set item_flags;
     std::set<matec_id> techniques;
 
     // Minimum stat(s) or skill(s) to use the item
@@ -769,9 +780,13 @@ public:
     std::string nname(unsigned int quantity) const;
 
     // Allow direct access to the type id for the few cases that need it.
-    itype_id get_id() const {
+    const itype_id &get_id() const {
         return id;
     }
+    /** The dense int id of this type, see @ref itype_int_id. */
+    itype_int_id get_index() const {
+        return index;
+    }
 
     bool count_by_charges() const { return stackable; }
 
@@ -1,8 +1,10 @@
 #include "json.h"
 
+#include <algorithm>
 #include <cmath> // pow
 #include <cstdlib> // strtoul
-#include <cstring> // strcmp
+#include <cstdint>
+#include <cstring> // memcpy
 #include <fstream>
 #include <istream>
 #include <locale> // ensure user's locale doesn't interfere with output
@@ -694,38 +696,93 @@ bool JsonArray::has_object(int i)
     return jsin->test_object();
 }
 
+JsonIn::JsonIn( std::istream &s ) : stream( &s )
+{
+    // Positions are stream positions, so read the stream from its start.
+    const std::streamoff pos = std::max<std::streamoff>( s.tellg(), 0 );
+    if( pos > 0 ) {
+        s.seekg( 0 );
+    }
+    buffer.assign( std::istreambuf_iterator<char>( s ), std::istreambuf_iterator<char>() );
+    data = buffer.data();
+    end = data + buffer.size();
+    cur = data + std::min<size_t>( pos, buffer.size() );
+}
+
+JsonIn::JsonIn( const char *const text, const size_t size ) : data( text ), end( text + size ),
+    cur( text )
+{
+}
+
+JsonIn::~JsonIn()
+{
+    if( stream == nullptr ) {
+        return;
+    }
+    // Leave the stream where parsing stopped, as if it had been read directly.
+    stream->clear();
+    stream->seekg( tell() );
+    if( read_past_end ) {
+        stream->peek();
+    }
+}
+
 int JsonIn::tell()
 {
-    return stream->tellg();
+    return cur - data;
 }
 char JsonIn::peek()
 {
-    return (char)stream->peek();
+    if( cur < end ) {
+        return *cur;
+    }
+    read_past_end = true;
+    return char( EOF );
 }
 bool JsonIn::good()
 {
-    return stream->good();
+    return cur < end;
+}
+
+char JsonIn::get_char()
+{
+    if( cur < end ) {
+        return *cur++;
+    }
+    read_past_end = true;
+    return '\0';
+}
+
+std::string JsonIn::get_chars( const size_t count )
+{
+    const size_t available = std::min<size_t>( count, end - cur );
+    if( available < count ) {
+        read_past_end = true;
+    }
+    std::string text( cur, available );
+    cur += available;
+    return text;
 }
 
 void JsonIn::seek(int pos)
 {
-    stream->clear();
-    stream->seekg(pos);
+    cur = data + std::max( 0, std::min<int>( pos, end - data ) );
+    read_past_end = false;
     ate_separator = false;
 }
 
 void JsonIn::eat_whitespace()
 {
-    while (is_whitespace(peek())) {
-        stream->get();
+    while( cur < end && is_whitespace( *cur ) ) {
+        ++cur;
     }
 }
 
 void JsonIn::uneat_whitespace()
 {
-    while (tell() > 0) {
-        stream->seekg(-1, std::istream::cur);
-        if (!is_whitespace(peek())) {
+    while( cur > data ) {
+        --cur;
+        if( !is_whitespace( *cur ) ) {
             break;
         }
     }
@@ -753,7 +810,7 @@ void JsonIn::skip_separator()
         if( ate_separator ) {
             error("duplicate separator");
         }
-        stream->get();
+        ++cur;
         ate_separator = true;
     } else if (ch == ']' || ch == '}' || ch == ':') {
         // okay
@@ -780,9 +837,8 @@ void JsonIn::skip_separator()
 
 void JsonIn::skip_pair_separator()
 {
-    char ch;
     eat_whitespace();
-    stream->get(ch);
+    const char ch = get_char();
     if (ch != ':') {
         std::stringstream err;
         err << "expected pair separator ':', not '" << ch << "'";
@@ -793,24 +849,57 @@ void JsonIn::skip_pair_separator()
     ate_separator = true;
 }
 
+/**
+ * Finds the first character in [p, end) that ends a run of plain string content:
+ * a quote, a backslash or a control character (which includes line breaks).
+ * Looks at eight bytes at once, strings are mostly long runs of plain characters.
+ */
+static const char *find_string_special( const char *p, const char *const end )
+{
+    static const uint64_t ones = 0x0101010101010101ULL;
+    static const uint64_t highs = 0x8080808080808080ULL;
+    while( end - p >= 8 ) {
+        uint64_t v;
+        memcpy( &v, p, sizeof( v ) );
+        // Each of these has the high bit of a byte set if that byte is a
+        // quote, a backslash or below 0x20 (ignoring bytes >= 0x80).
+        const uint64_t quote = v ^ ( ones * '"' );
+        const uint64_t backslash = v ^ ( ones * '\\' );
+        const uint64_t found = ( ( ( quote - ones ) & ~quote ) |
+                                 ( ( backslash - ones ) & ~backslash ) |
+                                 ( ( v - ones * 0x20 ) & ~v ) ) & highs;
+        if( found != 0 ) {
+            break;
+        }
+        p += 8;
+    }
+    while( p < end && *p != '"' && *p != '\\' && static_cast<unsigned char>( *p ) >= 0x20 ) {
+        ++p;
+    }
+    return p;
+}
+
 void JsonIn::skip_string()
 {
-    char ch;
     eat_whitespace();
-    stream->get(ch);
+    const char ch = get_char();
     if (ch != '"') {
         std::stringstream err;
         err << "expecting string but found '" << ch << "'";
         error(err.str(), -1);
     }
-    while (stream->good()) {
-        stream->get(ch);
-        if (ch == '\\') {
-            stream->get(ch);
-            continue;
-        } else if (ch == '"') {
+    while( cur < end ) {
+        cur = find_string_special( cur, end );
+        if( cur == end ) {
+            read_past_end = true;
             break;
-        } else if( ch == '\r' || ch == '\n' ) {
+        }
+        const char special = *cur++;
+        if( special == '\\' ) {
+            get_char();
+        } else if( special == '"' ) {
+            break;
+        } else if( special == '\r' || special == '\n' ) {
             error("string not closed before end of line", -1);
         }
     }
@@ -870,10 +959,9 @@ void JsonIn::skip_array()
 
 void JsonIn::skip_true()
 {
-    char text[5];
     eat_whitespace();
-    stream->get(text, 5);
-    if (strcmp(text, "true") != 0) {
+    const std::string text = get_chars( 4 );
+    if( text != "true" ) {
         std::stringstream err;
         err << "expected \"true\", but found \"" << text << "\"";
         error(err.str(), -4);
@@ -883,10 +971,9 @@ void JsonIn::skip_true()
 
 void JsonIn::skip_false()
 {
-    char text[6];
     eat_whitespace();
-    stream->get(text, 6);
-    if (strcmp(text, "false") != 0) {
+    const std::string text = get_chars( 5 );
+    if( text != "false" ) {
         std::stringstream err;
         err << "expected \"false\", but found \"" << text << "\"";
         error(err.str(), -5);
@@ -896,10 +983,9 @@ void JsonIn::skip_false()
 
 void JsonIn::skip_null()
 {
-    char text[5];
     eat_whitespace();
-    stream->get(text, 5);
-    if (strcmp(text, "null") != 0) {
+    const std::string text = get_chars( 4 );
+    if( text != "null" ) {
         std::stringstream err;
         err << "expected \"null\", but found \"" << text << "\"";
         error(err.str(), -4);
@@ -909,16 +995,15 @@ void JsonIn::skip_null()
 
 void JsonIn::skip_number()
 {
-    char ch;
     eat_whitespace();
     // skip all of (+-0123456789.eE)
-    while (stream->good()) {
-        stream->get(ch);
+    while( cur < end ) {
+        const char ch = *cur;
         if (ch != '+' && ch != '-' && (ch < '0' || ch > '9') &&
             ch != 'e' && ch != 'E' && ch != '.') {
-            stream->unget();
             break;
         }
+        ++cur;
     }
     end_value();
 }
@@ -932,83 +1017,75 @@ std::string JsonIn::get_member_name()
 
 std::string JsonIn::get_string()
 {
-    std::string s = "";
-    char ch;
-    bool backslash = false;
-    char unihex[5] = "0000";
+    std::string s;
     eat_whitespace();
     int startpos = tell();
     // the first character had better be a '"'
-    stream->get(ch);
-    if (ch != '"') {
+    const char first = get_char();
+    if( first != '"' ) {
         std::stringstream err;
-        err << "expecting string but got '" << ch << "'";
+        err << "expecting string but got '" << first << "'";
         error(err.str(), -1);
     }
-    // add chars to the string, one at a time, converting:
+    // add runs of plain characters at once, converting:
     // \", \\, \/, \b, \f, \n, \r, \t and \uxxxx according to JSON spec.
-    while (stream->good()) {
-        stream->get(ch);
-        if (ch == '\\') {
-            if (backslash) {
-                s += '\\';
-                backslash = false;
-            } else {
-                backslash = true;
-                continue;
-            }
-        } else if (backslash) {
-            backslash = false;
-            if (ch == '"') {
-                s += '"';
-            } else if (ch == '/') {
-                s += '/';
-            } else if (ch == 'b') {
-                s += '\b';
-            } else if (ch == 'f') {
-                s += '\f';
-            } else if (ch == 'n') {
-                s += '\n';
-            } else if (ch == 'r') {
-                s += '\r';
-            } else if (ch == 't') {
-                s += '\t';
-            } else if (ch == 'u') {
-                // get the next four characters as hexadecimal
-                stream->get(unihex, 5);
-                // insert the appropriate unicode character in utf8
-                // TODO: verify that unihex is in fact 4 hex digits.
-                char **endptr = 0;
-                uint32_t u = (uint32_t)strtoul(unihex, endptr, 16);
-                try {
-                    s += utf16_to_utf8(u);
-                } catch( const std::exception &err ) {
-                    error( err.what() );
-                }
-            } else {
-                // for anything else, just add the character, i suppose
-                s += ch;
-            }
-        } else if (ch == '"') {
+    while( cur < end ) {
+        const char *const run = cur;
+        cur = find_string_special( cur, end );
+        s.append( run, cur );
+        if( cur == end ) {
+            read_past_end = true;
+            break;
+        }
+        const char ch = *cur++;
+        if( ch == '"' ) {
             // end of the string
             end_value();
             return s;
         } else if( ch == '\r' || ch == '\n' ) {
             error("reached end of line without closing string", -1);
-        } else if( (unsigned char) ch < 0x20 ) {
+        } else if( ch != '\\' ) {
             error("invalid character inside string", -1);
+        } else if( cur == end ) {
+            read_past_end = true;
+            break;
+        }
+        const char escaped = *cur++;
+        if (escaped == '"') {
+            s += '"';
+        } else if (escaped == '\\') {
+            s += '\\';
+        } else if (escaped == '/') {
+            s += '/';
+        } else if (escaped == 'b') {
+            s += '\b';
+        } else if (escaped == 'f') {
+            s += '\f';
+        } else if (escaped == 'n') {
+            s += '\n';
+        } else if (escaped == 'r') {
+            s += '\r';
+        } else if (escaped == 't') {
+            s += '\t';
+        } else if (escaped == 'u') {
+            // get the next four characters as hexadecimal
+            const std::string unihex = get_chars( 4 );
+            // insert the appropriate unicode character in utf8
+            // TODO: verify that unihex is in fact 4 hex digits.
+            uint32_t u = (uint32_t)strtoul(unihex.c_str(), nullptr, 16);
+            try {
+                s += utf16_to_utf8(u);
+            } catch( const std::exception &err ) {
+                error( err.what() );
+            }
         } else {
-            s += ch;
+            // for anything else, just add the character, i suppose
+            s += escaped;
         }
     }
-    // if we get to here, probably hit a premature EOF?
-    if (stream->eof()) {
-        stream->clear();
-        seek(startpos);
-        error("couldn't find end of string, reached EOF.");
-    } else if (stream->fail()) {
-        throw JsonError( "stream failure while reading string." );
-    }
+    // if we get to here, we hit a premature EOF
+    seek(startpos);
+    error("couldn't find end of string, reached EOF.");
     throw JsonError( "something went wrong D:" );
 }
 
@@ -1029,16 +1106,21 @@ long JsonIn::get_long()
 double JsonIn::get_float()
 {
     // this could maybe be prettier?
-    char ch;
     bool neg = false;
     int i = 0;
     int e = 0;
     int mod_e = 0;
     eat_whitespace();
-    stream->get(ch);
+    // Like get_char, but remembers whether it ran out of data.
+    bool at_end = false;
+    const auto next = [this, &at_end]() {
+        at_end = cur == end;
+        return get_char();
+    };
+    char ch = next();
     if (ch == '-') {
         neg = true;
-        stream->get(ch);
+        ch = next();
     } else if (ch != '.' && (ch < '0' || ch > '9')) {
         // not a valid float
         std::stringstream err;
@@ -1047,7 +1129,7 @@ double JsonIn::get_float()
     }
     if( ch == '0' ) {
         // allow a single leading zero in front of a '.' or 'e'/'E'
-        stream->get(ch);
+        ch = next();
         if (ch >= '0' && ch <= '9') {
             error("leading zeros not strictly allowed", -1);
         }
@@ -1055,40 +1137,42 @@ double JsonIn::get_float()
     while (ch >= '0' && ch <= '9') {
         i *= 10;
         i += (ch - '0');
-        stream->get(ch);
+        ch = next();
     }
     if (ch == '.') {
-        stream->get(ch);
+        ch = next();
         while (ch >= '0' && ch <= '9') {
             i *= 10;
             i += (ch - '0');
             mod_e -= 1;
-            stream->get(ch);
+            ch = next();
         }
     }
     if (neg) {
         i *= -1;
     }
     if (ch == 'e' || ch == 'E') {
-        stream->get(ch);
+        ch = next();
         neg = false;
         if (ch == '-') {
             neg = true;
-            stream->get(ch);
+            ch = next();
         } else if (ch == '+') {
-            stream->get(ch);
+            ch = next();
         }
         while (ch >= '0' && ch <= '9') {
             e *= 10;
             e += (ch - '0');
-            stream->get(ch);
+            ch = next();
         }
         if (neg) {
             e *= -1;
         }
     }
     // unget the final non-number character (probably a separator)
-    stream->unget();
+    if( !at_end ) {
+        --cur;
+    }
     end_value();
     // now put it all together!
     return i * std::pow(10.0f, e + mod_e);
@@ -1096,14 +1180,12 @@ double JsonIn::get_float()
 
 bool JsonIn::get_bool()
 {
-    char ch;
-    char text[5];
     std::stringstream err;
     eat_whitespace();
-    stream->get(ch);
+    const char ch = get_char();
     if (ch == 't') {
-        stream->get(text, 4);
-        if (strcmp(text, "rue") == 0) {
+        const std::string text = get_chars( 3 );
+        if( text == "rue" ) {
             end_value();
             return true;
         } else {
@@ -1112,8 +1194,8 @@ bool JsonIn::get_bool()
             error(err.str(), -4);
         }
     } else if (ch == 'f') {
-        stream->get(text, 5);
-        if (strcmp(text, "alse") == 0) {
+        const std::string text = get_chars( 4 );
+        if( text == "alse" ) {
             end_value();
             return false;
         } else {
@@ -1140,7 +1222,7 @@ void JsonIn::start_array()
 {
     eat_whitespace();
     if (peek() == '[') {
-        stream->get();
+        ++cur;
         ate_separator = false;
         return;
     } else {
@@ -1160,7 +1242,7 @@ bool JsonIn::end_array()
             uneat_whitespace();
             error("separator not strictly allowed at end of array");
         }
-        stream->get();
+        ++cur;
         end_value();
         return true;
     } else {
@@ -1173,7 +1255,7 @@ void JsonIn::start_object()
 {
     eat_whitespace();
     if (peek() == '{') {
-        stream->get();
+        ++cur;
         ate_separator = false; // not that we want to
         return;
     } else {
@@ -1193,7 +1275,7 @@ bool JsonIn::end_object()
             uneat_whitespace();
             error("separator not strictly allowed at end of object");
         }
-        stream->get();
+        ++cur;
         end_value();
         return true;
     } else {
@@ -1423,26 +1505,19 @@ bool JsonIn::read(JsonDeserializer &j)
 // WARNING: for occasional use only.
 std::string JsonIn::line_number(int offset_modifier)
 {
-    if (stream->eof()) {
+    if( read_past_end ) {
         return "EOF";
-    } else if (stream->fail()) {
-        return "???";
-    } // else stream is fine
-    int pos = tell();
+    }
     int line = 1;
     int offset = 1;
-    char ch;
-    seek(0);
-    for (int i = 0; i < pos; ++i) {
-        stream->get(ch);
-        if (ch == '\r') {
+    for( const char *p = data; p < cur; ++p ) {
+        if( *p == '\r' ) {
             offset = 1;
             ++line;
-            if (peek() == '\n') {
-                stream->get();
-                ++i;
+            if( p + 1 < cur && p[1] == '\n' ) {
+                ++p;
             }
-        } else if (ch == '\n') {
+        } else if( *p == '\n' ) {
             offset = 1;
             ++line;
         } else {
@@ -1458,53 +1533,49 @@ void JsonIn::error(std::string message, int offset)
 {
     std::ostringstream err;
     err << line_number(offset) << ": " << message;
-    // if we can't get more info from the stream don't try
-    if (!stream->good()) {
+    // if we can't get more info from the data don't try
+    if( read_past_end ) {
         throw JsonError( err.str() );
     }
     // also print surrounding few lines of context, if not too large
     err << "\n\n";
-    stream->seekg(offset, std::istream::cur);
-    size_t pos = tell();
+    seek( tell() + offset );
+    const char *const pos = cur;
     rewind(3, 240);
-    size_t startpos = tell();
-    std::string buffer( pos - startpos, '\0' );
-    stream->read( &buffer[0], pos - startpos );
-    err << buffer;
-    if (!is_whitespace(peek())) {
-        err << peek();
+    err << std::string( cur, pos );
+    if( pos < end && !is_whitespace( *pos ) ) {
+        err << *pos;
     }
     // display a pointer to the position
+    cur = pos;
     rewind(1, 240);
-    startpos = tell();
+    const char *const startpos = cur;
     err << '\n';
     if (pos > startpos) {
         err << std::string(pos - startpos - 1, ' ');
     }
     err << "^\n";
-    seek(pos);
+    cur = pos;
     // if that wasn't the end of the line, continue underneath pointer
-    char ch = stream->get();
+    char ch = get_char();
     if (ch == '\r') {
         if (peek() == '\n') {
-            stream->get();
+            ++cur;
         }
     } else if (ch == '\n') {
         // pass
     } else if (peek() != '\r' && peek() != '\n') {
-        for (size_t i = 0; i < pos - startpos; ++i) {
-            err << ' ';
-        }
+        err << std::string( pos - startpos, ' ' );
     }
     // print the next couple lines as well
     int line_count = 0;
-    for (int i = 0; i < 240; ++i) {
-        stream->get(ch);
+    for( int i = 0; i < 240 && cur < end; ++i ) {
+        ch = *cur++;
         err << ch;
         if (ch == '\r') {
             ++line_count;
             if (peek() == '\n') {
-                err << stream->get();
+                err << *cur++;
             }
         } else if (ch == '\n') {
             ++line_count;
@@ -1523,48 +1594,41 @@ void JsonIn::rewind(int max_lines, int max_chars)
         seek(0);
         return;
     }
-    if (tell() == 0) {
+    if( cur == data ) {
         return;
     }
     int lines_found = 0;
-    stream->seekg(-1, std::istream::cur);
+    --cur;
     for (int i = 0; i < max_chars; ++i) {
-        size_t tellpos = tell();
-        if (peek() == '\n') {
+        const bool at_start = cur == data;
+        if( *cur == '\n' ) {
             ++lines_found;
-            if (tellpos > 0) {
-                stream->seekg(-1, std::istream::cur);
-                // note: does not update tellpos or count a character
-                if (peek() != '\r') {
+            if( !at_start ) {
+                --cur;
+                // note: does not update at_start or count a character
+                if( *cur != '\r' ) {
                     continue;
                 }
             }
-        } else if (peek() == '\r') {
+        } else if( *cur == '\r' ) {
             ++lines_found;
         }
-        if (tellpos == 0) {
+        if( at_start || cur == data ) {
             break;
         } else if (lines_found == max_lines) {
             // don't include the last \n or \r
-            stream->seekg(1, std::istream::cur);
+            ++cur;
             break;
         }
-        stream->seekg(-1, std::istream::cur);
+        --cur;
     }
 }
 
 std::string JsonIn::substr(size_t pos, size_t len)
 {
-    std::string ret;
-    if (len == std::string::npos) {
-        stream->seekg(0, std::istream::end);
-        size_t end = tell();
-        len = end - pos;
-    }
-    ret.resize(len);
-    stream->seekg(pos);
-    stream->read(&ret[0], len);
-    return ret;
+    const size_t size = end - data;
+    pos = std::min( pos, size );
+    return std::string( data + pos, std::min( len, size - pos ) );
 }
 
 JsonOut::JsonOut( std::ostream &s, bool pretty, int depth ) :
@@ -1801,8 +1865,8 @@ void JsonSerializer::serialize(std::ostream &o) const
 
 void JsonDeserializer::deserialize(const std::string &json_string)
 {
-    std::istringstream s(json_string);
-    deserialize(s);
+    JsonIn jin( json_string.data(), json_string.size() );
+    deserialize(jin);
 }
 
 void JsonDeserializer::deserialize(std::istream &i)
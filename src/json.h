@@ -81,8 +81,12 @@ inline E string_to_enum_look_up( const C &container, const std::string &data )
 /* JsonIn
  * ======
  *
- * The JsonIn class provides a wrapper around a std::istream,
- * with methods for reading JSON data directly from the stream.
+ * The JsonIn class provides methods for reading JSON data directly from
+ * a std::istream or from JSON text in memory.
+ *
+ * It always parses from memory: given a stream, it reads the stream into a buffer
+ * first, and moves the stream to the end of the parsed data when it's destroyed.
+ * Memory given to it directly is not copied and must outlive the JsonIn.
  *
  * JsonObject and JsonArray provide higher-level wrappers,
  * and are a little easier to use in most cases,
@@ -161,15 +165,35 @@ inline E string_to_enum_look_up( const C &container, const std::string &data )
 class JsonIn
 {
     private:
-        std::istream *stream;
+        /** The stream this reads from, if any. */
+        std::istream *stream = nullptr;
+        /** The contents of @ref stream. */
+        std::string buffer;
+        /** The JSON text, positions are offsets from `data`. */
+        const char *data = nullptr;
+        const char *end = nullptr;
+        const char *cur = nullptr;
+        /**
+         * Whether reading tried to go beyond the end of the data since the last @ref seek,
+         * like the eof flag of a stream. Being at the end doesn't set it.
+         */
+        bool read_past_end = false;
         bool ate_separator = false;
 
         void skip_separator();
         void skip_pair_separator();
         void end_value();
+        /** Next character, or '\0' (without advancing) at the end of the data. */
+        char get_char();
+        /** The next @p count characters, or less if the data ends before. */
+        std::string get_chars( size_t count );
 
     public:
-        JsonIn( std::istream &s ) : stream( &s ) {}
+        JsonIn( std::istream &s );
+        JsonIn( const char *text, size_t size );
+        JsonIn( const JsonIn & ) = delete;
+        JsonIn &operator=( const JsonIn & ) = delete;
+        ~JsonIn();
 
         bool get_ate_separator()
         {
@@ -183,7 +207,7 @@ class JsonIn
         int tell(); // get current stream position
         void seek(int pos); // seek to specified stream position
         char peek(); // what's the next char gonna be?
-        bool good(); // whether stream is ok
+        bool good(); // whether there is anything left to read
 
         // advance seek head to the next non-whitespace character
         void eat_whitespace();
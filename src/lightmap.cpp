@@ -64,7 +64,7 @@ void map::build_transparency_cache( const int zlev )
     // Traverse the submaps in order
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
-            auto const cur_submap = get_submap_at_grid( smx, smy, zlev );
+            auto const cur_submap = read_only().get_submap_at_grid( smx, smy, zlev );
 
             for( int sx = 0; sx < SEEX; ++sx ) {
                 for( int sy = 0; sy < SEEY; ++sy ) {
@@ -196,7 +196,7 @@ void map::generate_lightmap( const int zlev )
     // Traverse the submaps in order
     for (int smx = 0; smx < my_MAPSIZE; ++smx) {
         for (int smy = 0; smy < my_MAPSIZE; ++smy) {
-            auto const cur_submap = get_submap_at_grid( smx, smy, zlev );
+            auto const cur_submap = read_only().get_submap_at_grid( smx, smy, zlev );
 
             for (int sx = 0; sx < SEEX; ++sx) {
                 for (int sy = 0; sy < SEEY; ++sy) {
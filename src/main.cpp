@@ -16,7 +16,10 @@
 #include "output.h"
 #include "main_menu.h"
 #include "loading_ui.h"
+#include "init.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
 #include <ctime>
 #include <locale>
@@ -63,12 +66,17 @@ int main(int argc, char *argv[])
 {
 #endif
     int seed = time(NULL);
+    bool seed_given = false;
     bool verifyexit = false;
     bool check_mods = false;
     std::string dump;
     dump_mode dmode = dump_mode::TSV;
     std::vector<std::string> opts;
     std::string world; /** if set try to load first save in this world on startup */
+    std::string pregen_world; /** if set pre-generate this world and exit */
+    point pregen_min;
+    point pregen_max;
+    int pregen_radius = 0;
 
     // Set default file paths
 #ifdef PREFIX
@@ -91,15 +99,16 @@ int main(int argc, char *argv[])
         const char *section_default = nullptr;
         const char *section_map_sharing = "Map sharing";
         const char *section_user_directory = "User directories";
-        const std::array<arg_handler, 12> first_pass_arguments = {{
+        const std::array<arg_handler, 14> first_pass_arguments = {{
             {
                 "--seed", "<string of letters and or numbers>",
                 "Sets the random number generator's seed value",
                 section_default,
-                [&seed](int num_args, const char **params) -> int {
+                [&seed, &seed_given](int num_args, const char **params) -> int {
                     if (num_args < 1) return -1;
                     const unsigned char *hash_input = (const unsigned char *) params[0];
                     seed = djb2_hash(hash_input);
+                    seed_given = true;
                     return 1;
                 }
             },
@@ -152,6 +161,48 @@ int main(int argc, char *argv[])
                     return 0;
                 }
             },
+            {
+                "--load-timing", "<file> [mode = report]",
+                "Writes how long each kind of game data took to load (report or TSV)",
+                section_default,
+                []( int n, const char *params[] ) -> int {
+                    if( n < 1 ) {
+                        return -1;
+                    }
+                    if( n >= 2 && !strcmp( params[ 1 ], "TSV" ) ) {
+                        DynamicDataLoader::get_instance().record_timing( params[ 0 ], true );
+                        return 2;
+                    } else if( n >= 2 && !strcmp( params[ 1 ], "report" ) ) {
+                        DynamicDataLoader::get_instance().record_timing( params[ 0 ], false );
+                        return 2;
+                    }
+                    DynamicDataLoader::get_instance().record_timing( params[ 0 ], false );
+                    return 1;
+                }
+            },
+            {
+                "--pregenerate", "<world> <x1> <y1> <x2> <y2> [radius]",
+                "Generates the overmaps from x1,y1 to x2,y2 (overmap coordinates) of the world "
+                    "and the map within radius overmap tiles of the center of that area, then exits. "
+                    "The result only depends on --seed, or on the world name without it",
+                section_default,
+                [&pregen_world,&pregen_min,&pregen_max,&pregen_radius]( int n, const char *params[] ) -> int {
+                    if( n < 5 ) {
+                        return -1;
+                    }
+                    test_mode = true;
+                    pregen_world = params[ 0 ];
+                    pregen_min = point( std::min( atoi( params[ 1 ] ), atoi( params[ 3 ] ) ),
+                                        std::min( atoi( params[ 2 ] ), atoi( params[ 4 ] ) ) );
+                    pregen_max = point( std::max( atoi( params[ 1 ] ), atoi( params[ 3 ] ) ),
+                                        std::max( atoi( params[ 2 ] ), atoi( params[ 4 ] ) ) );
+                    if( n >= 6 && params[ 5 ][ 0 ] != '-' ) {
+                        pregen_radius = atoi( params[ 5 ] );
+                        return 6;
+                    }
+                    return 5;
+                }
+            },
             {
                 "--world", "<name>",
                 "Load world",
@@ -458,6 +509,15 @@ int main(int argc, char *argv[])
             init_colors();
             exit( g->dump_stats( dump, dmode, opts ) ? 0 : 1 );
         }
+        if( !pregen_world.empty() ) {
+            init_colors();
+            // Without --seed, the world name is the seed, so pregenerating the same world
+            // twice gives the same result.
+            const unsigned int pregen_seed = seed_given ? seed :
+                djb2_hash( reinterpret_cast<const unsigned char *>( pregen_world.c_str() ) );
+            exit( g->pregenerate_world( pregen_world, pregen_min, pregen_max, pregen_radius,
+                                        pregen_seed ) ? 0 : 1 );
+        }
         if( check_mods ) {
             init_colors();
             loading_ui ui( false );
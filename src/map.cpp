@@ -67,7 +67,6 @@ extern bool is_valid_in_w_terrain(int,int);
 
 static std::list<item>  nulitems;          // Returned when &i_at() is asked for an OOB value
 static field            nulfield;          // Returned when &field_at() is asked for an OOB value
-static int              null_temperature;  // Because radiation does it too
 static level_cache      nullcache;         // Dummy cache for z-levels outside bounds
 static item             nulitem;           // Returned when item adding functions fail to add an item
 
@@ -83,11 +82,19 @@ std::list<item>::iterator map_stack::erase( std::list<item>::iterator it )
 void map_stack::push_back( const item &newitem )
 {
     myorigin->add_item_or_charges( location, newitem );
+    if( mystack == &nulitems ) {
+        mystack = myorigin->item_list_at( location );
+    }
 }
 
 void map_stack::insert_at( std::list<item>::iterator index,
                            const item &newitem )
 {
+    if( mystack == &nulitems ) {
+        // The placeholder is empty, so index is its end.
+        mystack = myorigin->item_list_at( location );
+        index = mystack->end();
+    }
     myorigin->add_item_at( location, index, newitem );
 }
 
@@ -131,10 +138,10 @@ map::~map()
 
 static submap null_submap;
 
-const maptile map::maptile_at( const tripoint &p ) const
+const_maptile map::maptile_at( const tripoint &p ) const
 {
     if( !inbounds( p ) ) {
-        return maptile( &null_submap, 0, 0 );
+        return const_maptile( &null_submap, 0, 0 );
     }
 
     return maptile_at_internal( p );
@@ -149,12 +156,12 @@ maptile map::maptile_at( const tripoint &p )
     return maptile_at_internal( p );
 }
 
-const maptile map::maptile_at_internal( const tripoint &p ) const
+const_maptile map::maptile_at_internal( const tripoint &p ) const
 {
     int lx, ly;
-    submap *const sm = get_submap_at( p, lx, ly );
+    const submap *const sm = get_submap_at( p, lx, ly );
 
-    return maptile( sm, lx, ly );
+    return const_maptile( sm, lx, ly );
 }
 
 maptile map::maptile_at_internal( const tripoint &p )
@@ -197,6 +204,8 @@ void map::add_vehicle_to_cache( vehicle *veh )
 
     auto &ch = get_cache( veh->smz );
     ch.veh_in_active_range = true;
+    // Off-map vehicles are found through the submaps registered here, see game::do_turn.
+    MAPBUFFER.add_vehicle_submap( tripoint( abs_sub.x + veh->smx, abs_sub.y + veh->smy, veh->smz ) );
     // Get parts
     std::vector<vehicle_part> &parts = veh->parts;
     const tripoint gpos = veh->global_pos3();
@@ -262,7 +271,7 @@ void map::clear_vehicle_list( const int zlev )
     ch.vehicle_list.clear();
 }
 
-void map::update_vehicle_list( submap *const to, const int zlev )
+void map::update_vehicle_list( const submap *const to, const int zlev )
 {
     // Update vehicle data
     auto &ch = get_cache( zlev );
@@ -293,6 +302,7 @@ std::unique_ptr<vehicle> map::detach_vehicle( vehicle *veh )
             ch.vehicle_list.erase(veh);
             reset_vehicle_cache( zlev );
             current_submap->vehicles.erase (current_submap->vehicles.begin() + i);
+            current_submap->mark_modified();
             if( veh->tracking_on ) {
                 overmap_buffer.remove_vehicle( veh );
             }
@@ -1101,7 +1111,7 @@ VehicleList map::get_vehicles( const tripoint &start, const tripoint &end )
     for( int cx = chunk_sx; cx <= chunk_ex; ++cx ) {
         for( int cy = chunk_sy; cy <= chunk_ey; ++cy ) {
             for( int cz = chunk_sz; cz <= chunk_ez; ++cz ) {
-                submap *current_submap = get_submap_at_grid( cx, cy, cz );
+                const submap *current_submap = read_only().get_submap_at_grid( cx, cy, cz );
                 for( auto &elem : current_submap->vehicles ) {
                     // Ensure the veh's z-position is correct
                     elem->smz = cz;
@@ -1368,7 +1378,9 @@ vehicle *map::displace_vehicle( tripoint &p, const tripoint &dp )
         veh->set_submap_moved( int( p2.x / SEEX ), int( p2.y / SEEY ) );
         dst_submap->vehicles.push_back( veh );
         src_submap->vehicles.erase( src_submap->vehicles.begin() + our_i );
+        src_submap->mark_modified();
         dst_submap->is_uniform = false;
+        dst_submap->mark_modified();
     }
 
     p = p2;
@@ -1465,7 +1477,7 @@ furn_id map::furn(const int x, const int y) const
     }
 
     int lx, ly;
-    submap * const current_submap = get_submap_at(x, y, lx, ly);
+    const submap *const current_submap = get_submap_at(x, y, lx, ly);
 
     return current_submap->get_furn(lx, ly);
 }
@@ -1521,7 +1533,7 @@ furn_id map::furn( const tripoint &p ) const
     }
 
     int lx, ly;
-    submap *const current_submap = get_submap_at( p, lx, ly );
+    const submap *const current_submap = get_submap_at( p, lx, ly );
 
     return current_submap->get_furn( lx, ly );
 }
@@ -1613,7 +1625,7 @@ ter_id map::ter(const int x, const int y) const
     }
 
     int lx, ly;
-    submap * const current_submap = get_submap_at(x, y, lx, ly);
+    const submap *const current_submap = get_submap_at(x, y, lx, ly);
     return current_submap->get_ter( lx, ly );
 }
 
@@ -1643,7 +1655,7 @@ ter_id map::ter( const tripoint &p ) const
     }
 
     int lx, ly;
-    submap *const current_submap = get_submap_at( p, lx, ly );
+    const submap *const current_submap = get_submap_at( p, lx, ly );
 
     return current_submap->get_ter( lx, ly );
 }
@@ -1868,7 +1880,7 @@ int map::move_cost_ter_furn(const int x, const int y) const
     }
 
     int lx, ly;
-    submap * const current_submap = get_submap_at(x, y, lx, ly);
+    const submap *const current_submap = get_submap_at(x, y, lx, ly);
 
     const int tercost = current_submap->get_ter( lx, ly ).obj().movecost;
     if ( tercost == 0 ) {
@@ -1920,7 +1932,7 @@ int map::move_cost_ter_furn( const tripoint &p ) const
     }
 
     int lx, ly;
-    submap * const current_submap = get_submap_at( p, lx, ly );
+    const submap *const current_submap = get_submap_at( p, lx, ly );
 
     const int tercost = current_submap->get_ter( lx, ly ).obj().movecost;
     if ( tercost == 0 ) {
@@ -1992,7 +2004,7 @@ bool map::valid_move( const tripoint &from, const tripoint &to,
     const tripoint &up_p = going_up ? to : from;
     const tripoint &down_p = going_up ? from : to;
 
-    const maptile up = maptile_at( up_p );
+    const const_maptile up = maptile_at( up_p );
     const ter_t &up_ter = up.get_ter_t();
 
     if( up_ter.movecost == 0 ) {
@@ -2000,7 +2012,7 @@ bool map::valid_move( const tripoint &from, const tripoint &to,
         return false;
     }
 
-    const maptile down = maptile_at( down_p );
+    const const_maptile down = maptile_at( down_p );
     const ter_t &down_ter = down.get_ter_t();
 
     if( down_ter.movecost == 0 ) {
@@ -2119,7 +2131,7 @@ bool map::has_floor( const tripoint &p ) const
 
 bool map::supports_above( const tripoint &p ) const
 {
-    const maptile tile = maptile_at( p );
+    const const_maptile tile = maptile_at( p );
     const ter_t &ter = tile.get_ter_t();
     if( ter.movecost == 0 ) {
         return true;
@@ -2401,7 +2413,7 @@ bool map::has_flag(const std::string &flag, const int x, const int y) const
 
 bool map::can_put_items_ter_furn(const int x, const int y) const
 {
-    return !has_flag("NOITEM", x, y) && !has_flag("SEALED", x, y);
+    return can_put_items_ter_furn( tripoint( x, y, abs_sub.z ) );
 }
 
 bool map::has_flag_ter(const std::string & flag, const int x, const int y) const
@@ -2416,14 +2428,7 @@ bool map::has_flag_furn(const std::string & flag, const int x, const int y) cons
 
 bool map::has_flag_ter_or_furn(const std::string & flag, const int x, const int y) const
 {
-    if (!INBOUNDS(x, y)) {
-        return false;
-    }
-
-    int lx, ly;
-    submap * const current_submap = get_submap_at(x, y, lx, ly);
-
-    return current_submap->get_ter( lx, ly ).obj().has_flag(flag) || current_submap->get_furn(lx, ly).obj().has_flag(flag);
+    return has_flag_ter_or_furn( json_flag::find( flag ), tripoint( x, y, abs_sub.z ) );
 }
 
 /////
@@ -2449,11 +2454,31 @@ bool map::has_flag_ter_or_furn(const ter_bitflags flag, const int x, const int y
     }
 
     int lx, ly;
-    submap * const current_submap = get_submap_at(x, y, lx, ly);
+    const submap *const current_submap = get_submap_at(x, y, lx, ly);
 
     return current_submap->get_ter( lx, ly ).obj().has_flag(flag) || current_submap->get_furn(lx, ly).obj().has_flag(flag);
 }
 
+bool map::has_flag( const flag_int_id &flag, const int x, const int y ) const
+{
+    return has_flag( flag, tripoint( x, y, abs_sub.z ) );
+}
+
+bool map::has_flag_ter( const flag_int_id &flag, const int x, const int y ) const
+{
+    return has_flag_ter( flag, tripoint( x, y, abs_sub.z ) );
+}
+
+bool map::has_flag_furn( const flag_int_id &flag, const int x, const int y ) const
+{
+    return has_flag_furn( flag, tripoint( x, y, abs_sub.z ) );
+}
+
+bool map::has_flag_ter_or_furn( const flag_int_id &flag, const int x, const int y ) const
+{
+    return has_flag_ter_or_furn( flag, tripoint( x, y, abs_sub.z ) );
+}
+
 // End of 2D flags
 
 bool map::has_flag( const std::string &flag, const tripoint &p ) const
@@ -2474,27 +2499,50 @@ bool map::can_put_items( const tripoint &p ) const
 
 bool map::can_put_items_ter_furn( const tripoint &p ) const
 {
-    return !has_flag( "NOITEM", p ) && !has_flag( "SEALED", p );
+    static const flag_int_id flag_NOITEM = json_flag::intern( "NOITEM" );
+    static const flag_int_id flag_SEALED = json_flag::intern( "SEALED" );
+    return !has_flag( flag_NOITEM, p ) && !has_flag( flag_SEALED, p );
 }
 
 bool map::has_flag_ter( const std::string & flag, const tripoint &p ) const
 {
-    return ter( p ).obj().has_flag( flag );
+    return has_flag_ter( json_flag::find( flag ), p );
 }
 
 bool map::has_flag_furn( const std::string & flag, const tripoint &p ) const
 {
-    return furn( p ).obj().has_flag( flag );
+    return has_flag_furn( json_flag::find( flag ), p );
 }
 
 bool map::has_flag_ter_or_furn( const std::string & flag, const tripoint &p ) const
+{
+    // Resolve the name once, not once for the terrain and once for the furniture.
+    return has_flag_ter_or_furn( json_flag::find( flag ), p );
+}
+
+bool map::has_flag( const flag_int_id &flag, const tripoint &p ) const
+{
+    return has_flag_ter_or_furn( flag, p ); // Does bound checking
+}
+
+bool map::has_flag_ter( const flag_int_id &flag, const tripoint &p ) const
+{
+    return ter( p ).obj().has_flag( flag );
+}
+
+bool map::has_flag_furn( const flag_int_id &flag, const tripoint &p ) const
+{
+    return furn( p ).obj().has_flag( flag );
+}
+
+bool map::has_flag_ter_or_furn( const flag_int_id &flag, const tripoint &p ) const
 {
     if( !inbounds( p ) ) {
         return false;
     }
 
     int lx, ly;
-    submap *const current_submap = get_submap_at( p, lx, ly );
+    const submap *const current_submap = get_submap_at( p, lx, ly );
 
     return current_submap->get_ter( lx, ly ).obj().has_flag( flag ) ||
            current_submap->get_furn( lx, ly ).obj().has_flag( flag );
@@ -2522,7 +2570,7 @@ bool map::has_flag_ter_or_furn( const ter_bitflags flag, const tripoint &p ) con
     }
 
     int lx, ly;
-    submap *const current_submap = get_submap_at( p, lx, ly );
+    const submap *const current_submap = get_submap_at( p, lx, ly );
 
     return current_submap->get_ter( lx, ly ).obj().has_flag( flag ) ||
            current_submap->get_furn( lx, ly ).obj().has_flag( flag );
@@ -2893,11 +2941,10 @@ void map::decay_fields_and_scent( const int amount )
     const auto &outside_cache = get_cache_ref( smz ).outside_cache;
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
-            auto const cur_submap = get_submap_at_grid( smx, smy, smz );
-            int to_proc = cur_submap->field_count;
+            int to_proc = read_only().get_submap_at_grid( smx, smy, smz )->field_count;
             if( to_proc < 1 ) {
                 if( to_proc < 0 ) {
-                    cur_submap->field_count = 0;
+                    get_submap_at_grid( smx, smy, smz )->field_count = 0;
                     dbg( D_ERROR ) << "map::decay_fields_and_scent: submap at "
                                    << abs_sub.x + smx << "," << abs_sub.y + smy << "," << abs_sub.z
                                    << "has " << to_proc << " field_count";
@@ -2906,6 +2953,9 @@ void map::decay_fields_and_scent( const int amount )
                 continue;
             }
 
+            auto const cur_submap = get_submap_at_grid( smx, smy, smz );
+            cur_submap->mark_modified();
+
             for( int sx = 0; sx < SEEX; ++sx ) {
                 if( to_proc < 1 ) {
                     // This submap had some fields, but all got proc'd already
@@ -4089,11 +4139,11 @@ const std::string map::get_signage( const tripoint &p ) const
     }
 
     int lx, ly;
-    submap * const current_submap = get_submap_at( p, lx, ly );
+    const submap *const current_submap = get_submap_at( p, lx, ly );
 
     return current_submap->get_signage(lx, ly);
 }
-void map::set_signage( const tripoint &p, std::string message ) const
+void map::set_signage( const tripoint &p, std::string message )
 {
     if( !inbounds( p ) ) {
         return;
@@ -4104,7 +4154,7 @@ void map::set_signage( const tripoint &p, std::string message ) const
 
     current_submap->set_signage(lx, ly, message);
 }
-void map::delete_signage( const tripoint &p ) const
+void map::delete_signage( const tripoint &p )
 {
     if( !inbounds( p ) ) {
         return;
@@ -4123,7 +4173,7 @@ int map::get_radiation( const tripoint &p ) const
     }
 
     int lx, ly;
-    submap *const current_submap = get_submap_at( p, lx, ly );
+    const submap *const current_submap = get_submap_at( p, lx, ly );
 
     return current_submap->get_radiation( lx, ly );
 }
@@ -4163,11 +4213,10 @@ void map::adjust_radiation( const tripoint &p, const int delta )
     current_submap->set_radiation( lx, ly, current_radiation + delta );
 }
 
-int& map::temperature( const tripoint &p )
+int map::temperature( const tripoint &p ) const
 {
     if( !inbounds( p ) ) {
-        null_temperature = 0;
-        return null_temperature;
+        return 0;
     }
 
     return get_submap_at( p )->temperature;
@@ -4175,10 +4224,17 @@ int& map::temperature( const tripoint &p )
 
 void map::set_temperature( const tripoint &p, int new_temperature )
 {
-    temperature( p ) = new_temperature;
-    temperature( tripoint( p.x + SEEX, p.y, p.z ) ) = new_temperature;
-    temperature( tripoint( p.x, p.y + SEEY, p.z ) ) = new_temperature;
-    temperature( tripoint( p.x + SEEX, p.y + SEEY, p.z ) ) = new_temperature;
+    for( const tripoint &quadrant : { p, tripoint( p.x + SEEX, p.y, p.z ), tripoint( p.x, p.y + SEEY, p.z ),
+                                      tripoint( p.x + SEEX, p.y + SEEY, p.z ) } ) {
+        if( !inbounds( quadrant ) ) {
+            continue;
+        }
+        submap *const current_submap = get_submap_at( quadrant );
+        if( current_submap->temperature != new_temperature ) {
+            current_submap->temperature = new_temperature;
+            current_submap->mark_modified();
+        }
+    }
 }
 
 void map::set_temperature( const int x, const int y, int new_temperature )
@@ -4189,15 +4245,7 @@ void map::set_temperature( const int x, const int y, int new_temperature )
 // Items: 2D
 map_stack map::i_at( const int x, const int y )
 {
-    if( !INBOUNDS(x, y) ) {
-        nulitems.clear();
-        return map_stack{ &nulitems, tripoint( x, y, abs_sub.z ), this };
-    }
-
-    int lx, ly;
-    submap *const current_submap = get_submap_at( x, y, lx, ly );
-
-    return map_stack{ &current_submap->itm[lx][ly], tripoint( x, y, abs_sub.z ), this };
+    return i_at( tripoint( x, y, abs_sub.z ) );
 }
 
 std::list<item>::iterator map::i_rem( const point location, std::list<item>::iterator it )
@@ -4260,8 +4308,24 @@ map_stack map::i_at( const tripoint &p )
 
     int lx, ly;
     submap *const current_submap = get_submap_at( p, lx, ly );
+    if( !current_submap->has_items( lx, ly ) ) {
+        // Don't create an item list for every square that is looked at, the stack
+        // switches to the real list once something is added through it.
+        nulitems.clear();
+        return map_stack{ &nulitems, p, this };
+    }
+
+    return map_stack{ &current_submap->get_items( lx, ly ), p, this };
+}
 
-    return map_stack{ &current_submap->itm[lx][ly], p, this };
+std::list<item> *map::item_list_at( const tripoint &p )
+{
+    if( !inbounds( p ) ) {
+        nulitems.clear();
+        return &nulitems;
+    }
+    int lx, ly;
+    return &get_submap_at( p, lx, ly )->get_items( lx, ly );
 }
 
 std::list<item>::iterator map::i_rem( const tripoint &p, std::list<item>::iterator it )
@@ -4274,8 +4338,9 @@ std::list<item>::iterator map::i_rem( const tripoint &p, std::list<item>::iterat
     }
 
     current_submap->update_lum_rem(*it, lx, ly);
+    current_submap->mark_modified();
 
-    return current_submap->itm[lx][ly].erase( it );
+    return current_submap->get_items( lx, ly ).erase( it );
 }
 
 int map::i_rem(const tripoint &p, const int index)
@@ -4314,15 +4379,20 @@ void map::i_clear(const tripoint &p)
     int lx, ly;
     submap *const current_submap = get_submap_at( p, lx, ly );
 
-    for( auto item_it = current_submap->itm[lx][ly].begin();
-         item_it != current_submap->itm[lx][ly].end(); ++item_it ) {
+    if( !current_submap->has_items( lx, ly ) ) {
+        return;
+    }
+
+    current_submap->mark_modified();
+    auto &items = current_submap->get_items( lx, ly );
+    for( auto item_it = items.begin(); item_it != items.end(); ++item_it ) {
         if( current_submap->active_items.has( item_it, point( lx, ly ) ) ) {
             current_submap->active_items.remove( item_it, point( lx, ly ) );
         }
     }
 
     current_submap->lum[lx][ly] = 0;
-    current_submap->itm[lx][ly].clear();
+    items.clear();
 }
 
 item &map::spawn_an_item(const tripoint &p, item new_item,
@@ -4511,7 +4581,7 @@ item &map::add_item(const tripoint &p, item new_item)
     if( new_item.needs_processing() && new_item.is_food() ) {
         new_item.process( nullptr, p, false );
     }
-    return add_item_at(p, current_submap->itm[lx][ly].end(), new_item);
+    return add_item_at(p, current_submap->get_items( lx, ly ).end(), new_item);
 }
 
 item &map::add_item_at( const tripoint &p,
@@ -4532,9 +4602,10 @@ item &map::add_item_at( const tripoint &p,
     int lx, ly;
     submap * const current_submap = get_submap_at( p, lx, ly );
     current_submap->is_uniform = false;
+    current_submap->mark_modified();
 
     current_submap->update_lum_add(new_item, lx, ly);
-    const auto new_pos = current_submap->itm[lx][ly].insert( index, new_item );
+    const auto new_pos = current_submap->get_items( lx, ly ).insert( index, new_item );
     if( new_item.needs_processing() ) {
         current_submap->active_items.add( new_pos, point(lx, ly) );
     }
@@ -4588,13 +4659,23 @@ void map::make_active( item_location &loc )
     }
     int lx, ly;
     submap *const current_submap = get_submap_at( loc.position(), lx, ly );
-    auto &item_stack = current_submap->itm[lx][ly];
+    current_submap->mark_modified();
+    auto &item_stack = current_submap->get_items( lx, ly );
     auto iter = std::find_if( item_stack.begin(), item_stack.end(),
                               [&target]( const item &i ) { return &i == target; } );
 
     current_submap->active_items.add( iter, point(lx, ly) );
 }
 
+void map::mark_items_modified( const tripoint &p )
+{
+    if( !inbounds( p ) ) {
+        return;
+    }
+    int lx, ly;
+    get_submap_at( p, lx, ly )->mark_modified();
+}
+
 // Check if it's in a fridge and is food, set the fridge
 // date to current time, and also check contents.
 static void apply_in_fridge(item &it)
@@ -4699,13 +4780,13 @@ void map::process_items( bool const active, T processor, std::string const &sign
     for( gz = minz; gz <= maxz; ++gz ) {
         for( gx = 0; gx < my_MAPSIZE; ++gx ) {
             for( gy = 0; gy < my_MAPSIZE; ++gy ) {
-                submap *const current_submap = get_submap_at_grid( gp );
+                const submap *const current_submap = read_only().get_submap_at_grid( gp );
                 // Vehicles first in case they get blown up and drop active items on the map.
                 if( !current_submap->vehicles.empty() ) {
-                    process_items_in_vehicles(current_submap, processor, signal);
+                    process_items_in_vehicles( get_submap_at_grid( gp ), processor, signal );
                 }
                 if( !active || !current_submap->active_items.empty() ) {
-                    process_items_in_submap(current_submap, gp, processor, signal);
+                    process_items_in_submap( get_submap_at_grid( gp ), gp, processor, signal );
                 }
             }
         }
@@ -4721,6 +4802,10 @@ void map::process_items_in_submap( submap *const current_submap,
     // If more are added as a side effect of processing, they are ignored this turn.
     // If they are destroyed before processing, they don't get processed.
     std::list<item_reference> active_items = current_submap->active_items.get();
+    if( !active_items.empty() ) {
+        // Processing changes the items in place (charges, rot, ...).
+        current_submap->mark_modified();
+    }
     auto const grid_offset = point {gridp.x * SEEX, gridp.y * SEEY};
     for( auto &active_item : active_items ) {
         if( !current_submap->active_items.has( active_item ) ) {
@@ -4844,9 +4929,9 @@ bool map::has_items( const tripoint &p ) const
     }
 
     int lx, ly;
-    submap * const current_submap = get_submap_at( p, lx, ly );
+    const submap *const current_submap = get_submap_at( p, lx, ly );
 
-    return !current_submap->itm[lx][ly].empty();
+    return current_submap->has_items( lx, ly );
 }
 
 template <typename Stack>
@@ -5254,7 +5339,7 @@ const trap &map::tr_at( const tripoint &p ) const
     }
 
     int lx, ly;
-    submap * const current_submap = get_submap_at( p, lx, ly );
+    const submap *const current_submap = get_submap_at( p, lx, ly );
 
     if (current_submap->get_ter( lx, ly ).obj().trap != tr_null) {
         return current_submap->get_ter( lx, ly ).obj().trap.obj();
@@ -5373,7 +5458,7 @@ const field &map::field_at( const tripoint &p ) const
     }
 
     int lx, ly;
-    submap *const current_submap = get_submap_at( p, lx, ly );
+    const submap *const current_submap = get_submap_at( p, lx, ly );
 
     return current_submap->fld[lx][ly];
 }
@@ -5390,6 +5475,8 @@ field &map::field_at( const tripoint &p )
 
     int lx, ly;
     submap *const current_submap = get_submap_at( p, lx, ly );
+    // The field may be changed through the reference.
+    current_submap->mark_modified();
 
     return current_submap->fld[lx][ly];
 }
@@ -5458,8 +5545,12 @@ field_entry *map::get_field( const tripoint &p, const field_id t ) {
 
     int lx, ly;
     submap *const current_submap = get_submap_at( p, lx, ly );
-
-    return current_submap->fld[lx][ly].findField( t );
+    field_entry *const result = current_submap->fld[lx][ly].findField( t );
+    if( result != nullptr ) {
+        // The field may be changed through the pointer.
+        current_submap->mark_modified();
+    }
+    return result;
 }
 
 bool map::add_field(const tripoint &p, const field_id t, int density, const int age)
@@ -5481,6 +5572,7 @@ bool map::add_field(const tripoint &p, const field_id t, int density, const int
 
     submap *const current_submap = get_submap_at( p, lx, ly );
     current_submap->is_uniform = false;
+    current_submap->mark_modified();
 
     if( current_submap->fld[lx][ly].addField( t, density, age ) ) {
         //Only adding it to the count if it doesn't exist.
@@ -5520,6 +5612,7 @@ void map::remove_field( const tripoint &p, const field_id field_to_remove )
     if( current_submap->fld[lx][ly].removeField( field_to_remove ) ) {
         // Only adjust the count if the field actually existed.
         current_submap->field_count--;
+        current_submap->mark_modified();
         const auto &fdata = fieldlist[ field_to_remove ];
         for( int i = 0; i < 3; ++i ) {
             if( !fdata.transparent[i] ) {
@@ -5830,20 +5923,20 @@ void map::draw( WINDOW* w, const tripoint &center )
         const int maxxrender = center.x - getmaxx(w) / 2 + getmaxx(w);
         const int maxx = std::min( MAPSIZE * SEEX, maxxrender );
         while( x < maxx ) {
-            submap *cur_submap = get_submap_at( p, lx, ly );
-            submap *sm_below = p.z > -OVERMAP_DEPTH ?
-                get_submap_at( p.x, p.y, p.z - 1, lx, ly ) : cur_submap;
+            const submap *cur_submap = read_only().get_submap_at( p, lx, ly );
+            const submap *sm_below = p.z > -OVERMAP_DEPTH ?
+                read_only().get_submap_at( p.x, p.y, p.z - 1, lx, ly ) : cur_submap;
             while( lx < SEEX && x < maxx )  {
                 const lit_level lighting = visibility_cache[x][y];
                 if( !apply_vision_effects( w, lighting, cache ) ) {
-                    const maptile curr_maptile = maptile( cur_submap, lx, ly );
+                    const const_maptile curr_maptile( cur_submap, lx, ly );
                     const bool just_this_zlevel =
                         draw_maptile( w, g->u, p, curr_maptile,
                                       false, true, center,
                                       lighting == LL_LOW, lighting == LL_BRIGHT, true );
                     if( !just_this_zlevel ) {
                         p.z--;
-                        const maptile tile_below = maptile( sm_below, lx, ly );
+                        const const_maptile tile_below( sm_below, lx, ly );
                         draw_from_above( w, g->u, p, tile_below, false, center,
                                          lighting == LL_LOW, lighting == LL_BRIGHT, false );
                         p.z++;
@@ -5881,12 +5974,12 @@ void map::drawsq( WINDOW* w, player &u, const tripoint &p, const bool invert_arg
         return;
     }
 
-    const maptile tile = maptile_at( p );
+    const const_maptile tile = maptile_at( p );
     const bool done = draw_maptile( w, u, p, tile, invert_arg, show_items_arg,
                                     view_center, low_light, bright_light, inorder );
     if( !done ) {
         tripoint below( p.x, p.y, p.z - 1 );
-        const maptile tile_below = maptile_at( below );
+        const const_maptile tile_below = maptile_at( below );
         draw_from_above( w, u, below, tile_below,
                          invert_arg, view_center,
                          low_light, bright_light, false );
@@ -5899,7 +5992,7 @@ bool map::need_draw_lower_floor( const tripoint &p )
     return !( !zlevels || p.z <= -OVERMAP_DEPTH || !ter( p ).obj().has_flag( TFLAG_NO_FLOOR ) );
 }
 
-bool map::draw_maptile( WINDOW* w, player &u, const tripoint &p, const maptile &curr_maptile,
+bool map::draw_maptile( WINDOW* w, player &u, const tripoint &p, const const_maptile &curr_maptile,
                         bool invert, bool show_items,
                         const tripoint &view_center,
                         const bool low_light, const bool bright_light, const bool inorder ) const
@@ -6067,7 +6160,7 @@ bool map::draw_maptile( WINDOW* w, player &u, const tripoint &p, const maptile &
 }
 
 void map::draw_from_above( WINDOW* w, player &u, const tripoint &p,
-                           const maptile &curr_tile,
+                           const const_maptile &curr_tile,
                            const bool invert,
                            const tripoint &view_center,
                            bool low_light, bool bright_light, bool inorder ) const
@@ -6468,7 +6561,7 @@ void map::shift( const int sx, const int sy )
                         if (gridx + sx < my_MAPSIZE && gridy + sy < my_MAPSIZE) {
                             copy_grid( tripoint( gridx, gridy, gridz ),
                                        tripoint( gridx + sx, gridy + sy, gridz ) );
-                            update_vehicle_list(get_submap_at_grid(gridx, gridy, gridz), gridz);
+                            update_vehicle_list( read_only().get_submap_at_grid( gridx, gridy, gridz ), gridz );
                         } else {
                             loadn( gridx, gridy, gridz, true );
                         }
@@ -6478,7 +6571,7 @@ void map::shift( const int sx, const int sy )
                         if (gridx + sx < my_MAPSIZE && gridy + sy >= 0) {
                             copy_grid( tripoint( gridx, gridy, gridz ),
                                        tripoint( gridx + sx, gridy + sy, gridz ) );
-                            update_vehicle_list(get_submap_at_grid(gridx, gridy, gridz), gridz);
+                            update_vehicle_list( read_only().get_submap_at_grid( gridx, gridy, gridz ), gridz );
                         } else {
                             loadn( gridx, gridy, gridz, true );
                         }
@@ -6492,7 +6585,7 @@ void map::shift( const int sx, const int sy )
                         if (gridx + sx >= 0 && gridy + sy < my_MAPSIZE) {
                             copy_grid( tripoint( gridx, gridy, gridz ),
                                        tripoint( gridx + sx, gridy + sy, gridz ) );
-                            update_vehicle_list(get_submap_at_grid(gridx, gridy, gridz), gridz);
+                            update_vehicle_list( read_only().get_submap_at_grid( gridx, gridy, gridz ), gridz );
                         } else {
                             loadn( gridx, gridy, gridz, true );
                         }
@@ -6502,7 +6595,7 @@ void map::shift( const int sx, const int sy )
                         if (gridx + sx >= 0 && gridy + sy >= 0) {
                             copy_grid( tripoint( gridx, gridy, gridz ),
                                        tripoint( gridx + sx, gridy + sy, gridz ) );
-                            update_vehicle_list(get_submap_at_grid(gridx, gridy, gridz), gridz);
+                            update_vehicle_list( read_only().get_submap_at_grid( gridx, gridy, gridz ), gridz );
                         } else {
                             loadn( gridx, gridy, gridz, true );
                         }
@@ -6625,14 +6718,9 @@ static void generate_uniform( const int x, const int y, const int z, const oter_
         return;
     }
 
-    constexpr size_t block_size = SEEX * SEEY;
     for( int xd = 0; xd <= 1; xd++ ) {
         for( int yd = 0; yd <= 1; yd++ ) {
-            submap *sm = new submap();
-            sm->is_uniform = true;
-            std::uninitialized_fill_n( &sm->ter[0][0], block_size, fill );
-            sm->turn_last_touched = int(calendar::turn);
-            MAPBUFFER.add_submap( x + xd, y + yd, z, sm );
+            MAPBUFFER.add_uniform_submap( tripoint( x + xd, y + yd, z ), fill );
         }
     }
 }
@@ -6656,8 +6744,9 @@ void map::loadn( const int gridx, const int gridy, const int gridz, const bool u
     const int old_abs_z = abs_sub.z; // Ugly, but necessary at the moment
     abs_sub.z = gridz;
 
-    submap *tmpsub = MAPBUFFER.lookup_submap(absx, absy, gridz);
-    if( tmpsub == nullptr ) {
+    const tripoint abs_p( absx, absy, gridz );
+    const submap *loaded = MAPBUFFER.lookup_shared_submap( abs_p );
+    if( loaded == nullptr ) {
         // It doesn't exist; we must generate it!
         dbg( D_INFO | D_WARNING ) << "map::loadn: Missing mapbuffer data. Regenerating.";
 
@@ -6678,8 +6767,8 @@ void map::loadn( const int gridx, const int gridy, const int gridz, const bool u
         }
 
         // This is the same call to MAPBUFFER as above!
-        tmpsub = MAPBUFFER.lookup_submap( absx, absy, gridz );
-        if( tmpsub == nullptr ) {
+        loaded = MAPBUFFER.lookup_shared_submap( abs_p );
+        if( loaded == nullptr ) {
             dbg( D_ERROR ) << "failed to generate a submap at " << absx << absy << abs_sub.z;
             debugmsg( "failed to generate a submap at %d,%d,%d", absx, absy, abs_sub.z );
             return;
@@ -6691,6 +6780,16 @@ void map::loadn( const int gridx, const int gridy, const int gridz, const bool u
     set_outside_cache_dirty( gridz );
     set_floor_cache_dirty( gridz );
     set_pathfinding_cache_dirty( gridz );
+
+    if( MAPBUFFER.is_shared( loaded ) ) {
+        // The shared submap is only stored here, getsubmap copies it before it gets changed.
+        // It has no vehicles and nothing that needs to be actualized.
+        setsubmap( gridn, const_cast<submap *>( loaded ) );
+        abs_sub.z = old_abs_z;
+        return;
+    }
+
+    submap *const tmpsub = MAPBUFFER.lookup_submap( abs_p );
     setsubmap( gridn, tmpsub );
 
     // Destroy bugged no-part vehicles
@@ -6711,6 +6810,7 @@ void map::loadn( const int gridx, const int gridy, const int gridz, const bool u
             dirty_vehicle_list.erase( veh );
             delete( veh );
             iter = veh_vec.erase( iter );
+            tmpsub->mark_modified();
         }
     }
 
@@ -6775,7 +6875,7 @@ void map::remove_rotten_items( Container &items, const tripoint &pnt )
     }
 }
 
-void map::fill_funnels( const tripoint &p, int since_turn )
+void map::fill_funnels( const tripoint &p, int since_turn, const weather_sum &weather )
 {
     const auto &tr = tr_at( p );
     if( !tr.is_funnel() ) {
@@ -6794,7 +6894,7 @@ void map::fill_funnels( const tripoint &p, int since_turn )
         }
     }
     if( biggest_container != items.end() ) {
-        retroactively_fill_from_funnel( *biggest_container, tr, since_turn, calendar::turn, getabs( p ) );
+        retroactively_fill_from_funnel( *biggest_container, tr, since_turn, calendar::turn, weather );
     }
 }
 
@@ -7022,17 +7122,26 @@ void map::actualize( const int gridx, const int gridy, const int gridz )
     const auto time_since_last_actualize = calendar::turn - tmpsub->turn_last_touched;
     const bool do_funnels = ( gridz >= 0 );
 
-    // check spoiled stuff, and fill up funnels while we're at it
+    // check spoiled stuff, only squares with items need it
+    static const flag_int_id flag_DONT_REMOVE_ROTTEN = json_flag::intern( "DONT_REMOVE_ROTTEN" );
+    for( auto &elem : tmpsub->get_item_lists() ) {
+        const tripoint pnt( gridx * SEEX + elem.first.x, gridy * SEEY + elem.first.y, gridz );
+        // plants contain a seed item which must not be removed under any circumstances
+        if( !elem.second.empty() && !furn( pnt ).obj().has_flag( flag_DONT_REMOVE_ROTTEN ) ) {
+            remove_rotten_items( elem.second, pnt );
+        }
+    }
+
+    // The weather since the submap was last touched, it's the same for all its funnels.
+    // Summing it up is by far the most expensive part after a long absence.
+    std::unique_ptr<weather_sum> funnel_weather;
+
+    // fill up funnels while we're at it
+    // Only squares that have something that changes over time are processed.
     for( int x = 0; x < SEEX; x++ ) {
         for( int y = 0; y < SEEY; y++ ) {
             const tripoint pnt( gridx * SEEX + x, gridy * SEEY + y, gridz );
 
-            const auto &furn = this->furn( pnt ).obj();
-            // plants contain a seed item which must not be removed under any circumstances
-            if( !furn.has_flag( "DONT_REMOVE_ROTTEN" ) ) {
-                remove_rotten_items( tmpsub->itm[x][y], pnt );
-            }
-
             const auto trap_here = tmpsub->get_trap( x, y );
             if( trap_here != tr_null ) {
                 traplocs[trap_here].push_back( pnt );
@@ -7042,19 +7151,34 @@ void map::actualize( const int gridx, const int gridy, const int gridz )
                 traplocs[trap_here].push_back( pnt );
             }
 
-            if( do_funnels ) {
-                fill_funnels( pnt, tmpsub->turn_last_touched );
+            const trap &tr = ter.trap != tr_null ? ter.trap.obj() : trap_here.obj();
+            if( do_funnels && tr.is_funnel() && tmpsub->has_items( x, y ) ) {
+                if( !funnel_weather ) {
+                    funnel_weather.reset( new weather_sum( sum_conditions( tmpsub->turn_last_touched,
+                                                           calendar::turn, getabs( pnt ) ) ) );
+                }
+                fill_funnels( pnt, tmpsub->turn_last_touched, *funnel_weather );
             }
 
-            grow_plant( pnt );
+            if( tmpsub->get_furn( x, y ).obj().has_flag( "PLANT" ) ) {
+                grow_plant( pnt );
+            }
 
-            restock_fruits( pnt, time_since_last_actualize );
+            if( tmpsub->get_ter( x, y ).obj().has_flag( TFLAG_HARVESTED ) ) {
+                restock_fruits( pnt, time_since_last_actualize );
+            }
 
-            produce_sap( pnt, time_since_last_actualize );
+            if( tmpsub->get_ter( x, y ) == t_tree_maple_tapped ) {
+                produce_sap( pnt, time_since_last_actualize );
+            }
 
-            rad_scorch( pnt, time_since_last_actualize );
+            if( tmpsub->get_radiation( x, y ) != 0 ) {
+                rad_scorch( pnt, time_since_last_actualize );
+            }
 
-            decay_cosmetic_fields( pnt, time_since_last_actualize );
+            if( tmpsub->fld[x][y].fieldCount() > 0 ) {
+                decay_cosmetic_fields( pnt, time_since_last_actualize );
+            }
         }
     }
 
@@ -7077,7 +7201,9 @@ void map::add_roofs( const int gridx, const int gridy, const int gridz )
         return;
     }
 
-    submap * const sub_here = get_submap_at_grid( gridx, gridy, gridz );
+    // Most submaps are left as they are, so get a writable one only when needed.
+    const submap *sub_here = read_only().get_submap_at_grid( gridx, gridy, gridz );
+    submap *changed_here = nullptr;
     if( sub_here == nullptr ) {
         debugmsg( "Tried to add roofs/floors on null submap on %d,%d,%d",
                   gridx, gridy, gridz );
@@ -7086,7 +7212,8 @@ void map::add_roofs( const int gridx, const int gridy, const int gridz )
 
     bool check_roof = gridz > -OVERMAP_DEPTH;
 
-    submap * const sub_below = check_roof ? get_submap_at_grid( gridx, gridy, gridz - 1 ) : nullptr;
+    const submap *const sub_below = check_roof ?
+                                    read_only().get_submap_at_grid( gridx, gridy, gridz - 1 ) : nullptr;
 
     if( check_roof && sub_below == nullptr ) {
         debugmsg( "Tried to add roofs to sm at %d,%d,%d, but sm below doesn't exist",
@@ -7101,24 +7228,36 @@ void map::add_roofs( const int gridx, const int gridy, const int gridz )
                 continue;
             }
 
-            if( !check_roof ) {
-                // Make sure we don't have open air at lowest z-level
-                sub_here->ter[x][y] = t_rock_floor;
+            // Make sure we don't have open air at lowest z-level
+            ter_id new_ter = t_rock_floor;
+            if( check_roof ) {
+                const ter_t &ter_below = sub_below->ter[x][y].obj();
+                if( !ter_below.roof ) {
+                    continue;
+                }
+                // TODO: Make roof variable a ter_id to speed this up
+                new_ter = ter_below.roof.id();
+            }
+            if( new_ter == ter_here ) {
                 continue;
             }
 
-            const ter_t &ter_below = sub_below->ter[x][y].obj();
-            if( ter_below.roof ) {
-                // TODO: Make roof variable a ter_id to speed this up
-                sub_here->ter[x][y] = ter_below.roof.id();
+            if( changed_here == nullptr ) {
+                changed_here = get_submap_at_grid( gridx, gridy, gridz );
+                sub_here = changed_here;
             }
+            // Not set_ter, that would make the usually uniform open air submap non-uniform
+            // and get it saved. Roofs are added again whenever the submap is loaded.
+            changed_here->ter[x][y] = new_ter;
+            changed_here->mark_modified();
         }
     }
 }
 
 void map::copy_grid( const tripoint &to, const tripoint &from )
 {
-    const auto smap = get_submap_at_grid( from );
+    // Copy the pointer as it is, shared submaps stay shared.
+    submap *const smap = grid[get_nonant( from )];
     setsubmap( get_nonant( to ), smap );
     for( auto &it : smap->vehicles ) {
         it->smx = to.x;
@@ -7149,7 +7288,7 @@ void map::spawn_monsters_submap_group( const tripoint &gp, mongroup &group, bool
     }
 
     // If the submap is uniform, we can skip many checks
-    const submap *current_submap = get_submap_at_grid( gp );
+    const submap *current_submap = read_only().get_submap_at_grid( gp );
     bool ignore_terrain_checks = false;
     bool ignore_inside_checks = gp.z < 0;
     if( current_submap->is_uniform ) {
@@ -7258,7 +7397,7 @@ void map::spawn_monsters_submap( const tripoint &gp, bool ignore_sight )
         spawn_monsters_submap_group( gp, *mgp, ignore_sight );
     }
 
-    submap * const current_submap = get_submap_at_grid( gp );
+    const submap *const current_submap = read_only().get_submap_at_grid( gp );
     for (auto &i : current_submap->spawns) {
         for (int j = 0; j < i.count; j++) {
             int tries = 0;
@@ -7296,7 +7435,11 @@ void map::spawn_monsters_submap( const tripoint &gp, bool ignore_sight )
             }
         }
     }
-    current_submap->spawns.clear();
+    if( !current_submap->spawns.empty() ) {
+        submap *const changed_submap = get_submap_at_grid( gp );
+        changed_submap->spawns.clear();
+        changed_submap->mark_modified();
+    }
     overmap_buffer.spawn_monster( abs_sub.x + gp.x, abs_sub.y + gp.y, gp.z );
 }
 
@@ -7319,14 +7462,19 @@ void map::spawn_monsters(bool ignore_sight)
 
 void map::clear_spawns()
 {
-    for( auto & smap : grid ) {
-        smap->spawns.clear();
+    for( size_t i = 0; i < grid.size(); i++ ) {
+        if( !read_only().getsubmap( i )->spawns.empty() ) {
+            submap *const smap = getsubmap( i );
+            smap->spawns.clear();
+            smap->mark_modified();
+        }
     }
 }
 
 void map::clear_traps()
 {
-    for( auto & smap : grid ) {
+    for( size_t i = 0; i < grid.size(); i++ ) {
+        submap *const smap = getsubmap( i );
         for (int x = 0; x < SEEX; x++) {
             for (int y = 0; y < SEEY; y++) {
                 smap->set_trap(x, y, tr_null);
@@ -7391,7 +7539,7 @@ const std::string &map::graffiti_at( const tripoint &p ) const
         return empty_string;
     }
     int lx, ly;
-    submap *const current_submap = get_submap_at( p, lx, ly );
+    const submap *const current_submap = get_submap_at( p, lx, ly );
     return current_submap->get_graffiti( lx, ly );
 }
 
@@ -7401,7 +7549,7 @@ bool map::has_graffiti_at( const tripoint &p ) const
         return false;
     }
     int lx, ly;
-    submap *const current_submap = get_submap_at( p, lx, ly );
+    const submap *const current_submap = get_submap_at( p, lx, ly );
     return current_submap->has_graffiti( lx, ly );
 }
 
@@ -7472,7 +7620,7 @@ void map::build_outside_cache( const int zlev )
 
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
-            auto const cur_submap = get_submap_at_grid( smx, smy, zlev );
+            auto const cur_submap = read_only().get_submap_at_grid( smx, smy, zlev );
 
             for( int sx = 0; sx < SEEX; ++sx ) {
                 for( int sy = 0; sy < SEEY; ++sy ) {
@@ -7515,7 +7663,7 @@ void map::build_floor_cache( const int zlev )
 
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
-            auto const cur_submap = get_submap_at_grid( smx, smy, zlev );
+            auto const cur_submap = read_only().get_submap_at_grid( smx, smy, zlev );
 
             for( int sx = 0; sx < SEEX; ++sx ) {
                 for( int sy = 0; sy < SEEY; ++sy ) {
@@ -7683,13 +7831,45 @@ tripoint map::get_abs_sub() const
    return abs_sub;
 }
 
-submap *map::getsubmap( const size_t grididx ) const
+const submap *map::getsubmap( const size_t grididx ) const
 {
     if( grididx >= grid.size() ) {
         debugmsg( "Tried to access invalid grid index %d. Grid size: %d", grididx, grid.size() );
         return nullptr;
     }
-    return grid[grididx];
+    const submap *const sm = grid[grididx];
+    if( MAPBUFFER.is_shared( sm ) ) {
+        // Another map may have copied it for writing, that copy is the current one.
+        return MAPBUFFER.lookup_shared_submap( grid_abs_sub( grididx ) );
+    }
+    return sm;
+}
+
+submap *map::getsubmap( const size_t grididx )
+{
+    if( grididx >= grid.size() ) {
+        debugmsg( "Tried to access invalid grid index %d. Grid size: %d", grididx, grid.size() );
+        return nullptr;
+    }
+    submap *&sm = grid[grididx];
+    if( MAPBUFFER.is_shared( sm ) ) {
+        const tripoint abs_p = grid_abs_sub( grididx );
+        submap *const own = MAPBUFFER.lookup_submap( abs_p );
+        if( own == nullptr ) {
+            debugmsg( "Failed to copy the uniform submap at %d,%d,%d", abs_p.x, abs_p.y, abs_p.z );
+            return nullptr;
+        }
+        sm = own;
+    }
+    return sm;
+}
+
+tripoint map::grid_abs_sub( const size_t grididx ) const
+{
+    // Inverse of get_nonant
+    const int gridz = zlevels ? int( grididx % OVERMAP_LAYERS ) - OVERMAP_HEIGHT : abs_sub.z;
+    const int gridxy = zlevels ? int( grididx / OVERMAP_LAYERS ) : int( grididx );
+    return tripoint( abs_sub.x + gridxy % my_MAPSIZE, abs_sub.y + gridxy / my_MAPSIZE, gridz );
 }
 
 void map::setsubmap( const size_t grididx, submap * const smap )
@@ -7704,7 +7884,7 @@ void map::setsubmap( const size_t grididx, submap * const smap )
     grid[grididx] = smap;
 }
 
-submap *map::get_submap_at( const int x, const int y, const int z ) const
+const submap *map::get_submap_at( const int x, const int y, const int z ) const
 {
     if( !inbounds( x, y, z ) ) {
         debugmsg( "Tried to access invalid map position (%d, %d, %d)", x, y, z );
@@ -7713,7 +7893,16 @@ submap *map::get_submap_at( const int x, const int y, const int z ) const
     return get_submap_at_grid( x / SEEX, y / SEEY, z );
 }
 
-submap *map::get_submap_at( const tripoint &p ) const
+submap *map::get_submap_at( const int x, const int y, const int z )
+{
+    if( !inbounds( x, y, z ) ) {
+        debugmsg( "Tried to access invalid map position (%d, %d, %d)", x, y, z );
+        return nullptr;
+    }
+    return get_submap_at_grid( x / SEEX, y / SEEY, z );
+}
+
+const submap *map::get_submap_at( const tripoint &p ) const
 {
     if( !inbounds( p ) ) {
         debugmsg( "Tried to access invalid map position (%d, %d, %d)", p.x, p.y, p.z );
@@ -7722,41 +7911,89 @@ submap *map::get_submap_at( const tripoint &p ) const
     return get_submap_at_grid( p.x / SEEX, p.y / SEEY, p.z );
 }
 
-submap *map::get_submap_at( const int x, const int y ) const
+submap *map::get_submap_at( const tripoint &p )
+{
+    if( !inbounds( p ) ) {
+        debugmsg( "Tried to access invalid map position (%d, %d, %d)", p.x, p.y, p.z );
+        return nullptr;
+    }
+    return get_submap_at_grid( p.x / SEEX, p.y / SEEY, p.z );
+}
+
+const submap *map::get_submap_at( const int x, const int y ) const
+{
+    return get_submap_at( x, y, abs_sub.z );
+}
+
+submap *map::get_submap_at( const int x, const int y )
 {
     return get_submap_at( x, y, abs_sub.z );
 }
 
-submap *map::get_submap_at( const int x, const int y, int &offset_x, int &offset_y ) const
+const submap *map::get_submap_at( const int x, const int y, int &offset_x, int &offset_y ) const
 {
     return get_submap_at( x, y, abs_sub.z, offset_x, offset_y );
 }
 
-submap *map::get_submap_at( const int x, const int y, const int z, int &offset_x, int &offset_y ) const
+submap *map::get_submap_at( const int x, const int y, int &offset_x, int &offset_y )
+{
+    return get_submap_at( x, y, abs_sub.z, offset_x, offset_y );
+}
+
+const submap *map::get_submap_at( const int x, const int y, const int z, int &offset_x, int &offset_y ) const
 {
     offset_x = x % SEEX;
     offset_y = y % SEEY;
     return get_submap_at( x, y, z );
 }
 
-submap *map::get_submap_at( const tripoint &p, int &offset_x, int &offset_y ) const
+submap *map::get_submap_at( const int x, const int y, const int z, int &offset_x, int &offset_y )
+{
+    offset_x = x % SEEX;
+    offset_y = y % SEEY;
+    return get_submap_at( x, y, z );
+}
+
+const submap *map::get_submap_at( const tripoint &p, int &offset_x, int &offset_y ) const
 {
     offset_x = p.x % SEEX;
     offset_y = p.y % SEEY;
     return get_submap_at( p );
 }
 
-submap *map::get_submap_at_grid( const int gridx, const int gridy ) const
+submap *map::get_submap_at( const tripoint &p, int &offset_x, int &offset_y )
+{
+    offset_x = p.x % SEEX;
+    offset_y = p.y % SEEY;
+    return get_submap_at( p );
+}
+
+const submap *map::get_submap_at_grid( const int gridx, const int gridy ) const
+{
+    return getsubmap( get_nonant( gridx, gridy ) );
+}
+
+submap *map::get_submap_at_grid( const int gridx, const int gridy )
 {
     return getsubmap( get_nonant( gridx, gridy ) );
 }
 
-submap *map::get_submap_at_grid( const int gridx, const int gridy, const int gridz ) const
+const submap *map::get_submap_at_grid( const int gridx, const int gridy, const int gridz ) const
 {
     return getsubmap( get_nonant( gridx, gridy, gridz ) );
 }
 
-submap *map::get_submap_at_grid( const tripoint &p ) const
+submap *map::get_submap_at_grid( const int gridx, const int gridy, const int gridz )
+{
+    return getsubmap( get_nonant( gridx, gridy, gridz ) );
+}
+
+const submap *map::get_submap_at_grid( const tripoint &p ) const
+{
+    return getsubmap( get_nonant( p.x, p.y, p.z ) );
+}
+
+submap *map::get_submap_at_grid( const tripoint &p )
 {
     return getsubmap( get_nonant( p.x, p.y, p.z ) );
 }
@@ -7979,7 +8216,7 @@ template<typename Functor>
     for( z = minz; z <= maxz; z++ ) {
         for( smx = min_smx; smx <= max_smx; smx++ ) {
             for( smy = min_smy; smy <= max_smy; smy++ ) {
-                submap const *cur_submap = get_submap_at_grid( smx, smy, z );
+                submap const *cur_submap = read_only().get_submap_at_grid( smx, smy, z );
                 // Bounds on the submap coords
                 const int sm_minx = smx > min_smx ? 0 : minx % SEEX;
                 const int sm_miny = smy > min_smy ? 0 : miny % SEEY;
@@ -8187,7 +8424,7 @@ void map::update_pathfinding_cache( int zlev ) const
 
                     pf_special cur_value = PF_NORMAL;
 
-                    maptile tile( cur_submap, sx, sy );
+                    const const_maptile tile( cur_submap, sx, sy );
 
                     const auto &terrain = tile.get_ter_t();
                     const auto &furniture = tile.get_furn_t();
@@ -35,7 +35,10 @@ class field;
 class field_entry;
 class vehicle;
 struct submap;
-struct maptile;
+template<typename Submap>
+class maptile_impl;
+using maptile = maptile_impl<submap>;
+using const_maptile = maptile_impl<const submap>;
 class basecamp;
 class computer;
 struct itype;
@@ -44,6 +47,7 @@ class map_cursor;
 class Character;
 class item_location;
 struct trap;
+struct weather_sum;
 struct oter_t;
 enum direction : unsigned;
 using itype_id = std::string;
@@ -59,6 +63,8 @@ using ter_str_id = string_id<ter_t>;
 struct furn_t;
 using furn_id = int_id<furn_t>;
 using furn_str_id = string_id<furn_t>;
+class json_flag;
+using flag_int_id = int_id<json_flag>;
 struct mtype;
 using mtype_id = string_id<mtype>;
 struct projectile;
@@ -190,6 +196,7 @@ class map
 {
         friend class editmap;
         friend class visitable<map_cursor>;
+        friend class map_stack;
 
     public:
         // Constructors & Initialization
@@ -320,11 +327,21 @@ class map
         void clear_spawns();
         void clear_traps();
 
-        const maptile maptile_at( const tripoint &p ) const;
+        /**
+         * The non-const version makes a shared uniform submap writable first (see
+         * @ref getsubmap), use the const version (or @ref read_only) to only look at the tile.
+         */
+        const_maptile maptile_at( const tripoint &p ) const;
         maptile maptile_at( const tripoint &p );
+        /**
+         * Const access for callers that only read, so that shared submaps stay shared.
+         */
+        const map &read_only() const {
+            return *this;
+        }
     private:
         // Versions of the above that don't do bounds checks
-        const maptile maptile_at_internal( const tripoint &p ) const;
+        const_maptile maptile_at_internal( const tripoint &p ) const;
         maptile maptile_at_internal( const tripoint &p );
     public:
 
@@ -468,7 +485,7 @@ class map
         void reset_vehicle_cache( int zlev );
         void clear_vehicle_cache( int zlev );
         void clear_vehicle_list( int zlev );
-        void update_vehicle_list( submap *const to, const int zlev );
+        void update_vehicle_list( const submap *const to, const int zlev );
 
         // Removes vehicle from map and returns it in unique_ptr
         std::unique_ptr<vehicle> detach_vehicle( vehicle *veh );
@@ -641,6 +658,11 @@ class map
         bool has_flag_furn( const ter_bitflags flag, const int x, const int y ) const;
         // checks terrain or furniture
         bool has_flag_ter_or_furn( const ter_bitflags flag, const int x, const int y ) const;
+        // same as the string versions, for flags interned once via json_flag::intern
+        bool has_flag( const flag_int_id &flag, const int x, const int y ) const;
+        bool has_flag_ter( const flag_int_id &flag, const int x, const int y ) const;
+        bool has_flag_furn( const flag_int_id &flag, const int x, const int y ) const;
+        bool has_flag_ter_or_furn( const flag_int_id &flag, const int x, const int y ) const;
         // Flags: 3D
         // Words relevant to terrain (sharp, etc)
         std::string features( const tripoint &p );
@@ -665,6 +687,11 @@ class map
         bool has_flag_furn( const ter_bitflags flag, const tripoint &p ) const;
         // checks terrain or furniture
         bool has_flag_ter_or_furn( const ter_bitflags flag, const tripoint &p ) const;
+        // same as the string versions, for flags interned once via json_flag::intern
+        bool has_flag( const flag_int_id &flag, const tripoint &p ) const;
+        bool has_flag_ter( const flag_int_id &flag, const tripoint &p ) const;
+        bool has_flag_furn( const flag_int_id &flag, const tripoint &p ) const;
+        bool has_flag_ter_or_furn( const flag_int_id &flag, const tripoint &p ) const;
 
         // Bashable: 2D
         bool is_bashable( const int x, const int y ) const;
@@ -794,8 +821,8 @@ class map
 
         // Signs
         const std::string get_signage( const tripoint &p ) const;
-        void set_signage( const tripoint &p, std::string message ) const;
-        void delete_signage( const tripoint &p ) const;
+        void set_signage( const tripoint &p, std::string message );
+        void delete_signage( const tripoint &p );
 
         // Radiation
         int get_radiation( const tripoint &p ) const; // Amount of radiation at (x, y);
@@ -811,8 +838,8 @@ class map
         void adjust_radiation( const int x, const int y, const int delta );
 
         // Temperature
-        // Temperature for submap
-        int &temperature( const tripoint &p );
+        // Temperature for submap, 0 outside the map
+        int temperature( const tripoint &p ) const;
         // Set temperature for all four submap quadrants
         void set_temperature( const tripoint &p, const int temperature );
         // 2D overload for mapgen
@@ -845,6 +872,13 @@ class map
         // Items: 3D
         // Accessor that returns a wrapped reference to an item stack for safe modification.
         map_stack i_at( const tripoint &p );
+    private:
+        /**
+         * The item list of the square, created if it has no items. For @ref map_stack,
+         * which refers to an empty placeholder list until items are added through it.
+         */
+        std::list<item> *item_list_at( const tripoint &p );
+    public:
         item water_from( const tripoint &p );
         void i_clear( const tripoint &p );
         // i_rem() methods that return values act like container::erase(),
@@ -890,6 +924,12 @@ class map
          */
         void make_active( item_location &loc );
 
+        /**
+         * Marks the submap at p as changed, so it is saved again. Adding and removing
+         * items does that already, this is for code that changes the items in place.
+         */
+        void mark_items_modified( const tripoint &p );
+
         /**
          * @name Consume items on the map
          *
@@ -1287,8 +1327,9 @@ class map
          * Try to fill funnel based items here. Simulates rain from `since_turn` till now.
          * @param p The location in this map where to fill funnels.
          * @param since_turn First turn of simulated filling.
+         * @param weather The weather from `since_turn` till now, see @ref sum_conditions.
          */
-        void fill_funnels( const tripoint &p, int since_turn );
+        void fill_funnels( const tripoint &p, int since_turn, const weather_sum &weather );
         /**
          * Try to grow a harvestable plant to the next stage(s).
          */
@@ -1362,33 +1403,51 @@ class map
 
         /**
          * Get the submap pointer with given index in @ref grid, the index must be valid!
+         * Uniform submaps may be shared between many positions (see
+         * @ref mapbuffer::add_uniform_submap), the const versions of this and the other
+         * submap getters return them as they are, unless another map gave the position
+         * its own copy in the mean time. The non-const versions give the submap its
+         * own copy first, so use them only when the submap is going to be changed.
          */
-        submap *getsubmap( size_t grididx ) const;
+        const submap *getsubmap( size_t grididx ) const;
+        submap *getsubmap( size_t grididx );
+        /** Absolute submap position of the submap at the given index in @ref grid. */
+        tripoint grid_abs_sub( size_t grididx ) const;
         /**
          * Get the submap pointer containing the specified position within the reality bubble.
          * (x,y) must be a valid coordinate, check with @ref inbounds.
          */
-        submap *get_submap_at( int x, int y ) const;
-        submap *get_submap_at( int x, int y, int z ) const;
-        submap *get_submap_at( const tripoint &p ) const;
+        const submap *get_submap_at( int x, int y ) const;
+        const submap *get_submap_at( int x, int y, int z ) const;
+        const submap *get_submap_at( const tripoint &p ) const;
+        submap *get_submap_at( int x, int y );
+        submap *get_submap_at( int x, int y, int z );
+        submap *get_submap_at( const tripoint &p );
         /**
          * Get the submap pointer containing the specified position within the reality bubble.
          * The same as other get_submap_at, (x,y,z) must be valid (@ref inbounds).
          * Also writes the position within the submap to offset_x, offset_y
          * offset_z would always be 0, so it is not used here
          */
-        submap *get_submap_at( const int x, const int y, int &offset_x, int &offset_y ) const;
+        const submap *get_submap_at( const int x, const int y, int &offset_x, int &offset_y ) const;
+        const submap *get_submap_at( const int x, const int y, const int z,
+                                     int &offset_x, int &offset_y ) const;
+        const submap *get_submap_at( const tripoint &p, int &offset_x, int &offset_y ) const;
+        submap *get_submap_at( const int x, const int y, int &offset_x, int &offset_y );
         submap *get_submap_at( const int x, const int y, const int z,
-                               int &offset_x, int &offset_y ) const;
-        submap *get_submap_at( const tripoint &p, int &offset_x, int &offset_y ) const;
+                               int &offset_x, int &offset_y );
+        submap *get_submap_at( const tripoint &p, int &offset_x, int &offset_y );
         /**
          * Get submap pointer in the grid at given grid coordinates. Grid coordinates must
          * be valid: 0 <= x < my_MAPSIZE, same for y.
          * z must be between -OVERMAP_DEPTH and OVERMAP_HEIGHT
          */
-        submap *get_submap_at_grid( int gridx, int gridy ) const;
-        submap *get_submap_at_grid( int gridx, int gridy, int gridz ) const;
-        submap *get_submap_at_grid( const tripoint &gridp ) const;
+        const submap *get_submap_at_grid( int gridx, int gridy ) const;
+        const submap *get_submap_at_grid( int gridx, int gridy, int gridz ) const;
+        const submap *get_submap_at_grid( const tripoint &gridp ) const;
+        submap *get_submap_at_grid( int gridx, int gridy );
+        submap *get_submap_at_grid( int gridx, int gridy, int gridz );
+        submap *get_submap_at_grid( const tripoint &gridp );
         /**
          * Get the index of a submap pointer in the grid given by grid coordinates. The grid
          * coordinates must be valid: 0 <= x < my_MAPSIZE, same for y.
@@ -1419,7 +1478,7 @@ class map
          * Returns true if it has drawn all it should, false if `draw_from_above` should be called after.
          */
         bool draw_maptile( WINDOW *w, player &u, const tripoint &p,
-                           const maptile &tile,
+                           const const_maptile &tile,
                            bool invert, bool show_items,
                            const tripoint &view_center,
                            bool low_light, bool bright_light, bool inorder ) const;
@@ -1427,7 +1486,7 @@ class map
          * Draws the tile as seen from above.
          */
         void draw_from_above( WINDOW *w, player &u, const tripoint &p,
-                              const maptile &tile, bool invert,
+                              const const_maptile &tile, bool invert,
                               const tripoint &view_center,
                               bool low_light, bool bright_light, bool inorder ) const;
 
@@ -1,5 +1,6 @@
 #include "mapbuffer.h"
 
+#include "background_writer.h"
 #include "coordinate_conversions.h"
 #include "output.h"
 #include "debug.h"
@@ -15,15 +16,133 @@
 #include "vehicle.h"
 #include "submap.h"
 #include "computer.h"
+#include "options.h"
+#include "region_file.h"
 
+#include <algorithm>
+#include <memory>
 #include <sstream>
+#include <stdexcept>
+#include <unordered_map>
 
 #define dbg(x) DebugLog((DebugLevel)(x),D_MAP) << __FILE__ << ":" << __LINE__ << ": "
 
 mapbuffer MAPBUFFER;
 
+// Read on every turn by evict and on every quad that is saved or loaded.
+static const cached_option<bool> map_region_files( "MAP_REGION_FILES" );
+static const cached_option<int> map_memory_limit( "MAP_MEMORY_LIMIT" );
+
+// A segment is a chunk of 32x32 submap quads.
+// We're breaking them into subdirectories (or region files) so there aren't too many files
+// per directory.
+static std::string segment_path( const tripoint &om_addr )
+{
+    const tripoint segment_addr = omt_to_seg_copy( om_addr );
+    std::stringstream path;
+    path << world_generator->active_world->world_path << "/maps/" << segment_addr.x << "." <<
+         segment_addr.y << "." << segment_addr.z;
+    return path.str();
+}
+
+static std::string quad_path( const tripoint &om_addr )
+{
+    std::stringstream path;
+    path << segment_path( om_addr ) << "/" << om_addr.x << "." << om_addr.y << "." << om_addr.z <<
+         ".map";
+    return path.str();
+}
+
+static std::string region_path( const tripoint &om_addr )
+{
+    return segment_path( om_addr ) + ".region";
+}
+
+/** Position of the quad in its region file. */
+static point region_slot( const tripoint &om_addr )
+{
+    const tripoint segment_addr = omt_to_seg_copy( om_addr );
+    return point( om_addr.x - segment_addr.x * region_file::size,
+                  om_addr.y - segment_addr.y * region_file::size );
+}
+
+namespace
+{
+
+/** Changes to one region file, written by one job of @ref background_saves. */
+struct region_changes {
+    std::map<point, std::string> quads;
+    /** Quad files that are replaced by @ref quads, they are removed after writing the region. */
+    std::vector<std::string> replaced_files;
+    /** Quads that were written to quad files, so the region has outdated versions of them. */
+    std::vector<point> outdated;
+};
+
+using region_map = std::map<std::string, region_changes>;
+
+/**
+ * Adds a serialized quad to @ref background_saves, or to the changes of its region file.
+ * Quads are written to region files, or to one file per quad. Either way, the other
+ * layout is cleaned up once the quad was written, that's how worlds are migrated.
+ */
+void queue_quad( const tripoint &om_addr, std::string data, const bool use_regions,
+                 region_map &regions )
+{
+    const std::string path = region_path( om_addr );
+    if( use_regions ) {
+        region_changes &region = regions[path];
+        region.quads[region_slot( om_addr )] = std::move( data );
+        region.replaced_files.push_back( quad_path( om_addr ) );
+    } else {
+        // Don't create the directory if it would be empty
+        assure_dir_exist( segment_path( om_addr ) );
+        background_saves.add( quad_path( om_addr ), std::move( data ) );
+        // The region file was written when the option was on, its version of the quad is outdated.
+        if( regions.count( path ) > 0 || file_exist( path ) ) {
+            regions[path].outdated.push_back( region_slot( om_addr ) );
+        }
+    }
+}
+
+/** Adds a job for each changed region file to @ref background_saves. */
+void queue_regions( region_map &regions )
+{
+    for( auto &elem : regions ) {
+        const std::string path = elem.first;
+        const auto changes = std::make_shared<region_changes>( std::move( elem.second ) );
+        background_saves.add( path, [path, changes]() {
+            const region_file region( path );
+            if( !changes->quads.empty() ) {
+                region.write( changes->quads );
+            }
+            if( !changes->outdated.empty() ) {
+                region.remove( changes->outdated );
+            }
+            for( const std::string &file : changes->replaced_files ) {
+                if( file_exist( file ) ) {
+                    remove_file( file );
+                }
+            }
+        } );
+    }
+}
+
+/** Whether the quad is outside of the area that the main map holds. */
+bool outside_main_map( const tripoint &om_addr )
+{
+    const tripoint map_origin = sm_to_omt_copy( g->m.get_abs_sub() );
+    const bool zlev_del = !g->m.has_zlevels() && om_addr.z != g->get_levz();
+    return zlev_del ||
+           om_addr.x < map_origin.x || om_addr.y < map_origin.y ||
+           om_addr.x > map_origin.x + ( MAPSIZE / 2 ) ||
+           om_addr.y > map_origin.y + ( MAPSIZE / 2 );
+}
+
+}
+
 mapbuffer::mapbuffer()
 {
+    recent_lookups.fill( std::make_pair( tripoint_zero, nullptr ) );
 }
 
 mapbuffer::~mapbuffer()
@@ -37,15 +156,25 @@ void mapbuffer::reset()
         delete elem.second;
     }
     submaps.clear();
+    write_confirmed();
+    vehicle_positions.clear();
+    recent_lookups.fill( std::make_pair( tripoint_zero, nullptr ) );
+    shared_submaps.clear();
+    // Terrain ids may change when the game data is loaded again.
+    uniform_submaps.clear();
 }
 
 bool mapbuffer::add_submap(const tripoint &p, submap *sm)
 {
-    if (submaps.count(p) != 0) {
+    if( submaps.count( p ) != 0 || shared_submaps.count( p ) != 0 ) {
         return false;
     }
 
     submaps[p] = sm;
+    sm->last_lookup = ++lookups;
+    if( !sm->vehicles.empty() ) {
+        vehicle_positions.insert( p );
+    }
 
     return true;
 }
@@ -67,15 +196,105 @@ bool mapbuffer::add_submap( int x, int y, int z, std::unique_ptr<submap> &sm )
     return add_submap( tripoint( x, y, z ), sm );
 }
 
+bool mapbuffer::add_uniform_submap( const tripoint &p, const ter_id fill )
+{
+    if( submaps.count( p ) != 0 || shared_submaps.count( p ) != 0 ) {
+        return false;
+    }
+
+    std::unique_ptr<submap> &shared = uniform_submaps[fill];
+    if( !shared ) {
+        shared.reset( new submap() );
+        shared->is_uniform = true;
+        std::uninitialized_fill_n( &shared->ter[0][0], SEEX * SEEY, fill );
+    }
+    shared_submaps[p] = shared.get();
+
+    return true;
+}
+
+bool mapbuffer::is_shared( const submap *const sm ) const
+{
+    if( sm == nullptr || !sm->is_uniform ) {
+        return false;
+    }
+    for( auto &elem : uniform_submaps ) {
+        if( elem.second.get() == sm ) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void mapbuffer::remove_submap( tripoint addr )
+{
+    delete release_submap( addr );
+}
+
+submap *mapbuffer::release_submap( const tripoint &addr )
 {
     auto m_target = submaps.find( addr );
     if( m_target == submaps.end() ) {
         debugmsg( "Tried to remove non-existing submap %d,%d,%d", addr.x, addr.y, addr.z );
-        return;
+        return nullptr;
+    }
+    for( auto &recent : recent_lookups ) {
+        if( recent.second == m_target->second ) {
+            recent.second = nullptr;
+        }
     }
-    delete m_target->second;
+    submap *const sm = m_target->second;
     submaps.erase( m_target );
+    vehicle_positions.erase( addr );
+    return sm;
+}
+
+bool mapbuffer::restore_evicted( const tripoint &p )
+{
+    if( evicted.empty() ) {
+        return false;
+    }
+    // The whole quad, saving writes the quads of the submaps that are loaded.
+    const tripoint quad = omt_to_sm_copy( sm_to_omt_copy( p ) );
+    bool restored = false;
+    for( int x = 0; x < 2; x++ ) {
+        for( int y = 0; y < 2; y++ ) {
+            const auto iter = evicted.find( quad + tripoint( x, y, 0 ) );
+            if( iter == evicted.end() ) {
+                continue;
+            }
+            if( is_shared( iter->second ) ) {
+                if( submaps.count( iter->first ) == 0 ) {
+                    shared_submaps.emplace( iter->first, iter->second );
+                }
+            } else if( !add_submap( iter->first, iter->second ) ) {
+                delete iter->second;
+            }
+            evicted.erase( iter );
+            restored = true;
+        }
+    }
+    return restored;
+}
+
+void mapbuffer::add_vehicle_submap( const tripoint &p )
+{
+    vehicle_positions.insert( p );
+}
+
+std::vector<std::pair<tripoint, submap *>> mapbuffer::vehicle_submaps()
+{
+    std::vector<std::pair<tripoint, submap *>> result;
+    for( auto it = vehicle_positions.begin(); it != vehicle_positions.end(); ) {
+        const auto iter = submaps.find( *it );
+        if( iter == submaps.end() || iter->second == nullptr || iter->second->vehicles.empty() ) {
+            it = vehicle_positions.erase( it );
+        } else {
+            result.emplace_back( *iter );
+            ++it;
+        }
+    }
+    return result;
 }
 
 submap *mapbuffer::lookup_submap(int x, int y, int z)
@@ -85,10 +304,29 @@ submap *mapbuffer::lookup_submap(int x, int y, int z)
 
 submap *mapbuffer::lookup_submap( const tripoint &p )
 {
-    dbg(D_INFO) << "mapbuffer::lookup_submap( x[" << p.x << "], y[" << p.y << "], z[" << p.z << "])";
+    for( auto &recent : recent_lookups ) {
+        if( recent.second != nullptr && recent.first == p ) {
+            recent.second->last_lookup = ++lookups;
+            return recent.second;
+        }
+    }
 
     auto iter = submaps.find( p );
+    if( iter == submaps.end() && restore_evicted( p ) ) {
+        return lookup_submap( p );
+    }
     if( iter == submaps.end() ) {
+        dbg(D_INFO) << "mapbuffer::lookup_submap( x[" << p.x << "], y[" << p.y << "], z[" << p.z << "])";
+        const auto shared = shared_submaps.find( p );
+        if( shared != shared_submaps.end() ) {
+            // First write access, the submap gets its own copy of the shared one.
+            submap *const sm = new submap( *shared->second );
+            sm->turn_last_touched = int( calendar::turn );
+            shared_submaps.erase( shared );
+            submaps[p] = sm;
+            sm->last_lookup = ++lookups;
+            return sm;
+        }
         try {
             return unserialize_submaps( p );
         } catch (const std::exception &err) {
@@ -97,11 +335,28 @@ submap *mapbuffer::lookup_submap( const tripoint &p )
         return NULL;
     }
 
+    if( iter->second != nullptr ) {
+        iter->second->last_lookup = ++lookups;
+        std::move_backward( recent_lookups.begin(), recent_lookups.end() - 1, recent_lookups.end() );
+        recent_lookups.front() = *iter;
+    }
     return iter->second;
 }
 
-void mapbuffer::save( bool delete_after_save )
+const submap *mapbuffer::lookup_shared_submap( const tripoint &p )
+{
+    restore_evicted( p );
+    const auto shared = shared_submaps.find( p );
+    if( shared != shared_submaps.end() ) {
+        return shared->second;
+    }
+    return lookup_submap( p );
+}
+
+void mapbuffer::save( bool delete_after_save, bool force_full_save, bool in_background )
 {
+    force_full_save = force_full_save || full_save_needed;
+    full_save_needed = false;
     std::stringstream map_directory;
     map_directory << world_generator->active_world->world_path << "/maps";
     assure_dir_exist( map_directory.str().c_str() );
@@ -109,61 +364,337 @@ void mapbuffer::save( bool delete_after_save )
     int num_saved_submaps = 0;
     int num_total_submaps = submaps.size();
 
-    const tripoint map_origin = sm_to_omt_copy( g->m.get_abs_sub() );
-    const bool map_has_zlevels = g != nullptr && g->m.has_zlevels();
+    // delete_on_save deletes everything, otherwise delete submaps
+    // outside the current map.
+    const auto should_delete = [&]( const tripoint & om_addr ) {
+        return delete_after_save || outside_main_map( om_addr );
+    };
 
-    // A set of already-saved submaps, in global overmap coordinates.
-    std::set<tripoint> saved_submaps;
+    const bool use_regions = map_region_files.get();
+    region_map regions;
+
+    // Whatever the coordinates of a submap are, we're saving a 2x2 quad of submaps at a time.
+    // Submaps are generated in quads, so we know if we have one member of a quad,
+    // we have the rest of it, if that assumption is broken we have REAL problems.
+    // The quads are saved in order, so the files of a segment are written together.
+    std::set<tripoint> quads;
+    for( auto &elem : submaps ) {
+        // Nothing holds on to item lists between turns.
+        if( elem.second != nullptr ) {
+            elem.second->remove_empty_item_lists();
+        }
+        quads.insert( sm_to_omt_copy( elem.first ) );
+    }
     std::list<tripoint> submaps_to_delete;
     int next_report = 0;
-    for( auto &elem : submaps ) {
-        if( num_total_submaps > 100 && num_saved_submaps >= next_report ) {
+    for( const tripoint &om_addr : quads ) {
+        if( !in_background && num_total_submaps > 100 && num_saved_submaps >= next_report ) {
             popup_nowait(_("Please wait as the map saves [%d/%d]"),
                          num_saved_submaps, num_total_submaps);
             next_report += std::max( 100, num_total_submaps / 20 );
         }
+        num_saved_submaps += 4;
 
-        // Whatever the coordinates of the current submap are,
-        // we're saving a 2x2 quad of submaps at a time.
-        // Submaps are generated in quads, so we know if we have one member of a quad,
-        // we have the rest of it, if that assumption is broken we have REAL problems.
-        const tripoint om_addr = sm_to_omt_copy( elem.first );
-        if( saved_submaps.count( om_addr ) != 0 ) {
-            // Already handled this one.
+        std::string data;
+        if( !save_quad( om_addr, submaps_to_delete, should_delete( om_addr ), force_full_save, data ) ) {
             continue;
         }
-        saved_submaps.insert( om_addr );
-
-        // A segment is a chunk of 32x32 submap quads.
-        // We're breaking them into subdirectories so there aren't too many files per directory.
-        // Might want to make a set for this one too so it's only checked once per save().
-        std::stringstream dirname;
-        tripoint segment_addr = omt_to_seg_copy( om_addr );
-        dirname << map_directory.str() << "/" << segment_addr.x << "." <<
-                     segment_addr.y << "." << segment_addr.z;
-
-        std::stringstream quad_path;
-        quad_path << dirname.str() << "/" << om_addr.x << "." <<
-                  om_addr.y << "." << om_addr.z << ".map";
-
-        // delete_on_save deletes everything, otherwise delete submaps
-        // outside the current map.
-        const bool zlev_del = !map_has_zlevels && om_addr.z != g->get_levz();
-        save_quad( dirname.str(), quad_path.str(), om_addr, submaps_to_delete,
-                   delete_after_save || zlev_del ||
-                   om_addr.x < map_origin.x || om_addr.y < map_origin.y ||
-                   om_addr.x > map_origin.x + (MAPSIZE / 2) ||
-                   om_addr.y > map_origin.y + (MAPSIZE / 2) );
-        num_saved_submaps += 4;
+        queue_quad( om_addr, std::move( data ), use_regions, regions );
     }
+    queue_regions( regions );
     for( auto &elem : submaps_to_delete ) {
         remove_submap( elem );
     }
+    // Shared uniform submaps are never written, they are regenerated when needed.
+    for( auto it = shared_submaps.begin(); it != shared_submaps.end(); ) {
+        if( should_delete( sm_to_omt_copy( it->first ) ) ) {
+            it = shared_submaps.erase( it );
+        } else {
+            ++it;
+        }
+    }
+
+    if( !in_background ) {
+        try {
+            background_saves.wait();
+        } catch( ... ) {
+            write_failed();
+            throw;
+        }
+        write_confirmed();
+    }
+}
+
+void mapbuffer::write_failed()
+{
+    // The submaps were marked as saved when their quads were serialized.
+    full_save_needed = true;
+    while( !evicted.empty() ) {
+        restore_evicted( evicted.begin()->first );
+    }
+}
+
+void mapbuffer::write_confirmed()
+{
+    for( auto &elem : evicted ) {
+        if( !is_shared( elem.second ) ) {
+            delete elem.second;
+        }
+    }
+    evicted.clear();
+}
+
+void mapbuffer::evict()
+{
+    const size_t limit = static_cast<size_t>( map_memory_limit.get() ) * 1024 * 1024 /
+                         sizeof( submap );
+    if( limit == 0 || submaps.size() <= limit ) {
+        return;
+    }
+    // Quads outside the main map by the last lookup of any of their submaps.
+    std::map<tripoint, unsigned long> quads;
+    for( auto &elem : submaps ) {
+        const tripoint om_addr = sm_to_omt_copy( elem.first );
+        if( elem.second != nullptr && outside_main_map( om_addr ) ) {
+            unsigned long &last_lookup = quads[om_addr];
+            last_lookup = std::max( last_lookup, elem.second->last_lookup );
+        }
+    }
+    std::vector<std::pair<unsigned long, tripoint>> coldest;
+    for( auto &elem : quads ) {
+        coldest.emplace_back( elem.second, elem.first );
+    }
+    std::sort( coldest.begin(), coldest.end() );
+
+    // Go well below the limit, so that this doesn't have to run again on the next turns.
+    const size_t target = limit * 3 / 4;
+    const bool use_regions = map_region_files.get();
+    region_map regions;
+    std::list<tripoint> submaps_to_delete;
+    for( auto &elem : coldest ) {
+        if( submaps.size() - submaps_to_delete.size() <= target ) {
+            break;
+        }
+        const tripoint &om_addr = elem.second;
+        std::string data;
+        if( save_quad( om_addr, submaps_to_delete, true, full_save_needed, data ) ) {
+            queue_quad( om_addr, std::move( data ), use_regions, regions );
+        }
+        // Shared members are not written, they are kept with the rest of the quad.
+        for( int x = 0; x < 2; x++ ) {
+            for( int y = 0; y < 2; y++ ) {
+                const auto shared = shared_submaps.find( omt_to_sm_copy( om_addr ) + tripoint( x, y, 0 ) );
+                if( shared != shared_submaps.end() ) {
+                    evicted[shared->first] = const_cast<submap *>( shared->second );
+                    shared_submaps.erase( shared );
+                }
+            }
+        }
+    }
+    queue_regions( regions );
+    // Kept until the quads are written, a failed write would lose them otherwise.
+    for( auto &elem : submaps_to_delete ) {
+        evicted[elem] = release_submap( elem );
+    }
+    dbg( D_INFO ) << "evicted " << submaps_to_delete.size() << " submaps";
+    background_saves.start();
+}
+
+namespace
+{
+
+// Quad files in the binary format start with this, quad files in the JSON format with '['.
+const char binary_map_magic[8] = { 'C', 'D', 'D', 'A', 'M', 'A', 'P', '\0' };
+// Version of the layout of binary quad files, see mapbuffer::save_quad.
+const uint32_t binary_map_version = 1;
+
+// All numbers are stored in little endian byte order.
+void write_u8( std::ostream &os, const uint8_t value )
+{
+    os.put( static_cast<char>( value ) );
+}
+
+void write_u16( std::ostream &os, const uint16_t value )
+{
+    write_u8( os, value & 0xff );
+    write_u8( os, value >> 8 );
+}
+
+void write_u32( std::ostream &os, const uint32_t value )
+{
+    write_u16( os, value & 0xffff );
+    write_u16( os, value >> 16 );
+}
+
+void write_i32( std::ostream &os, const int32_t value )
+{
+    write_u32( os, static_cast<uint32_t>( value ) );
+}
+
+void write_point( std::ostream &os, const point &p )
+{
+    write_u8( os, p.x );
+    write_u8( os, p.y );
+}
+
+void write_string( std::ostream &os, const std::string &str )
+{
+    write_u32( os, str.size() );
+    os.write( str.data(), str.size() );
+}
+
+uint8_t read_u8( std::istream &is )
+{
+    const int value = is.get();
+    if( value == std::char_traits<char>::eof() ) {
+        throw std::runtime_error( "unexpected end of file" );
+    }
+    return value;
+}
+
+uint16_t read_u16( std::istream &is )
+{
+    const uint16_t low = read_u8( is );
+    return low | read_u8( is ) << 8;
+}
+
+uint32_t read_u32( std::istream &is )
+{
+    const uint32_t low = read_u16( is );
+    return low | static_cast<uint32_t>( read_u16( is ) ) << 16;
+}
+
+int32_t read_i32( std::istream &is )
+{
+    return static_cast<int32_t>( read_u32( is ) );
+}
+
+point read_point( std::istream &is )
+{
+    const int x = read_u8( is );
+    const int y = read_u8( is );
+    if( x >= SEEX || y >= SEEY ) {
+        throw std::runtime_error( "square out of bounds" );
+    }
+    return point( x, y );
+}
+
+std::string read_string( std::istream &is )
+{
+    const uint32_t size = read_u32( is );
+    std::string result( size, '\0' );
+    is.read( &result[0], size );
+    if( static_cast<uint32_t>( is.gcount() ) != size ) {
+        throw std::runtime_error( "unexpected end of file" );
+    }
+    return result;
+}
+
+/** Maps string ids to their index in the file, in order of first use. */
+class id_dictionary
+{
+    public:
+        uint16_t index( const std::string &id ) {
+            const auto iter = indices.emplace( id, ids.size() );
+            if( iter.second ) {
+                ids.push_back( id );
+            }
+            return iter.first->second;
+        }
+        void write( std::ostream &os ) const {
+            write_u32( os, ids.size() );
+            for( const std::string &id : ids ) {
+                write_string( os, id );
+            }
+        }
+
+    private:
+        std::vector<std::string> ids;
+        std::unordered_map<std::string, uint16_t> indices;
+};
+
+/** Reads a dictionary written by @ref id_dictionary and resolves each id once. */
+template<typename T>
+std::vector<int_id<T>> read_dictionary( std::istream &is )
+{
+    std::vector<int_id<T>> result;
+    const uint32_t size = read_u32( is );
+    for( uint32_t i = 0; i < size; i++ ) {
+        result.push_back( string_id<T>( read_string( is ) ).id() );
+    }
+    return result;
+}
+
+template<typename T>
+int_id<T> read_id( std::istream &is, const std::vector<int_id<T>> &dictionary )
+{
+    const uint16_t index = read_u16( is );
+    if( index >= dictionary.size() ) {
+        throw std::runtime_error( "id index out of bounds" );
+    }
+    return dictionary[index];
+}
+
+}
+
+// Writes the members of a submap that are not stored in the binary part of the quad file.
+static void serialize_submap_extras( JsonOut &jsout, const submap *const sm )
+{
+    jsout.member("cosmetics");
+    jsout.start_array();
+    for (int j = 0; j < SEEY; j++) {
+        for (int i = 0; i < SEEX; i++) {
+            if (sm->cosmetics[i][j].size() > 0) {
+                jsout.start_array();
+                jsout.write(i);
+                jsout.write(j);
+                jsout.write(sm->cosmetics[i][j]);
+                jsout.end_array();
+            }
+        }
+    }
+    jsout.end_array();
+
+    // Output the spawn points
+    jsout.member( "spawns" );
+    jsout.start_array();
+    for( auto &elem : sm->spawns ) {
+        jsout.start_array();
+        jsout.write( elem.type.str() ); // TODO: json should know how to write string_ids
+        jsout.write( elem.count );
+        jsout.write( elem.posx );
+        jsout.write( elem.posy );
+        jsout.write( elem.faction_id );
+        jsout.write( elem.mission_id );
+        jsout.write( elem.friendly );
+        jsout.write( elem.name );
+        jsout.end_array();
+    }
+    jsout.end_array();
+
+    jsout.member( "vehicles" );
+    jsout.start_array();
+    for( auto &elem : sm->vehicles ) {
+        // json lib doesn't know how to turn a vehicle * into a vehicle,
+        // so we have to iterate manually.
+        jsout.write( *elem );
+    }
+    jsout.end_array();
+
+    // Output the computer
+    if( sm->comp != nullptr ) {
+        jsout.member( "computers", sm->comp->save_data() );
+    }
+
+    // Output base camp if any
+    if (sm->camp.is_valid()) {
+        jsout.member( "camp" );
+        jsout.write( sm->camp.save_data() );
+    }
 }
 
-void mapbuffer::save_quad( const std::string &dirname, const std::string &filename,
-                           const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
-                           bool delete_after_save )
+bool mapbuffer::save_quad( const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
+                           bool delete_after_save, bool force_full_save, std::string &data )
 {
     std::vector<point> offsets;
     std::vector<tripoint> submap_addrs;
@@ -173,19 +704,24 @@ void mapbuffer::save_quad( const std::string &dirname, const std::string &filena
     offsets.push_back( point(1, 1) );
 
     bool all_uniform = true;
+    bool modified = force_full_save;
     for( auto &offsets_offset : offsets ) {
         tripoint submap_addr = omt_to_sm_copy( om_addr );
         submap_addr.x += offsets_offset.x;
         submap_addr.y += offsets_offset.y;
         submap_addrs.push_back( submap_addr );
-        submap *sm = submaps[submap_addr];
-        if( sm != nullptr && !sm->is_uniform ) {
+        const auto iter = submaps.find( submap_addr );
+        if( iter != submaps.end() && iter->second != nullptr && !iter->second->is_uniform ) {
             all_uniform = false;
         }
+        if( iter != submaps.end() && iter->second != nullptr && iter->second->is_modified() ) {
+            modified = true;
+        }
     }
 
-    if( all_uniform ) {
-        // Nothing to save - this quad will be regenerated faster than it would be re-read
+    if( all_uniform || !modified ) {
+        // Nothing to save - this quad will be regenerated faster than it would be re-read,
+        // or the file already has the current state of it.
         if( delete_after_save ) {
             for( auto &submap_addr : submap_addrs ) {
                 if( submaps.count( submap_addr ) > 0 && submaps[submap_addr] != nullptr ) {
@@ -194,432 +730,524 @@ void mapbuffer::save_quad( const std::string &dirname, const std::string &filena
             }
         }
 
-        return;
+        return false;
     }
 
-    // Don't create the directory if it would be empty
-    assure_dir_exist( dirname.c_str() );
-    ofstream_wrapper_exclusive fout( filename );
-    JsonOut jsout( fout );
-    jsout.start_array();
+    // Terrain, furniture and trap ids are stored once per file, the submaps refer to them
+    // by their index in these dictionaries. The submaps are written first, so that the
+    // dictionaries are complete when they are written in front of them.
+    id_dictionary terrain_ids;
+    id_dictionary furniture_ids;
+    id_dictionary trap_ids;
+    std::ostringstream body( std::ios::binary );
+    uint32_t submap_count = 0;
     for( auto &submap_addr : submap_addrs ) {
-        if( submaps.count( submap_addr ) == 0 ) {
-            continue;
+        // Uniform members of a non-uniform quad are written too, the quad is
+        // loaded as a whole.
+        const auto shared = shared_submaps.find( submap_addr );
+        const auto iter = submaps.find( submap_addr );
+        const submap *sm = nullptr;
+        if( shared != shared_submaps.end() ) {
+            sm = shared->second;
+        } else if( iter != submaps.end() ) {
+            sm = iter->second;
         }
-
-        submap *sm = submaps[submap_addr];
         if( sm == nullptr ) {
             continue;
         }
+        submap_count++;
 
-        jsout.start_object();
-
-        jsout.member( "version", savegame_version);
-
-        jsout.member( "coordinates" );
-        jsout.start_array();
-        jsout.write( submap_addr.x );
-        jsout.write( submap_addr.y );
-        jsout.write( submap_addr.z );
-        jsout.end_array();
-
-        jsout.member( "turn_last_touched", sm->turn_last_touched );
-        jsout.member( "temperature", sm->temperature );
+        write_i32( body, submap_addr.x );
+        write_i32( body, submap_addr.y );
+        write_i32( body, submap_addr.z );
+        write_i32( body, savegame_version );
+        write_i32( body, sm->turn_last_touched );
+        write_i32( body, sm->temperature );
 
-        jsout.member( "terrain" );
-        jsout.start_array();
-        for(int j = 0; j < SEEY; j++) {
-            for(int i = 0; i < SEEX; i++) {
-                // Save terrains
-                jsout.write( sm->ter[i][j].obj().id );
+        for( int j = 0; j < SEEY; j++ ) {
+            for( int i = 0; i < SEEX; i++ ) {
+                write_u16( body, terrain_ids.index( sm->ter[i][j].id().str() ) );
+            }
+        }
+        for( int j = 0; j < SEEY; j++ ) {
+            for( int i = 0; i < SEEX; i++ ) {
+                write_u16( body, furniture_ids.index( sm->frn[i][j].id().str() ) );
             }
         }
-        jsout.end_array();
 
-        // Write out the radiation array in a simple RLE scheme.
-        // written in intensity, count pairs
-        jsout.member( "radiation" );
-        jsout.start_array();
-        int lastrad = -1;
+        // Radiation as (intensity, count) runs over all squares.
+        int lastrad = sm->get_radiation( 0, 0 );
         int count = 0;
-        for(int j = 0; j < SEEY; j++) {
-            for(int i = 0; i < SEEX; i++) {
-                // Save radiation, re-examine this because it doesn't look like it works right
-                int r = sm->get_radiation(i, j);
-                if (r == lastrad) {
-                    count++;
-                } else {
-                    if (count) {
-                        jsout.write( count );
-                    }
-                    jsout.write( r );
+        for( int j = 0; j < SEEY; j++ ) {
+            for( int i = 0; i < SEEX; i++ ) {
+                const int r = sm->get_radiation( i, j );
+                if( r != lastrad ) {
+                    write_i32( body, lastrad );
+                    write_u16( body, count );
                     lastrad = r;
-                    count = 1;
+                    count = 0;
                 }
+                count++;
             }
         }
-        jsout.write( count );
-        jsout.end_array();
+        write_i32( body, lastrad );
+        write_u16( body, count );
 
-        jsout.member("furniture");
-        jsout.start_array();
-        for(int j = 0; j < SEEY; j++) {
-            for(int i = 0; i < SEEX; i++) {
-                // Save furniture
-                if( sm->get_furn( i, j ) != f_null ) {
-                    jsout.start_array();
-                    jsout.write( i );
-                    jsout.write( j );
-                    jsout.write( sm->get_furn( i, j ).obj().id );
-                    jsout.end_array();
+        std::vector<point> trap_points;
+        std::vector<point> field_points;
+        for( int j = 0; j < SEEY; j++ ) {
+            for( int i = 0; i < SEEX; i++ ) {
+                if( sm->get_trap( i, j ) != tr_null ) {
+                    trap_points.emplace_back( i, j );
                 }
-            }
-        }
-        jsout.end_array();
-
-        jsout.member( "items" );
-        jsout.start_array();
-        for(int j = 0; j < SEEY; j++) {
-            for(int i = 0; i < SEEX; i++) {
-                if( sm->itm[i][j].empty() ) {
-                    continue;
+                if( sm->fld[i][j].fieldCount() > 0 ) {
+                    field_points.emplace_back( i, j );
                 }
-                jsout.write( i );
-                jsout.write( j );
-                jsout.write( sm->itm[i][j] );
             }
         }
-        jsout.end_array();
-
-        jsout.member( "traps" );
-        jsout.start_array();
-        for(int j = 0; j < SEEY; j++) {
-            for(int i = 0; i < SEEX; i++) {
-                // Save traps
-                if (sm->get_trap( i, j ) != tr_null) {
-                    jsout.start_array();
-                    jsout.write( i );
-                    jsout.write( j );
-                    // TODO: jsout should support writting an id like jsout.write( trap_id )
-                    jsout.write( sm->get_trap( i, j ).id().str() );
-                    jsout.end_array();
-                }
+        write_u16( body, trap_points.size() );
+        for( const point &p : trap_points ) {
+            write_point( body, p );
+            write_u16( body, trap_ids.index( sm->get_trap( p.x, p.y ).id().str() ) );
+        }
+        write_u16( body, field_points.size() );
+        for( const point &p : field_points ) {
+            write_point( body, p );
+            write_u8( body, sm->fld[p.x][p.y].fieldCount() );
+            for( auto &fld : sm->fld[p.x][p.y] ) {
+                const field_entry &cur = fld.second;
+                write_i32( body, cur.getFieldType() );
+                write_i32( body, cur.getFieldDensity() );
+                write_i32( body, cur.getFieldAge() );
             }
         }
-        jsout.end_array();
 
-        jsout.member( "fields" );
-        jsout.start_array();
-        for(int j = 0; j < SEEY; j++) {
-            for(int i = 0; i < SEEX; i++) {
-                // Save fields
-                if (sm->fld[i][j].fieldCount() > 0) {
-                    jsout.write( i );
-                    jsout.write( j );
-                    jsout.start_array();
-                    for( auto &fld : sm->fld[i][j] ) {
-                        const field_entry &cur = fld.second;
-                            // We don't seem to have a string identifier for fields anywhere.
-                            jsout.write( cur.getFieldType() );
-                            jsout.write( cur.getFieldDensity() );
-                            jsout.write( cur.getFieldAge() );
-                    }
-                    jsout.end_array();
-                }
+        // Items and the rarely used parts of a submap are stored as length-prefixed JSON,
+        // they are read with the same code as the JSON format.
+        uint16_t item_tiles = 0;
+        for( auto &elem : sm->get_item_lists() ) {
+            if( !elem.second.empty() ) {
+                item_tiles++;
             }
         }
-        jsout.end_array();
-
-        jsout.member("cosmetics");
-        jsout.start_array();
-        for (int j = 0; j < SEEY; j++) {
-            for (int i = 0; i < SEEX; i++) {
-                if (sm->cosmetics[i][j].size() > 0) {
-                    jsout.start_array();
-                    jsout.write(i);
-                    jsout.write(j);
-                    jsout.write(sm->cosmetics[i][j]);
-                    jsout.end_array();
-                }
+        write_u16( body, item_tiles );
+        for( auto &elem : sm->get_item_lists() ) {
+            if( elem.second.empty() ) {
+                continue;
             }
+            write_point( body, elem.first );
+            std::ostringstream blob;
+            JsonOut jsout( blob );
+            jsout.write( elem.second );
+            write_string( body, blob.str() );
         }
-        jsout.end_array();
 
-        // Output the spawn points
-        jsout.member( "spawns" );
-        jsout.start_array();
-        for( auto &elem : sm->spawns ) {
-            jsout.start_array();
-            jsout.write( elem.type.str() ); // TODO: json should know how to write string_ids
-            jsout.write( elem.count );
-            jsout.write( elem.posx );
-            jsout.write( elem.posy );
-            jsout.write( elem.faction_id );
-            jsout.write( elem.mission_id );
-            jsout.write( elem.friendly );
-            jsout.write( elem.name );
-            jsout.end_array();
-        }
-        jsout.end_array();
+        std::ostringstream blob;
+        JsonOut jsout( blob );
+        jsout.start_object();
+        serialize_submap_extras( jsout, sm );
+        jsout.end_object();
+        write_string( body, blob.str() );
 
-        jsout.member( "vehicles" );
-        jsout.start_array();
-        for( auto &elem : sm->vehicles ) {
-            // json lib doesn't know how to turn a vehicle * into a vehicle,
-            // so we have to iterate manually.
-            jsout.write( *elem );
+        if( delete_after_save && shared == shared_submaps.end() ) {
+            submaps_to_delete.push_back( submap_addr );
         }
-        jsout.end_array();
+    }
 
-        // Output the computer
-        if( sm->comp != nullptr ) {
-            jsout.member( "computers", sm->comp->save_data() );
-        }
+    std::ostringstream fout( std::ios::binary );
+    fout.write( binary_map_magic, sizeof( binary_map_magic ) );
+    write_u32( fout, binary_map_version );
+    terrain_ids.write( fout );
+    furniture_ids.write( fout );
+    trap_ids.write( fout );
+    write_u32( fout, submap_count );
+    fout << body.str();
+    data = fout.str();
 
-        // Output base camp if any
-        if (sm->camp.is_valid()) {
-            jsout.member( "camp" );
-            jsout.write( sm->camp.save_data() );
-        }
-        if( delete_after_save ) {
-            submaps_to_delete.push_back( submap_addr );
+    for( auto &submap_addr : submap_addrs ) {
+        const auto iter = submaps.find( submap_addr );
+        if( iter != submaps.end() && iter->second != nullptr ) {
+            iter->second->saved_generation = iter->second->modified_generation;
         }
-        jsout.end_object();
     }
-
-    jsout.end_array();
-    fout.close();
+    return true;
 }
 
-// We're reading in way too many entities here to mess around with creating sub-objects and
-// seeking around in them, so we're using the json streaming API.
 submap *mapbuffer::unserialize_submaps( const tripoint &p )
 {
     // Map the tripoint to the submap quad that stores it.
     const tripoint om_addr = sm_to_omt_copy( p );
-    const tripoint segment_addr = omt_to_seg_copy( om_addr );
-    std::stringstream quad_path;
-    quad_path << world_generator->active_world->world_path << "/maps/" <<
-              segment_addr.x << "." << segment_addr.y << "." << segment_addr.z << "/" <<
-              om_addr.x << "." << om_addr.y << "." << om_addr.z << ".map";
+    const std::string file_path = quad_path( om_addr );
+    const std::string region = region_path( om_addr );
 
-    using namespace std::placeholders;
-    if( !read_from_file_optional_json( quad_path.str(), std::bind( &mapbuffer::deserialize, this, _1 ) ) ) {
+    // The quad may still be written by the last save.
+    background_saves.wait_for( file_path );
+    background_saves.wait_for( region );
+    // While a world is migrated, a quad can be in its own file and in the region file. The
+    // layout that is used for saving has the current version, the other one is removed when
+    // the quad is saved (see save).
+    std::string data;
+    const auto read_file = [&]() {
+        return read_from_file_optional( file_path, [&data]( std::istream & fin ) {
+            std::ostringstream contents;
+            contents << fin.rdbuf();
+            data = contents.str();
+        } );
+    };
+    const auto read_region = [&]() {
+        try {
+            return region_file( region ).read( region_slot( om_addr ), data );
+        } catch( const std::exception &err ) {
+            debugmsg( _( "Failed to read from \"%1$s\": %2$s" ), region.c_str(), err.what() );
+            return false;
+        }
+    };
+    bool found;
+    if( map_region_files.get() ) {
+        found = read_region() || read_file();
+    } else {
+        found = read_file() || read_region();
+    }
+    if( !found ) {
         // If it doesn't exist, trigger generating it.
         return NULL;
     }
+    try {
+        std::istringstream fin( data, std::ios::binary );
+        deserialize_quad( fin );
+    } catch( const std::exception &err ) {
+        debugmsg( "failed to load the map quad %d,%d,%d: %s", om_addr.x, om_addr.y, om_addr.z,
+                  err.what() );
+        return NULL;
+    }
     if( submaps.count( p ) == 0 ) {
-        debugmsg("file %s did not contain the expected submap %d,%d,%d", quad_path.str().c_str(), p.x, p.y,
-                 p.z);
+        debugmsg( "quad %d,%d,%d did not contain the expected submap %d,%d,%d", om_addr.x, om_addr.y,
+                  om_addr.z, p.x, p.y, p.z );
         return NULL;
     }
     return submaps[ p ];
 }
 
-void mapbuffer::deserialize( JsonIn &jsin )
+void mapbuffer::deserialize_quad( std::istream &fin )
+{
+    char magic[sizeof( binary_map_magic )];
+    fin.read( magic, sizeof( magic ) );
+    if( fin.gcount() == sizeof( magic ) &&
+        std::equal( magic, magic + sizeof( magic ), binary_map_magic ) ) {
+        deserialize_binary( fin );
+    } else {
+        // Quads saved by older versions are JSON. Their submaps stay modified, so they
+        // are converted to the binary format when saved again.
+        fin.clear();
+        fin.seekg( 0 );
+        JsonIn jsin( fin );
+        deserialize( jsin );
+    }
+}
+
+// Reads the items of one square (a JSON array), used by both file formats.
+static void deserialize_items( JsonIn &jsin, submap *const sm, const int i, const int j )
 {
+    auto &items = sm->get_items( i, j );
     jsin.start_array();
     while( !jsin.end_array() ) {
-        std::unique_ptr<submap> sm(new submap());
-        tripoint submap_coordinates;
-        jsin.start_object();
-        bool rubpow_update = false;
-        while( !jsin.end_object() ) {
-            std::string submap_member_name = jsin.get_member_name();
-            if( submap_member_name == "version" ) {
-                if (jsin.get_int() < 22) {
-                    rubpow_update = true;
-                }
-            } else if( submap_member_name == "coordinates" ) {
-                jsin.start_array();
-                int locx = jsin.get_int();
-                int locy = jsin.get_int();
-                int locz = jsin.get_int();
-                jsin.end_array();
-                submap_coordinates = tripoint( locx, locy, locz );
-            } else if( submap_member_name == "turn_last_touched" ) {
-                sm->turn_last_touched = jsin.get_int();
-            } else if( submap_member_name == "temperature" ) {
-                sm->temperature = jsin.get_int();
-            } else if( submap_member_name == "terrain" ) {
-                // TODO: try block around this to error out if we come up short?
-                jsin.start_array();
-                // Small duplication here so that the update check is only performed once
-                if (rubpow_update) {
-                    item rock = item("rock", 0);
-                    item chunk = item("steel_chunk", 0);
-                    for( int j = 0; j < SEEY; j++ ) {
-                        for( int i = 0; i < SEEX; i++ ) {
-                            const ter_str_id tid( jsin.get_string() );
-
-                            if ( tid == "t_rubble" ) {
-                                sm->ter[i][j] = ter_id( "t_dirt" );
-                                sm->frn[i][j] = furn_id( "f_rubble" );
-                                sm->itm[i][j].push_back( rock );
-                                sm->itm[i][j].push_back( rock );
-                            } else if ( tid == "t_wreckage" ){
-                                sm->ter[i][j] = ter_id( "t_dirt" );
-                                sm->frn[i][j] = furn_id( "f_wreckage" );
-                                sm->itm[i][j].push_back( chunk );
-                                sm->itm[i][j].push_back( chunk );
-                            } else if ( tid == "t_ash" ){
-                                sm->ter[i][j] = ter_id(  "t_dirt" );
-                                sm->frn[i][j] = furn_id( "f_ash" );
-                            } else if ( tid == "t_pwr_sb_support_l" ){
-                                sm->ter[i][j] = ter_id(  "t_support_l" );
-                            } else if ( tid == "t_pwr_sb_switchgear_l" ){
-                                sm->ter[i][j] = ter_id(  "t_switchgear_l" );
-                            } else if ( tid == "t_pwr_sb_switchgear_s" ){
-                                sm->ter[i][j] = ter_id(  "t_switchgear_s" );
-                            } else {
-                                sm->ter[i][j] = tid.id();
-                            }
-                        }
-                    }
-                } else {
-                    for( int j = 0; j < SEEY; j++ ) {
-                        for( int i = 0; i < SEEX; i++ ) {
-                            const ter_str_id tid( jsin.get_string() );
+        item tmp;
+        jsin.read( tmp );
+
+        if( tmp.is_emissive() ) {
+            sm->update_lum_add(tmp, i, j);
+        }
+
+        tmp.visit_items( [ &items ]( item *it ) {
+            for( auto& e: it->magazine_convert() ) {
+                items.push_back( e );
+            }
+            return VisitResponse::NEXT;
+        } );
+
+        items.push_back( tmp );
+        if( tmp.needs_processing() ) {
+            sm->active_items.add( std::prev( items.end() ), point( i, j ) );
+        }
+    }
+}
+
+// Reads a submap object in the JSON format. The binary format stores the rarely used parts
+// of a submap as such an object, so all members are optional.
+static tripoint deserialize_submap( JsonIn &jsin, submap *const sm )
+{
+    tripoint submap_coordinates;
+    jsin.start_object();
+    bool rubpow_update = false;
+    while( !jsin.end_object() ) {
+        std::string submap_member_name = jsin.get_member_name();
+        if( submap_member_name == "version" ) {
+            if (jsin.get_int() < 22) {
+                rubpow_update = true;
+            }
+        } else if( submap_member_name == "coordinates" ) {
+            jsin.start_array();
+            int locx = jsin.get_int();
+            int locy = jsin.get_int();
+            int locz = jsin.get_int();
+            jsin.end_array();
+            submap_coordinates = tripoint( locx, locy, locz );
+        } else if( submap_member_name == "turn_last_touched" ) {
+            sm->turn_last_touched = jsin.get_int();
+        } else if( submap_member_name == "temperature" ) {
+            sm->temperature = jsin.get_int();
+        } else if( submap_member_name == "terrain" ) {
+            // TODO: try block around this to error out if we come up short?
+            jsin.start_array();
+            // Small duplication here so that the update check is only performed once
+            if (rubpow_update) {
+                item rock = item("rock", 0);
+                item chunk = item("steel_chunk", 0);
+                for( int j = 0; j < SEEY; j++ ) {
+                    for( int i = 0; i < SEEX; i++ ) {
+                        const ter_str_id tid( jsin.get_string() );
+
+                        if ( tid == "t_rubble" ) {
+                            sm->ter[i][j] = ter_id( "t_dirt" );
+                            sm->frn[i][j] = furn_id( "f_rubble" );
+                            sm->get_items( i, j ).push_back( rock );
+                            sm->get_items( i, j ).push_back( rock );
+                        } else if ( tid == "t_wreckage" ){
+                            sm->ter[i][j] = ter_id( "t_dirt" );
+                            sm->frn[i][j] = furn_id( "f_wreckage" );
+                            sm->get_items( i, j ).push_back( chunk );
+                            sm->get_items( i, j ).push_back( chunk );
+                        } else if ( tid == "t_ash" ){
+                            sm->ter[i][j] = ter_id(  "t_dirt" );
+                            sm->frn[i][j] = furn_id( "f_ash" );
+                        } else if ( tid == "t_pwr_sb_support_l" ){
+                            sm->ter[i][j] = ter_id(  "t_support_l" );
+                        } else if ( tid == "t_pwr_sb_switchgear_l" ){
+                            sm->ter[i][j] = ter_id(  "t_switchgear_l" );
+                        } else if ( tid == "t_pwr_sb_switchgear_s" ){
+                            sm->ter[i][j] = ter_id(  "t_switchgear_s" );
+                        } else {
                             sm->ter[i][j] = tid.id();
                         }
                     }
                 }
-                jsin.end_array();
-            } else if( submap_member_name == "radiation" ) {
-                int rad_cell = 0;
-                jsin.start_array();
-                while( !jsin.end_array() ) {
-                    int rad_strength = jsin.get_int();
-                    int rad_num = jsin.get_int();
-                    for( int i = 0; i < rad_num; ++i ) {
-                        // A little array trick here, assign to it as a 1D array.
-                        // If it's not in bounds we're kinda hosed anyway.
-                        sm->set_radiation(0, rad_cell, rad_strength);
-                        rad_cell++;
+            } else {
+                for( int j = 0; j < SEEY; j++ ) {
+                    for( int i = 0; i < SEEX; i++ ) {
+                        const ter_str_id tid( jsin.get_string() );
+                        sm->ter[i][j] = tid.id();
                     }
                 }
-            } else if( submap_member_name == "furniture" ) {
-                jsin.start_array();
-                while( !jsin.end_array() ) {
-                    jsin.start_array();
-                    int i = jsin.get_int();
-                    int j = jsin.get_int();
-                    sm->frn[i][j] = furn_id( jsin.get_string() );
-                    jsin.end_array();
+            }
+            jsin.end_array();
+        } else if( submap_member_name == "radiation" ) {
+            int rad_cell = 0;
+            jsin.start_array();
+            while( !jsin.end_array() ) {
+                int rad_strength = jsin.get_int();
+                int rad_num = jsin.get_int();
+                for( int i = 0; i < rad_num; ++i ) {
+                    // A little array trick here, assign to it as a 1D array.
+                    // If it's not in bounds we're kinda hosed anyway.
+                    sm->set_radiation(0, rad_cell, rad_strength);
+                    rad_cell++;
                 }
-            } else if( submap_member_name == "items" ) {
+            }
+        } else if( submap_member_name == "furniture" ) {
+            jsin.start_array();
+            while( !jsin.end_array() ) {
                 jsin.start_array();
-                while( !jsin.end_array() ) {
-                    int i = jsin.get_int();
-                    int j = jsin.get_int();
-                    jsin.start_array();
-                    while( !jsin.end_array() ) {
-                        item tmp;
-                        jsin.read( tmp );
-
-                        if( tmp.is_emissive() ) {
-                            sm->update_lum_add(tmp, i, j);
-                        }
-
-                        tmp.visit_items( [ &sm, i, j ]( item *it ) {
-                            for( auto& e: it->magazine_convert() ) {
-                                sm->itm[i][j].push_back( e );
-                            }
-                            return VisitResponse::NEXT;
-                        } );
-
-                        sm->itm[i][j].push_back( tmp );
-                        if( tmp.needs_processing() ) {
-                            sm->active_items.add( std::prev(sm->itm[i][j].end()), point( i, j ) );
-                        }
-                    }
-                }
-            } else if( submap_member_name == "traps" ) {
+                int i = jsin.get_int();
+                int j = jsin.get_int();
+                sm->frn[i][j] = furn_id( jsin.get_string() );
+                jsin.end_array();
+            }
+        } else if( submap_member_name == "items" ) {
+            jsin.start_array();
+            while( !jsin.end_array() ) {
+                int i = jsin.get_int();
+                int j = jsin.get_int();
+                deserialize_items( jsin, sm, i, j );
+            }
+        } else if( submap_member_name == "traps" ) {
+            jsin.start_array();
+            while( !jsin.end_array() ) {
                 jsin.start_array();
-                while( !jsin.end_array() ) {
-                    jsin.start_array();
-                    int i = jsin.get_int();
-                    int j = jsin.get_int();
-                    // TODO: jsin should support returning an id like jsin.get_id<trap>()
-                    const trap_str_id trid( jsin.get_string() );
-                    if( trid == "tr_brazier" ) {
-                        sm->frn[i][j] = furn_id( "f_brazier" );
-                    } else {
-                        sm->trp[i][j] = trid.id();
-                    }
-                    // @todo: remove brazier trap-to-furniture conversion after 0.D
-                    jsin.end_array();
+                int i = jsin.get_int();
+                int j = jsin.get_int();
+                // TODO: jsin should support returning an id like jsin.get_id<trap>()
+                const trap_str_id trid( jsin.get_string() );
+                if( trid == "tr_brazier" ) {
+                    sm->frn[i][j] = furn_id( "f_brazier" );
+                } else {
+                    sm->trp[i][j] = trid.id();
                 }
-            } else if( submap_member_name == "fields" ) {
+                // @todo: remove brazier trap-to-furniture conversion after 0.D
+                jsin.end_array();
+            }
+        } else if( submap_member_name == "fields" ) {
+            jsin.start_array();
+            while( !jsin.end_array() ) {
+                // Coordinates loop
+                int i = jsin.get_int();
+                int j = jsin.get_int();
                 jsin.start_array();
                 while( !jsin.end_array() ) {
-                    // Coordinates loop
-                    int i = jsin.get_int();
-                    int j = jsin.get_int();
-                    jsin.start_array();
-                    while( !jsin.end_array() ) {
-                        int type = jsin.get_int();
-                        int density = jsin.get_int();
-                        int age = jsin.get_int();
-                        if (sm->fld[i][j].findField(field_id(type)) == NULL) {
-                            sm->field_count++;
-                        }
-                        sm->fld[i][j].addField(field_id(type), density, age);
+                    int type = jsin.get_int();
+                    int density = jsin.get_int();
+                    int age = jsin.get_int();
+                    if (sm->fld[i][j].findField(field_id(type)) == NULL) {
+                        sm->field_count++;
                     }
+                    sm->fld[i][j].addField(field_id(type), density, age);
                 }
-            } else if( submap_member_name == "graffiti" ) {
+            }
+        } else if( submap_member_name == "graffiti" ) {
+            jsin.start_array();
+            while( !jsin.end_array() ) {
                 jsin.start_array();
-                while( !jsin.end_array() ) {
-                    jsin.start_array();
-                    int i = jsin.get_int();
-                    int j = jsin.get_int();
-                    sm->set_graffiti( i, j, jsin.get_string() );
-                    jsin.end_array();
-                }
-            } else if(submap_member_name == "cosmetics") {
+                int i = jsin.get_int();
+                int j = jsin.get_int();
+                sm->set_graffiti( i, j, jsin.get_string() );
+                jsin.end_array();
+            }
+        } else if(submap_member_name == "cosmetics") {
+            jsin.start_array();
+            while (!jsin.end_array()) {
                 jsin.start_array();
-                while (!jsin.end_array()) {
-                    jsin.start_array();
-                    int i = jsin.get_int();
-                    int j = jsin.get_int();
-                    jsin.read(sm->cosmetics[i][j]);
-                    jsin.end_array();
-                }
-            } else if( submap_member_name == "spawns" ) {
+                int i = jsin.get_int();
+                int j = jsin.get_int();
+                jsin.read(sm->cosmetics[i][j]);
+                jsin.end_array();
+            }
+        } else if( submap_member_name == "spawns" ) {
+            jsin.start_array();
+            while( !jsin.end_array() ) {
                 jsin.start_array();
-                while( !jsin.end_array() ) {
-                    jsin.start_array();
-                    const mtype_id type = mtype_id( jsin.get_string() ); // TODO: json should know how to read an string_id
-                    int count = jsin.get_int();
-                    int i = jsin.get_int();
-                    int j = jsin.get_int();
-                    int faction_id = jsin.get_int();
-                    int mission_id = jsin.get_int();
-                    bool friendly = jsin.get_bool();
-                    std::string name = jsin.get_string();
-                    jsin.end_array();
-                    spawn_point tmp( type, count, i, j, faction_id, mission_id, friendly, name );
-                    sm->spawns.push_back( tmp );
+                const mtype_id type = mtype_id( jsin.get_string() ); // TODO: json should know how to read an string_id
+                int count = jsin.get_int();
+                int i = jsin.get_int();
+                int j = jsin.get_int();
+                int faction_id = jsin.get_int();
+                int mission_id = jsin.get_int();
+                bool friendly = jsin.get_bool();
+                std::string name = jsin.get_string();
+                jsin.end_array();
+                spawn_point tmp( type, count, i, j, faction_id, mission_id, friendly, name );
+                sm->spawns.push_back( tmp );
+            }
+        } else if( submap_member_name == "vehicles" ) {
+            jsin.start_array();
+            while( !jsin.end_array() ) {
+                vehicle *tmp = new vehicle();
+                jsin.read( *tmp );
+                sm->vehicles.push_back( tmp );
+            }
+        } else if( submap_member_name == "computers" ) {
+            std::string computer_data = jsin.get_string();
+            std::unique_ptr<computer> new_comp( new computer( "BUGGED_COMPUTER", -100 ) );
+            new_comp->load_data( computer_data );
+            sm->comp.reset( new_comp.release() );
+        } else if( submap_member_name == "camp" ) {
+            std::string camp_data = jsin.get_string();
+            sm->camp.load_data( camp_data );
+        } else {
+            jsin.skip_value();
+        }
+    }
+    return submap_coordinates;
+}
+
+void mapbuffer::deserialize( JsonIn &jsin )
+{
+    jsin.start_array();
+    while( !jsin.end_array() ) {
+        std::unique_ptr<submap> sm(new submap());
+        const tripoint submap_coordinates = deserialize_submap( jsin, sm.get() );
+        if( !add_submap( submap_coordinates, sm ) ) {
+            debugmsg( "submap %d,%d,%d was already loaded", submap_coordinates.x, submap_coordinates.y,
+                      submap_coordinates.z );
+        }
+    }
+}
+
+void mapbuffer::deserialize_binary( std::istream &fin )
+{
+    if( read_u32( fin ) > binary_map_version ) {
+        throw std::runtime_error( "map file was written by a newer version" );
+    }
+    const auto terrain_ids = read_dictionary<ter_t>( fin );
+    const auto furniture_ids = read_dictionary<furn_t>( fin );
+    const auto trap_ids = read_dictionary<trap>( fin );
+    const uint32_t submap_count = read_u32( fin );
+    for( uint32_t n = 0; n < submap_count; n++ ) {
+        std::unique_ptr<submap> sm( new submap() );
+        tripoint submap_coordinates;
+        submap_coordinates.x = read_i32( fin );
+        submap_coordinates.y = read_i32( fin );
+        submap_coordinates.z = read_i32( fin );
+        // The savegame version is stored for later migrations, none are needed yet.
+        read_i32( fin );
+        sm->turn_last_touched = read_i32( fin );
+        sm->temperature = read_i32( fin );
+
+        for( int j = 0; j < SEEY; j++ ) {
+            for( int i = 0; i < SEEX; i++ ) {
+                sm->ter[i][j] = read_id( fin, terrain_ids );
+            }
+        }
+        for( int j = 0; j < SEEY; j++ ) {
+            for( int i = 0; i < SEEX; i++ ) {
+                sm->frn[i][j] = read_id( fin, furniture_ids );
+            }
+        }
+
+        int rad_cell = 0;
+        while( rad_cell < SEEX * SEEY ) {
+            const int rad_strength = read_i32( fin );
+            const int rad_num = read_u16( fin );
+            if( rad_num == 0 || rad_cell + rad_num > SEEX * SEEY ) {
+                throw std::runtime_error( "invalid radiation run" );
+            }
+            for( int i = 0; i < rad_num; ++i, ++rad_cell ) {
+                sm->set_radiation( rad_cell % SEEX, rad_cell / SEEX, rad_strength );
+            }
+        }
+
+        for( uint16_t traps = read_u16( fin ); traps > 0; traps-- ) {
+            const point p = read_point( fin );
+            sm->trp[p.x][p.y] = read_id( fin, trap_ids );
+        }
+
+        for( uint16_t tiles = read_u16( fin ); tiles > 0; tiles-- ) {
+            const point p = read_point( fin );
+            for( uint8_t fields = read_u8( fin ); fields > 0; fields-- ) {
+                const int type = read_i32( fin );
+                const int density = read_i32( fin );
+                const int age = read_i32( fin );
+                if( type <= fd_null || type >= num_fields ) {
+                    throw std::runtime_error( "invalid field type" );
                 }
-            } else if( submap_member_name == "vehicles" ) {
-                jsin.start_array();
-                while( !jsin.end_array() ) {
-                    vehicle *tmp = new vehicle();
-                    jsin.read( *tmp );
-                    sm->vehicles.push_back( tmp );
+                if( sm->fld[p.x][p.y].findField( field_id( type ) ) == NULL ) {
+                    sm->field_count++;
                 }
-            } else if( submap_member_name == "computers" ) {
-                std::string computer_data = jsin.get_string();
-                std::unique_ptr<computer> new_comp( new computer( "BUGGED_COMPUTER", -100 ) );
-                new_comp->load_data( computer_data );
-                sm->comp.reset( new_comp.release() );
-            } else if( submap_member_name == "camp" ) {
-                std::string camp_data = jsin.get_string();
-                sm->camp.load_data( camp_data );
-            } else {
-                jsin.skip_value();
+                sm->fld[p.x][p.y].addField( field_id( type ), density, age );
             }
         }
+
+        for( uint16_t tiles = read_u16( fin ); tiles > 0; tiles-- ) {
+            const point p = read_point( fin );
+            std::istringstream blob( read_string( fin ) );
+            JsonIn jsin( blob );
+            deserialize_items( jsin, sm.get(), p.x, p.y );
+        }
+
+        std::istringstream blob( read_string( fin ) );
+        JsonIn jsin( blob );
+        deserialize_submap( jsin, sm.get() );
+        // The file has the current state of the submap.
+        sm->saved_generation = sm->modified_generation;
+
         if( !add_submap( submap_coordinates, sm ) ) {
             debugmsg( "submap %d,%d,%d was already loaded", submap_coordinates.x, submap_coordinates.y,
                       submap_coordinates.z );
@@ -2,14 +2,23 @@
 #ifndef MAPBUFFER_H
 #define MAPBUFFER_H
 
+#include <array>
+#include <iosfwd>
 #include <map>
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 #include "enums.h"
+#include "int_id.h"
 struct point;
 struct tripoint;
 struct submap;
+struct ter_t;
+using ter_id = int_id<ter_t>;
 
 /**
  * Store, buffer, save and load the entire world map.
@@ -25,8 +34,33 @@ class mapbuffer
         /** Store all submaps in this instance into savefiles.
          * @param delete_after_save If true, the saved submaps are removed
          * from the mapbuffer (and deleted).
+         * @param force_full_save If true, quads are written even if none of their submaps
+         * changed since they were loaded or last saved (see @ref submap::is_modified).
+         * @param in_background If true, the quads are only serialized and added to
+         * @ref background_saves, the caller starts writing them. Otherwise this waits
+         * until all files are written.
          **/
-        void save( bool delete_after_save = false );
+        void save( bool delete_after_save = false, bool force_full_save = false,
+                   bool in_background = false );
+        /**
+         * Call when writing the files of a save in the background failed, the next save
+         * writes all quads. Submaps removed by @ref evict are loaded again.
+         */
+        void write_failed();
+        /**
+         * Call when all files added to @ref background_saves so far were written, this
+         * deletes the submaps removed by @ref evict.
+         */
+        void write_confirmed();
+        /**
+         * If more submaps are loaded than the MAP_MEMORY_LIMIT option allows, the quads
+         * outside the main map that were looked up least recently are written in the
+         * background (see @ref background_saves) and removed. @ref lookup_submap loads them
+         * again. Call it only when no map but the main map holds submaps.
+         * The option is in MiB, but it's turned into a number of submaps by the size of
+         * an empty submap. Items, vehicles and the like are not counted.
+         */
+        void evict();
 
         /** Delete all buffered submaps. **/
         void reset();
@@ -46,6 +80,14 @@ class mapbuffer
         bool add_submap( const tripoint &p, std::unique_ptr<submap> &sm );
         bool add_submap( int x, int y, int z, submap *sm );
         bool add_submap( const tripoint &p, submap *sm );
+        /**
+         * Add a uniform submap that consists only of the given terrain. All those
+         * submaps with the same terrain share a single immutable instance, which is
+         * only copied into a real submap when it is about to be changed, see
+         * @ref lookup_submap and @ref lookup_shared_submap.
+         * @return Same as @ref add_submap.
+         */
+        bool add_uniform_submap( const tripoint &p, ter_id fill );
 
         /** Get a submap stored in this buffer.
          *
@@ -57,9 +99,32 @@ class mapbuffer
          */
         submap *lookup_submap( int x, int y, int z );
         submap *lookup_submap( const tripoint &p );
+        /**
+         * Same as @ref lookup_submap, but a submap added by @ref add_uniform_submap is
+         * returned as the shared instance instead of being copied into its own submap.
+         * Use this when the submap is only going to be read.
+         */
+        const submap *lookup_shared_submap( const tripoint &p );
+        /**
+         * Whether the submap is a shared instance of uniform submaps, those must not
+         * be changed. Call @ref lookup_submap to get a submap that can be changed.
+         */
+        bool is_shared( const submap *sm ) const;
+
+        /**
+         * Registers the submap at @p p as one that has vehicles, so that
+         * @ref vehicle_submaps returns it. Submaps that are added with vehicles are
+         * registered by @ref add_submap, maps register the submaps they put vehicles on.
+         */
+        void add_vehicle_submap( const tripoint &p );
+        /**
+         * The loaded submaps that have vehicles, with their positions. Submaps that were
+         * removed or lost their vehicles since they were registered are dropped.
+         */
+        std::vector<std::pair<tripoint, submap *>> vehicle_submaps();
 
     private:
-        typedef std::map<tripoint, submap *> submap_map_t;
+        typedef std::unordered_map<tripoint, submap *> submap_map_t;
 
     public:
         inline submap_map_t::iterator begin() {
@@ -73,12 +138,50 @@ class mapbuffer
         // There's a very good reason this is private,
         // if not handled carefully, this can erase in-use submaps and crash the game.
         void remove_submap( tripoint addr );
+        /** Removes the submap from @ref submaps without deleting it, the caller owns it. */
+        submap *release_submap( const tripoint &addr );
+        /** Takes the quad of @p p back from @ref evicted, returns whether it was there. */
+        bool restore_evicted( const tripoint &p );
         submap *unserialize_submaps( const tripoint &p );
+        /** Reads a quad file in the JSON format, which was used before the binary format. */
         void deserialize( JsonIn &jsin );
-        void save_quad( const std::string &dirname, const std::string &filename,
-                        const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
-                        bool delete_after_save );
+        /** Reads a quad file in the binary format, after its magic bytes. */
+        void deserialize_binary( std::istream &fin );
+        /** Reads a quad file in either format. */
+        void deserialize_quad( std::istream &fin );
+        /**
+         * Serializes a quad in the binary format into @p data: the magic bytes, the format
+         * version, the terrain, furniture and trap id dictionaries, and the submaps. Terrain
+         * and furniture are stored as arrays of dictionary indices, items and other rarely
+         * used data as length-prefixed JSON.
+         * @return false if the quad does not need to be saved.
+         */
+        bool save_quad( const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
+                        bool delete_after_save, bool force_full_save, std::string &data );
+        /** The submaps, in no particular order. @ref save writes them ordered by quad. */
         submap_map_t submaps;
+        /**
+         * The submaps found by the last calls of @ref lookup_submap, the most recent first,
+         * so that looking up the same few submaps again doesn't have to hash their position.
+         */
+        std::array<std::pair<tripoint, submap *>, 4> recent_lookups;
+        /** See @ref add_vehicle_submap. */
+        std::unordered_set<tripoint> vehicle_positions;
+        /** Counts lookups, see @ref submap::last_lookup. */
+        unsigned long lookups = 0;
+        /** Set by @ref write_failed. */
+        bool full_save_needed = false;
+        /**
+         * Submaps removed by @ref evict until their quads are known to be written, see
+         * @ref write_confirmed and @ref write_failed. @ref lookup_submap takes them back
+         * instead of reading the quad file. Members of the quads that were shared uniform
+         * submaps point into @ref uniform_submaps.
+         */
+        submap_map_t evicted;
+        /** Positions of uniform submaps that have not been copied yet, they point into @ref uniform_submaps. */
+        std::unordered_map<tripoint, const submap *> shared_submaps;
+        /** The shared instances of uniform submaps, one for each terrain. */
+        std::map<ter_id, std::unique_ptr<submap>> uniform_submaps;
 };
 
 extern mapbuffer MAPBUFFER;
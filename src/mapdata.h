@@ -2,6 +2,7 @@
 #ifndef MAPDATA_H
 #define MAPDATA_H
 
+#include "flag.h"
 #include "int_id.h"
 #include "string_id.h"
 #include "units.h"
@@ -193,7 +194,7 @@ struct map_data_common_t {
         std::string name_;
 
 private:
-    std::set<std::string> flags;    // string flags which possibly refer to what's documented above.
+    flag_set flags;    // string flags which possibly refer to what's documented above, by interned id.
     std::bitset<NUM_TERFLAGS> bitflags; // bitfield of -certian- string flags which are heavily checked
 
 public:
@@ -231,6 +232,11 @@ public:
         return flags.count(flag) > 0;
     }
 
+    /** Same as the string version, but without looking up the name, see @ref json_flag::intern. */
+    bool has_flag( const flag_int_id &flag ) const {
+        return flags.count( flag ) > 0;
+    }
+
     bool has_flag(const ter_bitflags flag) const {
         return bitflags.test( flag );
     }
@@ -97,6 +97,8 @@ void options_manager::add_value( const std::string &lvar, const std::string &lva
     }
 }
 
+unsigned long options_manager::generation_ = 1;
+
 options_manager::cOpt::cOpt()
 {
     sType = "VOID";
@@ -540,6 +542,7 @@ int options_manager::cOpt::getMaxLength() const
 //set to next item
 void options_manager::cOpt::setNext()
 {
+    changed();
     if (sType == "string_select") {
         int iNext = getItemPos(sSet) + 1;
         if (iNext >= (int)vItems.size()) {
@@ -584,6 +587,7 @@ void options_manager::cOpt::setNext()
 //set to prev item
 void options_manager::cOpt::setPrev()
 {
+    changed();
     if (sType == "string_select") {
         int iPrev = getItemPos(sSet) - 1;
         if (iPrev < 0) {
@@ -625,6 +629,7 @@ void options_manager::cOpt::setPrev()
 //set value
 void options_manager::cOpt::setValue(float fSetIn)
 {
+    changed();
     if (sType != "float") {
         debugmsg("tried to set a float value to a %s option", sType.c_str());
         return;
@@ -638,6 +643,7 @@ void options_manager::cOpt::setValue(float fSetIn)
 //set value
 void options_manager::cOpt::setValue( int iSetIn )
 {
+    changed();
     if( sType != "int" ) {
         debugmsg( "tried to set an int value to a %s option", sType.c_str() );
         return;
@@ -651,6 +657,7 @@ void options_manager::cOpt::setValue( int iSetIn )
 //set value
 void options_manager::cOpt::setValue(std::string sSetIn)
 {
+    changed();
     if (sType == "string_select") {
         if (getItemPos(sSetIn) != -1) {
             sSet = sSetIn;
@@ -888,6 +895,26 @@ void options_manager::init()
         0, 127, 5
         );
 
+    add( "SAVE_IN_BACKGROUND", "general", translate_marker( "Save in the background" ),
+        translate_marker( "If true, autosaves and quicksaves write the map files on a background thread, so the game continues while they are written." ),
+        true
+        );
+
+    add( "MAP_REGION_FILES", "general", translate_marker( "Pack map files" ),
+        translate_marker( "If true, the map is saved in one file per 32x32 overmap tiles instead of one file per overmap tile.  Existing map files are converted when they are saved again." ),
+        true
+        );
+
+    add( "MAP_MEMORY_LIMIT", "general", translate_marker( "Map memory limit" ),
+        translate_marker( "Rough amount of memory (in MiB) that loaded map data may use.  It is turned into a number of submaps by the size of an empty submap, so items, vehicles and monsters come on top of it.  When it is exceeded, the areas away from the player that were used least recently are saved and unloaded, they are loaded again when needed.  0 keeps them until the game is saved." ),
+        0, 4096, 256
+        );
+
+    add( "OVERMAP_PREFETCH_DISTANCE", "general", translate_marker( "Overmap prefetch distance" ),
+        translate_marker( "When the player gets this close (in overmap tiles) to the edge of an overmap, the neighbouring overmap is loaded or generated in the background.  0 disables background loading." ),
+        0, OMAPX / 2, 30
+        );
+
     mOptionsSort["general"]++;
 
     add( "CIRCLEDIST", "general", translate_marker( "Circular distances" ),
@@ -1297,6 +1324,11 @@ void options_manager::init()
         true
         );
 
+    add( "SAVE_UNCHANGED_MAP", "debug", translate_marker( "Save unchanged map" ),
+        translate_marker( "If true, saving writes all loaded map data, not just the parts that changed since they were loaded.  Use it to rewrite map files that were damaged or deleted." ),
+        false
+        );
+
     ////////////////////////////WORLD DEFAULT////////////////////
     add( "CORE_VERSION", "world_default", translate_marker( "Core version data" ),
         translate_marker( "Controls what migrations are applied for legacy worlds" ),
@@ -1518,6 +1550,7 @@ void options_manager::init()
             bLastLineEmpty = bThisLineEmpty;
         }
     }
+    changed();
 }
 
 #ifdef TILES
@@ -1912,6 +1945,8 @@ std::string options_manager::show(bool ingame, const bool world_options_only)
                 ACTIVE_WORLD_OPTIONS = WOPTIONS_OLD;
             }
         }
+        // The copies above were assigned without going through setValue.
+        changed();
     }
     if( lang_changed ) {
         set_language();
@@ -163,6 +163,18 @@ class options_manager : public JsonSerializer, public JsonDeserializer
         /** Check if an option exists? */
         bool has_option( const std::string &name ) const;
 
+        /**
+         * Counts the changes to any option value, including switching the active world.
+         * @ref cached_option compares it to the count it has seen to know when to look again.
+         */
+        static unsigned long generation() {
+            return generation_;
+        }
+        /** Invalidates all @ref cached_option values. */
+        static void changed() {
+            generation_++;
+        }
+
         cOpt &get_option( const std::string &name );
 
         //add string select option
@@ -205,6 +217,8 @@ class options_manager : public JsonSerializer, public JsonDeserializer
                   const std::string &format = "%.2f" );
 
     private:
+        static unsigned long generation_;
+
         options_container options;
         // first is page id, second is untranslated page name
         std::vector<std::pair<std::string, std::string>> vPages;
@@ -233,4 +247,34 @@ inline T get_option( const std::string &name )
     return get_options().get_option( name ).value_as<T>();
 }
 
+/**
+ * Typed handle to an option that is read often (each turn or each frame).
+ * The first read after any option changed looks it up like @ref get_option,
+ * the reads after that only return the stored value.
+ * Usually a function local static: `static const cached_option<bool> autosave( "AUTOSAVE" );`
+ */
+template<typename T>
+class cached_option
+{
+    public:
+        explicit cached_option( const std::string &name ) : name( name ) {}
+
+        const T &get() const {
+            if( seen_generation != options_manager::generation() ) {
+                value = get_option<T>( name );
+                seen_generation = options_manager::generation();
+            }
+            return value;
+        }
+        operator T() const {
+            return get();
+        }
+
+    private:
+        std::string name;
+        mutable T value = T();
+        // The option manager starts counting at 1, so the first read always looks it up.
+        mutable unsigned long seen_generation = 0;
+};
+
 #endif
@@ -1,5 +1,6 @@
 #include "overmap.h"
 
+#include "background_writer.h"
 #include "coordinate_conversions.h"
 #include "generic_factory.h"
 #include "overmap_types.h"
@@ -78,7 +79,10 @@ oter_id  ot_null,
          ot_forest,
          ot_forest_thick,
          ot_forest_water,
-         ot_river_center;
+         ot_river_center,
+         ot_open_air,
+         ot_empty_rock,
+         ot_road_nesw_manhole;
 
 
 const oter_type_t oter_type_t::null_type;
@@ -309,6 +313,11 @@ void set_oter_ids()   // fixme constify
     ot_forest_thick = oter_id( "forest_thick" );
     ot_forest_water = oter_id( "forest_water" );
     ot_river_center = oter_id( "river_center" );
+    // Resolved here and not in the functions that use them, as those may run on the
+    // overmap generation threads.
+    ot_open_air     = oter_id( "open_air" );
+    ot_empty_rock   = oter_id( "empty_rock" );
+    ot_road_nesw_manhole = oter_id( "road_nesw_manhole" );
 }
 
 void overmap_specials::load( JsonObject &jo, const std::string &src )
@@ -561,8 +570,7 @@ bool oter_t::type_is( const oter_type_t &type ) const
 bool oter_t::has_connection( om_direction::type dir ) const
 {
     // @todo It's a DAMN UGLY hack. Remove it as soon as possible.
-    static const oter_str_id road_manhole( "road_nesw_manhole" );
-    if( id == road_manhole ) {
+    if( id == ot_road_nesw_manhole.id() ) {
         return true;
     }
     return om_lines::has_segment( line, dir );
@@ -1161,6 +1169,10 @@ overmap::overmap( int const x, int const y ) : loc( x, y )
         debugmsg("overmap(%d,%d): can't find region '%s'", x, y, rsettings_id.c_str() ); // gonna die now =[
     }
     settings = rsit->second;
+    city_size = get_option<int>( "CITY_SIZE" );
+    city_spacing = get_option<int>( "CITY_SPACING" );
+    classic_zombies = get_option<bool>( "CLASSIC_ZOMBIES" );
+    wander_spawns = get_option<bool>( "WANDER_SPAWNS" );
 
     init_layers();
 }
@@ -1200,7 +1212,8 @@ void overmap::init_layers()
 oter_id &overmap::ter(const int x, const int y, const int z)
 {
     if( !inbounds( x, y, z ) ) {
-        return ot_null;
+        nullter = ot_null;
+        return nullter;
     }
 
     return layer[z + OVERMAP_DEPTH].terrain[x][y];
@@ -1472,9 +1485,28 @@ void overmap::set_scent( const tripoint &loc, scent_trace &new_scent )
     scents[loc] = new_scent;
 }
 
-void overmap::generate( const overmap *north, const overmap *east,
-                        const overmap *south, const overmap *west,
-                        overmap_special_batch &enabled_specials )
+overmap_border overmap::get_border( const om_direction::type side ) const
+{
+    overmap_border result;
+    const bool vertical = side == om_direction::type::east || side == om_direction::type::west;
+    const int length = vertical ? OMAPY : OMAPX;
+    const int edge = side == om_direction::type::east ? OMAPX - 1 :
+                     side == om_direction::type::south ? OMAPY - 1 : 0;
+    result.river.resize( length );
+    for( int i = 0; i < length; i++ ) {
+        result.river[i] = is_river( vertical ? get_ter( edge, i, 0 ) : get_ter( i, edge, 0 ) );
+    }
+    for( const auto &road : roads_out ) {
+        if( ( vertical ? road.x : road.y ) == edge ) {
+            result.roads.push_back( vertical ? road.y : road.x );
+        }
+    }
+    return result;
+}
+
+void overmap::generate( const overmap_border *north, const overmap_border *east,
+                        const overmap_border *south, const overmap_border *west,
+                        overmap_special_batch &enabled_specials, const bool place_overflow )
 {
     dbg(D_INFO) << "overmap::generate start...";
     std::vector<point> river_start;// West/North endpoints of rivers
@@ -1484,85 +1516,73 @@ void overmap::generate( const overmap *north, const overmap *east,
     const oter_id river_center("river_center"); // optimized comparison.
 
     if (north != NULL) {
+        const std::vector<bool> &river = north->river;
         for (int i = 2; i < OMAPX - 2; i++) {
-            if (is_river(north->get_ter(i, OMAPY - 1, 0))) {
+            if (river[i]) {
                 ter(i, 0, 0) = river_center;
             }
-            if (is_river(north->get_ter(i, OMAPY - 1, 0)) &&
-                is_river(north->get_ter(i - 1, OMAPY - 1, 0)) &&
-                is_river(north->get_ter(i + 1, OMAPY - 1, 0))) {
+            if (river[i] && river[i - 1] && river[i + 1]) {
                 if (river_start.empty() ||
                     river_start[river_start.size() - 1].x < i - 6) {
                     river_start.push_back(point(i, 0));
                 }
             }
         }
-        for (auto &i : north->roads_out) {
-            if (i.y == OMAPY - 1) {
-                roads_out.push_back(city(i.x, 0, 0));
-            }
+        for( int i : north->roads ) {
+            roads_out.push_back( city( i, 0, 0 ) );
         }
     }
     size_t rivers_from_north = river_start.size();
     if (west != NULL) {
+        const std::vector<bool> &river = west->river;
         for (int i = 2; i < OMAPY - 2; i++) {
-            if (is_river(west->get_ter(OMAPX - 1, i, 0))) {
+            if (river[i]) {
                 ter(0, i, 0) = river_center;
             }
-            if (is_river(west->get_ter(OMAPX - 1, i, 0)) &&
-                is_river(west->get_ter(OMAPX - 1, i - 1, 0)) &&
-                is_river(west->get_ter(OMAPX - 1, i + 1, 0))) {
+            if (river[i] && river[i - 1] && river[i + 1]) {
                 if (river_start.size() == rivers_from_north ||
                     river_start[river_start.size() - 1].y < i - 6) {
                     river_start.push_back(point(0, i));
                 }
             }
         }
-        for (auto &i : west->roads_out) {
-            if (i.x == OMAPX - 1) {
-                roads_out.push_back(city(0, i.y, 0));
-            }
+        for( int i : west->roads ) {
+            roads_out.push_back( city( 0, i, 0 ) );
         }
     }
     if (south != NULL) {
+        const std::vector<bool> &river = south->river;
         for (int i = 2; i < OMAPX - 2; i++) {
-            if (is_river(south->get_ter(i, 0, 0))) {
+            if (river[i]) {
                 ter(i, OMAPY - 1, 0) = river_center;
             }
-            if (is_river(south->get_ter(i,     0, 0)) &&
-                is_river(south->get_ter(i - 1, 0, 0)) &&
-                is_river(south->get_ter(i + 1, 0, 0))) {
+            if (river[i] && river[i - 1] && river[i + 1]) {
                 if (river_end.empty() ||
                     river_end[river_end.size() - 1].x < i - 6) {
                     river_end.push_back(point(i, OMAPY - 1));
                 }
             }
         }
-        for (auto &i : south->roads_out) {
-            if (i.y == 0) {
-                roads_out.push_back(city(i.x, OMAPY - 1, 0));
-            }
+        for( int i : south->roads ) {
+            roads_out.push_back( city( i, OMAPY - 1, 0 ) );
         }
     }
     size_t rivers_to_south = river_end.size();
     if (east != NULL) {
+        const std::vector<bool> &river = east->river;
         for (int i = 2; i < OMAPY - 2; i++) {
-            if (is_river(east->get_ter(0, i, 0))) {
+            if (river[i]) {
                 ter(OMAPX - 1, i, 0) = river_center;
             }
-            if (is_river(east->get_ter(0, i, 0)) &&
-                is_river(east->get_ter(0, i - 1, 0)) &&
-                is_river(east->get_ter(0, i + 1, 0))) {
+            if (river[i] && river[i - 1] && river[i + 1]) {
                 if (river_end.size() == rivers_to_south ||
                     river_end[river_end.size() - 1].y < i - 6) {
                     river_end.push_back(point(OMAPX - 1, i));
                 }
             }
         }
-        for (auto &i : east->roads_out) {
-            if (i.x == 0) {
-                roads_out.push_back(city(OMAPX - 1, i.y, 0));
-            }
+        for( int i : east->roads ) {
+            roads_out.push_back( city( OMAPX - 1, i, 0 ) );
         }
     }
 
@@ -1685,7 +1705,7 @@ void overmap::generate( const overmap *north, const overmap *east,
     const string_id<overmap_connection> local_road( "local_road" );
     connect_closest_points( road_points, 0, *local_road );
 
-    place_specials( enabled_specials );
+    place_specials( enabled_specials, place_overflow );
     polish_river();
 
     // TODO: there is no reason we can't generate the sublevels in one pass
@@ -1787,8 +1807,10 @@ bool overmap::generate_sub(int const z)
                 // but at this point we don't know
                 requires_sub = true;
             } else if( oter_above == "mine_finale" ) {
-                for( auto &p : g->m.points_in_radius( tripoint( i, j, z ), 1, 0 ) ) {
-                    ter( p.x, p.y, p.z ) = oter_id( "spiral" );
+                for( int x = std::max( i - 1, 0 ); x <= std::min( i + 1, OMAPX - 1 ); x++ ) {
+                    for( int y = std::max( j - 1, 0 ); y <= std::min( j + 1, OMAPY - 1 ); y++ ) {
+                        ter( x, y, z ) = oter_id( "spiral" );
+                    }
                 }
                 ter( i, j, z ) = oter_id( "spiral_hub" );
                 add_mon_group( mongroup( mongroup_id( "GROUP_SPIRAL" ), i * 2, j * 2, z, 2, 200 ) );
@@ -2250,7 +2272,7 @@ void overmap::draw(WINDOW *w, WINDOW *wbar, const tripoint &center,
                     }
                 }
                 // Highlight areas that already have been generated
-                if( MAPBUFFER.lookup_submap(
+                if( MAPBUFFER.lookup_shared_submap(
                         omt_to_sm_copy( tripoint( omx, omy, z ) ) ) ) {
                     ter_color = red_background( ter_color );
                 }
@@ -3026,7 +3048,8 @@ void overmap::move_hordes()
     zg.insert( tmpzg.begin(), tmpzg.end() );
 
 
-    if(get_option<bool>( "WANDER_SPAWNS" ) ) {
+    static const cached_option<bool> wander_spawns_enabled( "WANDER_SPAWNS" );
+    if( wander_spawns_enabled ) {
         static const mongroup_id GROUP_ZOMBIE("GROUP_ZOMBIE");
 
         // Re-absorb zombies into hordes.
@@ -3310,11 +3333,11 @@ spawns happen at... <cue Clue music>
 20:56 <kevingranade>: game:pawn_mon() in game.cpp:7380*/
 void overmap::place_cities()
 {
-    int op_city_size = get_option<int>( "CITY_SIZE" );
+    int op_city_size = city_size;
     if( op_city_size <= 0 ) {
         return;
     }
-    int op_city_spacing = get_option<int>( "CITY_SPACING" );
+    int op_city_spacing = city_spacing;
 
     // spacing dictates how much of the map is covered in cities
     //   city  |  cities  |   size N cities per overmap
@@ -3391,20 +3414,18 @@ building_size overmap::find_max_size( const tripoint &center, const building_siz
 
     tripoint current = center;
     ret.height = 0;
-    static const oter_str_id open_air( "open_air" );
     while( ret.height < limits.height ) {
         current.z++;
-        if( get_ter( current ) != open_air ) {
+        if( get_ter( current ) != ot_open_air ) {
             break;
         }
         ret.height++;
     }
     current.z = center.z;
     ret.depth = 0;
-    static const oter_str_id empty_rock( "empty_rock" );
     while( ret.depth < limits.depth ) {
         current.z--;
-        if( get_ter( current ) != empty_rock ) {
+        if( get_ter( current ) != ot_empty_rock ) {
             break;
         }
         ret.depth++;
@@ -3631,7 +3652,8 @@ void overmap::build_anthill(int x, int y, int z, int s)
 
 void overmap::build_tunnel( int x, int y, int z, int s, om_direction::type dir )
 {
-    if (s <= 0) {
+    // Tunnels leaving the overmap end at its edge, the terrain there can't be changed.
+    if( s <= 0 || !inbounds( x, y, z ) ) {
         return;
     }
 
@@ -4221,7 +4243,7 @@ om_direction::type overmap::random_special_rotation( const overmap_special &spec
         }
     }
     // Pick first valid rotation at random.
-    std::random_shuffle( first, last );
+    std::random_shuffle( first, last, rng_index );
     const auto rotation = find_if( first, last, [&]( om_direction::type r ) {
         for( const auto &elem : special.terrains ) {
             const tripoint rp = p + om_direction::rotate( elem.p, r );
@@ -4289,7 +4311,7 @@ std::vector<point> overmap::get_sectors() const
             res.emplace_back( x, y );
         }
     }
-    std::random_shuffle( res.begin(), res.end() );
+    std::random_shuffle( res.begin(), res.end(), rng_index );
     return res;
 }
 
@@ -4302,7 +4324,7 @@ bool overmap::place_special_attempt( overmap_special_batch &enabled_specials,
     const tripoint p( rng( x, x + OMSPEC_FREQ - 1 ), rng( y, y + OMSPEC_FREQ - 1 ), 0 );
     const city &nearest_city = get_nearest_city( p );
 
-    std::random_shuffle( enabled_specials.begin(), enabled_specials.end() );
+    std::random_shuffle( enabled_specials.begin(), enabled_specials.end(), rng_index );
     for( auto iter = enabled_specials.begin(); iter != enabled_specials.end(); ++iter ) {
         const auto &special = *iter->special_details;
         // If we haven't finished placing minimum instances of all specials,
@@ -4336,7 +4358,7 @@ void overmap::place_specials_pass( overmap_special_batch &enabled_specials,
                                    std::vector<point> &sectors, const bool place_optional )
 {
     // Walk over sectors in random order, to minimize "clumping".
-    std::random_shuffle( sectors.begin(), sectors.end() );
+    std::random_shuffle( sectors.begin(), sectors.end(), rng_index );
     for( auto it = sectors.begin(); it != sectors.end(); ) {
         const size_t attempts = 10;
         bool placed = false;
@@ -4361,7 +4383,7 @@ void overmap::place_specials_pass( overmap_special_batch &enabled_specials,
 // check if special is valid  pick & place special.
 // When a sector is populated it's removed from the list,
 // and when a special reaches max instances it is also removed.
-void overmap::place_specials( overmap_special_batch &enabled_specials )
+void overmap::place_specials( overmap_special_batch &enabled_specials, const bool place_overflow )
 {
 
     for( auto iter = enabled_specials.begin(); iter != enabled_specials.end(); ) {
@@ -4388,45 +4410,53 @@ void overmap::place_specials( overmap_special_batch &enabled_specials )
 
     // First insure that all minimum instance counts are met.
     place_specials_pass( enabled_specials, sectors, false );
-    if( std::any_of( enabled_specials.begin(), enabled_specials.end(),
-                     []( overmap_special_placement placement ) {
-                         return placement.instances_placed <
-                                placement.special_details->occurrences.min;
-                     } ) ) {
-        // Randomly select from among the nearest uninitialized overmap positions.
-        int previous_distance = 0;
-        std::vector<point> nearest_candidates;
-        // Since this starts at enabled_specials::origin, it will only place new overmaps
-        // in the 5x5 area surrounding the initial overmap, bounding the amount of work we will do.
-        for( point candidate_addr : closest_points_first( 2, enabled_specials.get_origin() ) ) {
-            if( !overmap_buffer.has( candidate_addr.x, candidate_addr.y ) ) {
-                int current_distance = square_dist( pos().x, pos().y,
-                                                    candidate_addr.x, candidate_addr.y );
-                if( nearest_candidates.empty() || current_distance == previous_distance ) {
-                    nearest_candidates.push_back( candidate_addr );
-                    previous_distance = current_distance;
-                } else {
-                    break;
-                }
-            }
-        }
-        if( !nearest_candidates.empty() ) {
-            std::random_shuffle( nearest_candidates.begin(), nearest_candidates.end() );
-            point new_om_addr = nearest_candidates.front();
-            overmap_buffer.create_custom_overmap( new_om_addr.x, new_om_addr.y, enabled_specials );
-        } else {
-            add_msg( _( "Unable to place all configured specials, some missions may fail to initialize." ) );
-        }
+    if( place_overflow ) {
+        place_specials_overflow( enabled_specials );
     }
     // Then fill in non-mandatory specials.
     place_specials_pass( enabled_specials, sectors, true );
 }
 
+void overmap::place_specials_overflow( overmap_special_batch &enabled_specials )
+{
+    if( std::none_of( enabled_specials.begin(), enabled_specials.end(),
+                      []( overmap_special_placement placement ) {
+                          return placement.instances_placed <
+                                 placement.special_details->occurrences.min;
+                      } ) ) {
+        return;
+    }
+    // Randomly select from among the nearest uninitialized overmap positions.
+    int previous_distance = 0;
+    std::vector<point> nearest_candidates;
+    // Since this starts at enabled_specials::origin, it will only place new overmaps
+    // in the 5x5 area surrounding the initial overmap, bounding the amount of work we will do.
+    for( point candidate_addr : closest_points_first( 2, enabled_specials.get_origin() ) ) {
+        if( !overmap_buffer.has( candidate_addr.x, candidate_addr.y ) ) {
+            int current_distance = square_dist( pos().x, pos().y,
+                                                candidate_addr.x, candidate_addr.y );
+            if( nearest_candidates.empty() || current_distance == previous_distance ) {
+                nearest_candidates.push_back( candidate_addr );
+                previous_distance = current_distance;
+            } else {
+                break;
+            }
+        }
+    }
+    if( !nearest_candidates.empty() ) {
+        std::random_shuffle( nearest_candidates.begin(), nearest_candidates.end(), rng_index );
+        point new_om_addr = nearest_candidates.front();
+        overmap_buffer.create_custom_overmap( new_om_addr.x, new_om_addr.y, enabled_specials );
+    } else {
+        add_msg( _( "Unable to place all configured specials, some missions may fail to initialize." ) );
+    }
+}
+
 void overmap::place_mongroups()
 {
     // Cities are full of zombies
     for( auto &elem : cities ) {
-        if( get_option<bool>( "WANDER_SPAWNS" ) ) {
+        if( wander_spawns ) {
             if( !one_in( 16 ) || elem.s > 5 ) {
                 mongroup m( mongroup_id( "GROUP_ZOMBIE" ), ( elem.x * 2 ), ( elem.y * 2 ), 0, int( elem.s * 2.5 ),
                             elem.s * 80 );
@@ -4438,7 +4468,7 @@ void overmap::place_mongroups()
         }
     }
 
-    if (!get_option<bool>( "CLASSIC_ZOMBIES" ) ) {
+    if( !classic_zombies ) {
         // Figure out where swamps are, and place swamp monsters
         for (int x = 3; x < OMAPX - 3; x += 7) {
             for (int y = 3; y < OMAPY - 3; y += 7) {
@@ -4457,7 +4487,7 @@ void overmap::place_mongroups()
         }
     }
 
-    if (!get_option<bool>( "CLASSIC_ZOMBIES" ) ) {
+    if( !classic_zombies ) {
         // Figure out where rivers are, and place swamp monsters
         for (int x = 3; x < OMAPX - 3; x += 7) {
             for (int y = 3; y < OMAPY - 3; y += 7) {
@@ -4476,7 +4506,7 @@ void overmap::place_mongroups()
         }
     }
 
-    if (!get_option<bool>( "CLASSIC_ZOMBIES" ) ) {
+    if( !classic_zombies ) {
         // Place the "put me anywhere" groups
         int numgroups = rng(0, 3);
         for (int i = 0; i < numgroups; i++) {
@@ -4532,23 +4562,25 @@ void overmap::open( overmap_special_batch &enabled_specials )
 {
     std::string const plrfilename = overmapbuffer::player_filename(loc.x, loc.y);
     std::string const terfilename = overmapbuffer::terrain_filename(loc.x, loc.y);
+    // The files may still be written by the last save.
+    background_saves.wait_for( terfilename );
+    background_saves.wait_for( plrfilename );
 
     using namespace std::placeholders;
     if( read_from_file_optional( terfilename, std::bind( &overmap::unserialize, this, _1 ) ) ) {
         read_from_file_optional( plrfilename, std::bind( &overmap::unserialize_view, this, _1 ) );
     } else { // No map exists!  Prepare neighbors, and generate one.
-        std::vector<const overmap*> pointers;
-        // Fetch south and north
-        for (int i = -1; i <= 1; i += 2) {
-            pointers.push_back(overmap_buffer.get_existing(loc.x, loc.y+i));
-        }
-        // Fetch east and west
-        for (int i = -1; i <= 1; i += 2) {
-            pointers.push_back(overmap_buffer.get_existing(loc.x+i, loc.y));
+        std::array<std::unique_ptr<overmap_border>, 4> borders;
+        for( size_t i = 0; i < om_direction::size; i++ ) {
+            const om_direction::type dir = om_direction::all[i];
+            const point offset = om_direction::displace( dir );
+            if( const overmap *const neighbour = overmap_buffer.get_existing( loc.x + offset.x,
+                                                 loc.y + offset.y ) ) {
+                borders[i].reset( new overmap_border( neighbour->get_border( om_direction::opposite( dir ) ) ) );
+            }
         }
-
-        // pointers looks like (north, south, west, east)
-        generate( pointers[0], pointers[3], pointers[1], pointers[2], enabled_specials );
+        generate( borders[0].get(), borders[1].get(), borders[2].get(), borders[3].get(),
+                  enabled_specials );
     }
 }
 
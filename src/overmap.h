@@ -203,7 +203,7 @@ struct radio_tower {
  int frequency;
 radio_tower(int X = -1, int Y = -1, int S = -1, std::string M = "",
             radio_type T = MESSAGE_BROADCAST) :
-    x (X), y (Y), strength (S), type (T), message (M) {frequency = rand();}
+    x (X), y (Y), strength (S), type (T), message (M) {frequency = rng_rand();}
 };
 
 struct map_layer {
@@ -253,6 +253,18 @@ class overmap_special_batch {
     point origin_overmap;
 };
 
+/**
+ * The edge of an overmap that a newly generated neighbour stitches its rivers and roads
+ * to, see @ref overmap::get_border. Small enough to be handed to a generating thread
+ * instead of the whole neighbour.
+ */
+struct overmap_border {
+    /** Whether each tile along the edge (on z-level 0) is a river. */
+    std::vector<bool> river;
+    /** Positions along the edge where roads leave the overmap. */
+    std::vector<int> roads;
+};
+
 class overmap
 {
  public:
@@ -383,6 +395,9 @@ class overmap
     // Returns a batch of the default enabled specials.
     overmap_special_batch get_enabled_specials() const;
 
+    /** Returns the edge of this overmap that faces @p side. */
+    overmap_border get_border( om_direction::type side ) const;
+
     void clear_mon_groups();
 private:
     std::multimap<tripoint, mongroup> zg;
@@ -418,6 +433,8 @@ public:
         std::vector<std::shared_ptr<npc>> npcs;
 
     bool nullbool = false;
+    /** Returned by @ref ter for points outside the overmap, so writes to them are dropped. */
+    oter_id nullter;
     point loc{ 0, 0 };
 
     std::array<map_layer, OVERMAP_LAYERS> layer;
@@ -431,6 +448,14 @@ public:
      */
     std::unordered_multimap<tripoint, monster> monster_map;
     regional_settings settings;
+    /**
+     * Options used by generation. They are read by the constructor, which runs on the
+     * main thread, as generation may run on a background thread.
+     */
+    int city_size = 0;
+    int city_spacing = 0;
+    bool classic_zombies = false;
+    bool wander_spawns = false;
 
     // Initialise
     void init_layers();
@@ -449,9 +474,18 @@ public:
   void unserialize_legacy(std::istream &fin);
   void unserialize_view_legacy(std::istream &fin);
  private:
-    void generate( const overmap* north, const overmap* east,
-                   const overmap* south, const overmap* west,
-                   overmap_special_batch &enabled_specials );
+    /**
+     * Generate a new overmap, stitching rivers and roads to the borders of the given
+     * neighbours (any of which may be null, see @ref get_border). Only touches this
+     * overmap and data that is not changed after loading, so it may run on a background
+     * thread.
+     * @param place_overflow Whether mandatory specials that did not fit should be moved
+     * into a new nearby overmap right away. Background generation passes false and
+     * calls @ref place_specials_overflow once the overmap is back on the main thread.
+     */
+    void generate( const overmap_border *north, const overmap_border *east,
+                   const overmap_border *south, const overmap_border *west,
+                   overmap_special_batch &enabled_specials, bool place_overflow = true );
     bool generate_sub( int const z );
 
     const city &get_nearest_city( const tripoint &p ) const;
@@ -540,8 +574,14 @@ public:
      * If the stated minimums are not reached, it will spawn a new nearby overmap
      * and continue placing specials there.
      * @param enabled_specials specifies what specials to place, and tracks how many have been placed.
+     * @param place_overflow if false, the new nearby overmap is not spawned, see @ref place_specials_overflow.
+     **/
+    void place_specials( overmap_special_batch &enabled_specials, bool place_overflow = true );
+    /**
+     * Spawns a new nearby overmap for the specials whose minimum count has not been reached.
+     * This creates overmaps through @ref overmap_buffer and must run on the main thread.
      **/
-    void place_specials( overmap_special_batch &enabled_specials );
+    void place_specials_overflow( overmap_special_batch &enabled_specials );
     /**
      * Walk over the overmap and attempt to place specials.
      * @param enabled_specials vector of objects that track specials being placed.
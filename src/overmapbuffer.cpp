@@ -1,4 +1,5 @@
 #include "overmapbuffer.h"
+#include "background_writer.h"
 #include "coordinate_conversions.h"
 #include "overmap_connection.h"
 #include "overmap_types.h"
@@ -17,19 +18,94 @@
 #include "vehicle.h"
 #include "filesystem.h"
 #include "cata_utility.h"
+#include "options.h"
+#include "rng.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <fstream>
 #include <sstream>
 #include <stdlib.h>
+#include <system_error>
+#include <thread>
+#if (defined _WIN32 || defined WINDOWS) && !defined _MSC_VER
+#   include "mingw.thread.h"
+#endif
 
 overmapbuffer overmap_buffer;
 
+/**
+ * An overmap that is prepared by a worker thread. The worker only touches the members
+ * of this object, everything that needs the rest of the game state (options, the
+ * active world, neighbouring overmaps) is looked up by the main thread beforehand,
+ * and everything that changes it (npcs, monster groups, new overmaps for leftover
+ * specials) is done by @ref overmapbuffer::finish_pending.
+ */
+struct pending_overmap {
+    pending_overmap( const point &p ) : specials( p ), done( false ) {}
+    ~pending_overmap() {
+        if( worker.joinable() ) {
+            worker.join();
+        }
+    }
+
+    std::unique_ptr<overmap> om;
+    overmap_special_batch specials;
+    /**
+     * Borders of the neighbours (north, east, south, west) the new overmap is stitched
+     * to, so the main thread can keep modifying the neighbours.
+     */
+    std::array<std::unique_ptr<overmap_border>, 4> neighbours;
+    /** Whether the overmap exists on disk and is only read, not generated. */
+    bool from_file = false;
+    std::string terrain_filename;
+    std::string player_filename;
+    /** Raw file contents, parsed on the main thread (loading npcs needs the game state). */
+    std::string terrain_data;
+    std::string player_data;
+    /** Error from the worker, reported on the main thread. */
+    std::string error;
+    /** Seed of the workers random generator, see @ref rng_thread_seed. */
+    unsigned int seed = 0;
+    std::atomic<bool> done;
+    std::thread worker;
+};
+
+/** Reads the whole file, returns false if it does not exist. Throws on read errors. */
+static bool read_whole_file( const std::string &path, std::string &data )
+{
+    std::ifstream fin( path, std::ios::binary );
+    if( !fin ) {
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << fin.rdbuf();
+    if( fin.bad() ) {
+        throw std::runtime_error( "reading file \"" + path + "\" failed" );
+    }
+    data = buffer.str();
+    return true;
+}
+
 overmapbuffer::overmapbuffer()
 : last_requested_overmap( nullptr )
 {
 }
 
+// Defined here because pending_overmap is incomplete in the header.
+overmapbuffer::~overmapbuffer() = default;
+
+bool overmap_handle::ready() const
+{
+    return buffer->is_ready( p.x, p.y );
+}
+
+overmap &overmap_handle::get() const
+{
+    return buffer->get( p.x, p.y );
+}
+
 const city_reference city_reference::invalid{ nullptr, tripoint(), -1 };
 
 int city_reference::get_distance_from_bounds() const {
@@ -69,6 +145,9 @@ overmap &overmapbuffer::get( const int x, const int y )
     if( it != overmaps.end() ) {
         return *( last_requested_overmap = it->second.get() );
     }
+    if( pending.count( p ) > 0 ) {
+        return *( last_requested_overmap = &finish_pending( p ) );
+    }
 
     // That constructor loads an existing overmap or creates a new one.
     overmap *new_om = new overmap( x, y );
@@ -83,8 +162,251 @@ overmap &overmapbuffer::get( const int x, const int y )
     return *new_om;
 }
 
+overmap_handle overmapbuffer::request( const int x, const int y )
+{
+    const point p( x, y );
+    if( overmaps.count( p ) == 0 && pending.count( p ) == 0 ) {
+        start_pending( p, rand() );
+    }
+    return overmap_handle( *this, p );
+}
+
+bool overmapbuffer::is_ready( const int x, const int y ) const
+{
+    const point p( x, y );
+    if( overmaps.count( p ) > 0 ) {
+        return true;
+    }
+    const auto it = pending.find( p );
+    return it != pending.end() && it->second->done;
+}
+
+void overmapbuffer::prefetch_near( const tripoint &center )
+{
+    // Collect first, finishing one job may finish others (via fix_mongroups etc.).
+    std::vector<point> finished;
+    for( const auto &job : pending ) {
+        if( job.second->done ) {
+            finished.push_back( job.first );
+        }
+    }
+    for( const point &p : finished ) {
+        if( pending.count( p ) > 0 ) {
+            finish_pending( p );
+        }
+    }
+
+    const int distance = get_option<int>( "OVERMAP_PREFETCH_DISTANCE" );
+    if( distance <= 0 ) {
+        return;
+    }
+    point local( center.x, center.y );
+    const point om_pos = omt_to_om_remain( local );
+    const int dx = local.x < distance ? -1 : local.x >= OMAPX - distance ? 1 : 0;
+    const int dy = local.y < distance ? -1 : local.y >= OMAPY - distance ? 1 : 0;
+    // Orthogonal neighbours first, the diagonal one is stitched to them.
+    std::vector<point> wanted;
+    if( dx != 0 ) {
+        wanted.emplace_back( om_pos.x + dx, om_pos.y );
+    }
+    if( dy != 0 ) {
+        wanted.emplace_back( om_pos.x, om_pos.y + dy );
+    }
+    if( dx != 0 && dy != 0 ) {
+        wanted.emplace_back( om_pos.x + dx, om_pos.y + dy );
+    }
+    for( const point &p : wanted ) {
+        request( p.x, p.y );
+    }
+}
+
+bool overmapbuffer::start_pending( const point &p, const unsigned int seed )
+{
+    std::unique_ptr<pending_overmap> job( new pending_overmap( p ) );
+    job->seed = seed;
+    job->terrain_filename = terrain_filename( p.x, p.y );
+    job->player_filename = player_filename( p.x, p.y );
+    // The files may still be written by the last save.
+    background_saves.wait_for( job->terrain_filename );
+    background_saves.wait_for( job->player_filename );
+    job->from_file = file_exist( job->terrain_filename );
+    if( !job->from_file ) {
+        // Same neighbours as overmap::open uses, in the order overmap::generate expects.
+        for( size_t i = 0; i < om_direction::size; ++i ) {
+            const om_direction::type dir = om_direction::all[i];
+            const point np = p + om_direction::displace( dir );
+            if( pending.count( np ) > 0 ) {
+                // The neighbour is not yet known, generating now would not stitch rivers
+                // and roads to it. Try again on the next request.
+                return false;
+            }
+            if( overmap *const neighbour = get_existing( np.x, np.y ) ) {
+                job->neighbours[i].reset( new overmap_border(
+                                              neighbour->get_border( om_direction::opposite( dir ) ) ) );
+            }
+        }
+        job->specials = overmap_specials::get_default_batch( p );
+    }
+    // The constructor looks up the region settings and the options, which is not thread safe.
+    job->om.reset( new overmap( p.x, p.y ) );
+
+    pending_overmap &data = *job;
+    try {
+        job->worker = std::thread( [&data]() {
+            const rng_thread_seed seeded( data.seed );
+            try {
+                if( data.from_file ) {
+                    if( !read_whole_file( data.terrain_filename, data.terrain_data ) ) {
+                        throw std::runtime_error( "file \"" + data.terrain_filename + "\" vanished" );
+                    }
+                    read_whole_file( data.player_filename, data.player_data );
+                } else {
+                    data.om->generate( data.neighbours[0].get(), data.neighbours[1].get(),
+                                       data.neighbours[2].get(), data.neighbours[3].get(),
+                                       data.specials, false );
+                }
+            } catch( const std::exception &err ) {
+                data.error = err.what();
+            }
+            data.done = true;
+        } );
+    } catch( const std::system_error &err ) {
+        DebugLog( D_WARNING, D_MAP_GEN ) << "could not start overmap thread: " << err.what();
+        return false;
+    }
+    pending[p] = std::move( job );
+    return true;
+}
+
+overmap &overmapbuffer::finish_pending( const point &p )
+{
+    const auto it = pending.find( p );
+    assert( it != pending.end() );
+    std::unique_ptr<pending_overmap> job = std::move( it->second );
+    pending.erase( it );
+    if( job->worker.joinable() ) {
+        job->worker.join();
+    }
+
+    // Same order as in get: the overmap must be in the buffer before it's populated,
+    // as populating may request it again.
+    overmap *new_om = job->om.release();
+    overmaps[p] = std::unique_ptr<overmap>( new_om );
+    known_non_existing.erase( p );
+
+    if( job->from_file && job->error.empty() ) {
+        try {
+            std::istringstream terrain( job->terrain_data );
+            new_om->unserialize( terrain );
+            if( !job->player_data.empty() ) {
+                std::istringstream view( job->player_data );
+                new_om->unserialize_view( view );
+            }
+        } catch( const std::exception &err ) {
+            debugmsg( "overmap (%d,%d) failed to load: %s", p.x, p.y, err.what() );
+        }
+    } else if( job->from_file ) {
+        // Reading failed, let the regular code path try again and report it.
+        new_om->populate();
+    } else {
+        if( !job->error.empty() ) {
+            debugmsg( "overmap (%d,%d) failed to load: %s", p.x, p.y, job->error.c_str() );
+        }
+        new_om->place_specials_overflow( job->specials );
+    }
+    fix_mongroups( *new_om );
+    fix_npcs( *new_om );
+    return *new_om;
+}
+
+void overmapbuffer::generate_area( const point &min, const point &max, const unsigned int seed,
+                                   const unsigned int threads,
+                                   const std::function<void( int, int )> &progress )
+{
+    // Each wave is an anti-diagonal of the area. An overmap is only stitched to its
+    // orthogonal neighbours, which are in the previous and the next wave, so all
+    // overmaps of a wave can be generated at once and each of them sees the same
+    // neighbours no matter how many threads are used.
+    std::vector<std::vector<point>> waves( ( max.x - min.x ) + ( max.y - min.y ) + 1 );
+    for( int x = min.x; x <= max.x; ++x ) {
+        for( int y = min.y; y <= max.y; ++y ) {
+            waves[( x - min.x ) + ( y - min.y )].emplace_back( x, y );
+        }
+    }
+    const int total = ( max.x - min.x + 1 ) * ( max.y - min.y + 1 );
+    const size_t batch_size = std::max( 1u, threads );
+    int done = 0;
+    for( size_t wave = 0; wave < waves.size(); ++wave ) {
+        const std::vector<point> &positions = waves[wave];
+        // The whole wave is generated before any of it is finished: finishing places
+        // leftover specials, which may create overmaps next to the rest of the wave.
+        // The started jobs are hidden from the buffer until their turn, so finishing
+        // one of them sees the others as not yet generated.
+        std::vector<point> started;
+        std::vector<std::unique_ptr<pending_overmap>> jobs;
+        for( size_t first = 0; first < positions.size(); first += batch_size ) {
+            const size_t last = std::min( positions.size(), first + batch_size );
+            const size_t batch = jobs.size();
+            for( size_t i = first; i < last; ++i ) {
+                const point &p = positions[i];
+                // Checking the file directly, has() would load the overmap.
+                if( overmaps.count( p ) > 0 || file_exist( terrain_filename( p.x, p.y ) ) ) {
+                    continue;
+                }
+                const unsigned int om_seed = seed ^ ( p.x * 73856093u ) ^ ( p.y * 19349663u );
+                if( start_pending( p, om_seed ) ) {
+                    started.push_back( p );
+                    jobs.push_back( std::move( pending[p] ) );
+                    pending.erase( p );
+                } else {
+                    const rng_thread_seed seeded( om_seed );
+                    get( p.x, p.y );
+                }
+            }
+            for( size_t i = batch; i < jobs.size(); ++i ) {
+                jobs[i]->worker.join();
+            }
+            done += last - first;
+            if( progress ) {
+                progress( done, total );
+            }
+        }
+        // Always finish in the same order, this runs the main thread part
+        // (leftover specials, monster groups) deterministically.
+        for( size_t i = 0; i < started.size(); ++i ) {
+            const point &p = started[i];
+            if( overmaps.count( p ) > 0 ) {
+                // Leftover specials of an earlier job were placed there.
+                continue;
+            }
+            pending[p] = std::move( jobs[i] );
+            const rng_thread_seed seeded( seed ^ ( p.x * 83492791u ) ^ ( p.y * 2971215073u ) );
+            finish_pending( p );
+        }
+        // The previous wave is not a neighbour of anything that is still to be
+        // generated, save it and free the memory.
+        if( wave > 0 ) {
+            for( const point &p : waves[wave - 1] ) {
+                const auto it = overmaps.find( p );
+                if( it == overmaps.end() ) {
+                    continue;
+                }
+                it->second->save();
+                if( last_requested_overmap == it->second.get() ) {
+                    last_requested_overmap = nullptr;
+                }
+                overmaps.erase( it );
+            }
+        }
+    }
+}
+
 void overmapbuffer::create_custom_overmap( int const x, int const y, overmap_special_batch &specials )
 {
+    if( pending.count( point( x, y ) ) > 0 ) {
+        // Replaced by the custom overmap below.
+        pending.erase( point( x, y ) );
+    }
     overmap *new_om = new overmap( x, y );
     if( last_requested_overmap != nullptr ) {
         auto om_iter = overmaps.find( new_om->pos() );
@@ -178,16 +500,31 @@ void overmapbuffer::fix_npcs( overmap &new_overmap )
     }
 }
 
-void overmapbuffer::save()
+void overmapbuffer::save( const bool in_background )
 {
+    while( !pending.empty() ) {
+        finish_pending( pending.begin()->first );
+    }
     for( auto &omp : overmaps ) {
-        // Note: this may throw io errors from std::ofstream
-        omp.second->save();
+        // Monster groups and NPCs are shared with the game, so the overmap is serialized
+        // here and only the writing is left to the save thread.
+        std::ostringstream view;
+        omp.second->serialize_view( view );
+        background_saves.add( player_filename( omp.first.x, omp.first.y ), view.str() );
+        std::ostringstream terrain;
+        omp.second->serialize( terrain );
+        background_saves.add( terrain_filename( omp.first.x, omp.first.y ), terrain.str() );
+    }
+    if( !in_background ) {
+        // Note: this may throw io errors
+        background_saves.wait();
     }
 }
 
 void overmapbuffer::clear()
 {
+    // Waits for the workers to finish.
+    pending.clear();
     overmaps.clear();
     known_non_existing.clear();
     last_requested_overmap = nullptr;
@@ -225,6 +562,9 @@ overmap *overmapbuffer::get_existing(int x, int y)
     if( it != overmaps.end() ) {
         return last_requested_overmap = it->second.get();
     }
+    if( pending.count( p ) > 0 ) {
+        return last_requested_overmap = &finish_pending( p );
+    }
     if (known_non_existing.count(p) > 0) {
         // This overmap does not exist on disk (this has already been
         // checked in a previous call of this function).
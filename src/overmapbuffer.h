@@ -6,6 +6,7 @@
 #include "int_id.h"
 #include "overmap_types.h"
 
+#include <functional>
 #include <set>
 #include <list>
 #include <memory>
@@ -21,8 +22,10 @@ struct oter_t;
 using oter_id = int_id<oter_t>;
 
 class overmap;
+class overmapbuffer;
 class overmap_special;
 class overmap_special_batch;
+struct pending_overmap;
 struct radio_tower;
 struct regional_settings;
 class vehicle;
@@ -55,10 +58,34 @@ struct city_reference {
     int get_distance_from_bounds() const;
 };
 
+/**
+ * Future-like reference to an overmap that may still be loaded or generated
+ * in the background, see @ref overmapbuffer::request.
+ */
+class overmap_handle
+{
+    public:
+        overmap_handle( overmapbuffer &buffer, const point &p ) : buffer( &buffer ), p( p ) {}
+
+        /** Overmap coordinates of the referenced overmap. */
+        const point &pos() const {
+            return p;
+        }
+        /** Whether @ref get would return without blocking on a background job. */
+        bool ready() const;
+        /** Returns the overmap, waits for the background job to finish if needed. */
+        overmap &get() const;
+
+    private:
+        overmapbuffer *buffer;
+        point p;
+};
+
 class overmapbuffer
 {
 public:
     overmapbuffer();
+    ~overmapbuffer();
 
     static std::string terrain_filename(int const x, int const y);
     static std::string player_filename(int const x, int const y);
@@ -68,7 +95,43 @@ public:
      * compared with the position of the overmap.
      */
     overmap &get( const int x, const int y );
-    void save();
+    /**
+     * Start loading or generating the overmap at (x,y) (overmap coordinates) on a
+     * background thread, unless it's already available. The returned handle only
+     * blocks when the overmap is actually accessed.
+     * If the overmap can not be prepared in the background (e.g. because a neighbour
+     * it has to be stitched to is still being generated), accessing the handle
+     * falls back to @ref get.
+     */
+    overmap_handle request( int x, int y );
+    /**
+     * Whether the overmap at (x,y) (overmap coordinates) can be accessed without
+     * waiting for disk access, overmap generation or a background job.
+     */
+    bool is_ready( int x, int y ) const;
+    /**
+     * Moves overmaps that have finished loading in the background into the buffer and
+     * requests the overmaps adjacent to @p center if it's within
+     * the "OVERMAP_PREFETCH_DISTANCE" option of the edge of its overmap.
+     * @param center Global overmap terrain coordinates, usually the player position.
+     */
+    void prefetch_near( const tripoint &center );
+    /**
+     * Generates all missing overmaps with overmap coordinates in [min, max], using up to
+     * @p threads worker threads. The result only depends on @p seed and on the overmaps
+     * that already exist, not on the number of threads.
+     * Overmaps in the area are saved and unloaded once all their neighbours are done.
+     * @param progress Called with (generated, total) after each batch, may be empty.
+     */
+    void generate_area( const point &min, const point &max, unsigned int seed, unsigned int threads,
+                        const std::function<void( int, int )> &progress );
+    /**
+     * Saves all loaded overmaps.
+     * @param in_background If true, the overmaps are only serialized and added to
+     * @ref background_saves, the caller starts writing them. Otherwise this waits until
+     * all files are written.
+     */
+    void save( bool in_background = false );
     void clear();
     void create_custom_overmap( int const x, int const y, overmap_special_batch &specials );
 
@@ -345,6 +408,11 @@ public:
 
 private:
     std::unordered_map< point, std::unique_ptr< overmap > > overmaps;
+    /**
+     * Overmaps that are being loaded or generated on a background thread. They are
+     * moved into @ref overmaps by @ref finish_pending once they are needed or done.
+     */
+    std::unordered_map< point, std::unique_ptr< pending_overmap > > pending;
     /**
      * Set of overmap coordinates of overmaps that are known
      * to not exist on disk. See @ref get_existing for usage.
@@ -377,6 +445,20 @@ private:
      * Moves out-of-bounds NPCs to the overmaps they should be in.
      */
     void fix_npcs( overmap &new_overmap );
+    /**
+     * Starts the background job for the overmap at @p p. The overmap must neither be in
+     * @ref overmaps nor in @ref pending.
+     * @param seed Seed for the random generator of the job, see @ref rng_thread_seed.
+     * @returns false if the job could not be started, the overmap is then
+     * created the regular way by the next call to @ref get.
+     */
+    bool start_pending( const point &p, unsigned int seed );
+    /**
+     * Waits for the background job of the overmap at @p p (which must be in @ref pending),
+     * moves the result into @ref overmaps and does the part of loading that has to
+     * happen on the main thread.
+     */
+    overmap &finish_pending( const point &p );
     /**
      * Retrieve overmaps that overlap the bounding box defined by the location and radius.
      * The location is in absolute submap coordinates, the radius is in the same system.
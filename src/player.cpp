@@ -9729,7 +9729,7 @@ int player::sleep_spot( const tripoint &p ) const
     }
     int vpart = -1;
     vehicle *veh = g->m.veh_at(p, vpart);
-    const maptile tile = g->m.maptile_at( p );
+    const const_maptile tile = g->m.read_only().maptile_at( p );
     const trap &trap_at_pos = tile.get_trap_t();
     const ter_id ter_at_pos = tile.get_ter();
     const furn_id furn_at_pos = tile.get_furn();
@@ -0,0 +1,107 @@
+#include "game.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#if (defined _WIN32 || defined WINDOWS) && !defined _MSC_VER
+#   include "mingw.thread.h"
+#endif
+
+#include "calendar.h"
+#include "coordinate_conversions.h"
+#include "line.h"
+#include "loading_ui.h"
+#include "map.h"
+#include "mapbuffer.h"
+#include "options.h"
+#include "overmapbuffer.h"
+#include "pathfinding.h"
+#include "worldfactory.h"
+
+bool game::pregenerate_world( const std::string &worldname, const point &om_min,
+                              const point &om_max, const int radius, const unsigned int world_seed )
+{
+    world_generator->init();
+    const WORLDPTR world = world_generator->get_world( worldname );
+    if( world == nullptr ) {
+        std::cerr << "Unknown world: " << worldname << std::endl;
+        return false;
+    }
+    try {
+        world_generator->set_active_world( world );
+        loading_ui ui( false );
+        load_core_data( ui );
+        load_world_modfiles( world, ui );
+    } catch( const std::exception &err ) {
+        std::cerr << "Error loading data from json: " << err.what() << std::endl;
+        return false;
+    }
+
+    m = map( get_option<bool>( "ZLEVELS" ) );
+    seed = world_seed;
+    // Generate the map as of the start of a new game (see start_calendar), so that
+    // items don't age before the first character arrives.
+    calendar::start = HOURS( get_option<int>( "INITIAL_TIME" ) );
+    static const std::array<std::string, 4> seasons = {{ "spring", "summer", "autumn", "winter" }};
+    const auto season = std::find( seasons.begin(), seasons.end(),
+                                   get_option<std::string>( "INITIAL_SEASON" ) );
+    if( season != seasons.end() ) {
+        calendar::initial_season = static_cast<season_type>( season - seasons.begin() );
+        calendar::start += DAYS( calendar::season_length() * ( season - seasons.begin() ) );
+    }
+    calendar::turn = calendar::start;
+
+    const unsigned int threads = std::max( 1u, std::thread::hardware_concurrency() );
+    std::cout << "Generating overmaps " << om_min.x << "," << om_min.y << " to " <<
+              om_max.x << "," << om_max.y << " on " << threads << " threads" << std::endl;
+    try {
+        overmap_buffer.generate_area( om_min, om_max, world_seed, threads, []( int done, int total ) {
+            std::cout << "Overmaps: " << done << "/" << total << std::endl;
+        } );
+        overmap_buffer.save();
+    } catch( const std::exception &err ) {
+        std::cerr << "Error generating overmaps: " << err.what() << std::endl;
+        return false;
+    }
+
+    if( radius <= 0 ) {
+        return true;
+    }
+
+    // Map generation uses the shared game state (the map buffer, the overmaps) and
+    // is therefore done on this thread, in a fixed order.
+    srand( world_seed );
+    const point center( ( om_min.x + om_max.x + 1 ) * OMAPX / 2,
+                        ( om_min.y + om_max.y + 1 ) * OMAPY / 2 );
+    const int min_z = m.has_zlevels() ? -OVERMAP_DEPTH : 0;
+    const int max_z = m.has_zlevels() ? OVERMAP_HEIGHT : 0;
+    const int rows = 2 * radius + 1;
+    std::cout << "Generating map within " << radius << " of " << center.x << "," << center.y <<
+              std::endl;
+    try {
+        for( int y = center.y - radius; y <= center.y + radius; ++y ) {
+            for( int x = center.x - radius; x <= center.x + radius; ++x ) {
+                if( trig_dist( center.x, center.y, x, y ) > radius ) {
+                    continue;
+                }
+                const point sm = omt_to_sm_copy( x, y );
+                for( int z = min_z; z <= max_z; ++z ) {
+                    // Loading generates the submaps that are missing.
+                    tinymap quad;
+                    quad.load( sm.x, sm.y, z, false );
+                }
+            }
+            // Write the finished row and free it.
+            MAPBUFFER.save( true );
+            std::cout << "Map rows: " << ( y - center.y + radius + 1 ) << "/" << rows << std::endl;
+        }
+        // Map generation may have changed the overmaps (e.g. added npcs).
+        overmap_buffer.save();
+    } catch( const std::exception &err ) {
+        std::cerr << "Error generating the map: " << err.what() << std::endl;
+        return false;
+    }
+    return true;
+}
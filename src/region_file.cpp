@@ -0,0 +1,286 @@
+#include "region_file.h"
+
+#include "filesystem.h"
+#include "mapsharing.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#if !defined _WIN32 && !defined __WIN32__
+#   include <unistd.h>
+#else
+#   include <io.h>
+#endif
+
+namespace
+{
+
+const char region_magic[8] = { 'C', 'D', 'D', 'A', 'R', 'E', 'G', '\0' };
+const uint32_t region_version = 1;
+const uint32_t slot_count = region_file::size * region_file::size;
+// Header: magic, version, slot count. The table entries are 16 bytes, so none of them
+// crosses a disk sector and a crash can't leave an entry half written.
+const uint32_t header_size = 16;
+const uint32_t entry_size = 16;
+const uint32_t data_start = header_size + slot_count * entry_size;
+// Quads are allocated in blocks of this size, so slightly bigger versions fit in freed space.
+const uint32_t block_size = 512;
+
+struct table_entry {
+    uint32_t offset = 0;
+    uint32_t length = 0;
+    uint32_t capacity = 0;
+};
+
+uint32_t get_u32( const char *data )
+{
+    const unsigned char *const bytes = reinterpret_cast<const unsigned char *>( data );
+    return bytes[0] | bytes[1] << 8 | bytes[2] << 16 | static_cast<uint32_t>( bytes[3] ) << 24;
+}
+
+void put_u32( char *data, const uint32_t value )
+{
+    data[0] = static_cast<char>( value & 0xff );
+    data[1] = static_cast<char>( ( value >> 8 ) & 0xff );
+    data[2] = static_cast<char>( ( value >> 16 ) & 0xff );
+    data[3] = static_cast<char>( value >> 24 );
+}
+
+uint32_t slot_index( const point &slot )
+{
+    if( slot.x < 0 || slot.y < 0 || slot.x >= region_file::size || slot.y >= region_file::size ) {
+        throw std::runtime_error( "quad outside of the region" );
+    }
+    return slot.y * region_file::size + slot.x;
+}
+
+/** Checks the header, @p data must have at least @ref header_size bytes. */
+void check_header( const char *data )
+{
+    if( !std::equal( region_magic, region_magic + sizeof( region_magic ), data ) ) {
+        throw std::runtime_error( "not a region file" );
+    }
+    if( get_u32( data + 8 ) > region_version || get_u32( data + 12 ) != slot_count ) {
+        throw std::runtime_error( "unsupported region file version" );
+    }
+}
+
+/** Flushes @p file and makes sure that everything written to it is on the disk. */
+bool sync_file( FILE *file )
+{
+    bool ok = fflush( file ) == 0;
+#if !defined _WIN32 && !defined __WIN32__
+    ok = fsync( fileno( file ) ) == 0 && ok;
+#else
+    ok = _commit( _fileno( file ) ) == 0 && ok;
+#endif
+    return ok;
+}
+
+bool read_at( FILE *file, const uint32_t offset, char *data, const size_t length )
+{
+    return fseek( file, offset, SEEK_SET ) == 0 && fread( data, 1, length, file ) == length;
+}
+
+/**
+ * Creates an empty region file at @p path. The header is written to a temporary file
+ * that is renamed, so a crash can't leave a file without a complete table.
+ */
+void create_region( const std::string &path )
+{
+    std::vector<char> header( data_start );
+    std::copy( region_magic, region_magic + sizeof( region_magic ), header.begin() );
+    put_u32( &header[8], region_version );
+    put_u32( &header[12], slot_count );
+    const std::string temp_path = path + ".tmp";
+    FILE *const file = fopen( temp_path.c_str(), "wb" );
+    bool ok = file != nullptr;
+    if( ok ) {
+        ok = fwrite( header.data(), 1, header.size(), file ) == header.size();
+        ok = sync_file( file ) && ok;
+        ok = fclose( file ) == 0 && ok;
+    }
+    if( !ok || !rename_file( temp_path, path ) ) {
+        remove_file( temp_path );
+        throw std::runtime_error( "creating file failed" );
+    }
+}
+
+table_entry get_entry( const char *table, const uint32_t index )
+{
+    table_entry result;
+    const char *const entry = table + index * entry_size;
+    result.offset = get_u32( entry );
+    result.length = get_u32( entry + 4 );
+    result.capacity = get_u32( entry + 8 );
+    return result;
+}
+
+void put_entry( char *table, const uint32_t index, const table_entry &value )
+{
+    char *const entry = table + index * entry_size;
+    put_u32( entry, value.offset );
+    put_u32( entry + 4, value.length );
+    put_u32( entry + 8, value.capacity );
+    put_u32( entry + 12, 0 );
+}
+
+/** An open region file for writing, it is locked like the files of fopen_exclusive. */
+class region_writer
+{
+    public:
+        region_writer( const std::string &path, const bool create ) : lock_path( path + ".lock" ) {
+            lock = getLock( lock_path.c_str() );
+            if( lock == -1 ) {
+                throw std::runtime_error( "file is locked" );
+            }
+            try {
+                header.resize( data_start );
+                file = fopen( path.c_str(), "r+b" );
+                if( file != nullptr && !read_at( file, 0, &header[0], data_start ) ) {
+                    // Older versions could leave a file without a complete table, it has no quads.
+                    fclose( file );
+                    file = nullptr;
+                }
+                if( file == nullptr && create ) {
+                    create_region( path );
+                    file = fopen( path.c_str(), "r+b" );
+                    if( file == nullptr || !read_at( file, 0, &header[0], data_start ) ) {
+                        throw std::runtime_error( "opening file failed" );
+                    }
+                }
+                if( file != nullptr ) {
+                    check_header( header.data() );
+                }
+            } catch( ... ) {
+                close();
+                throw;
+            }
+        }
+
+        ~region_writer() {
+            close();
+        }
+
+        bool exists() const {
+            return file != nullptr;
+        }
+        char *table() {
+            return &header[header_size];
+        }
+        void write_at( const uint32_t offset, const char *data, const size_t length ) {
+            if( fseek( file, offset, SEEK_SET ) != 0 || fwrite( data, 1, length, file ) != length ) {
+                throw std::runtime_error( "writing to file failed" );
+            }
+        }
+        /** Makes sure everything written so far is on the disk. */
+        void sync() {
+            if( !sync_file( file ) ) {
+                throw std::runtime_error( "writing to file failed" );
+            }
+        }
+
+    private:
+        void close() {
+            if( file != nullptr ) {
+                fclose( file );
+                file = nullptr;
+            }
+            releaseLock( lock, lock_path.c_str() );
+        }
+
+        std::string lock_path;
+        int lock = -1;
+        FILE *file = nullptr;
+        /** The header and the table. */
+        std::vector<char> header;
+};
+
+}
+
+bool region_file::read( const point &slot, std::string &data ) const
+{
+    const uint32_t index = slot_index( slot );
+    // Only the header, the table entry of the quad and the quad itself are read.
+    FILE *const file = fopen( path.c_str(), "rb" );
+    if( file == nullptr ) {
+        return false;
+    }
+    try {
+        char header[header_size];
+        char entry_data[entry_size];
+        if( !read_at( file, 0, header, header_size ) ||
+            !read_at( file, header_size + index * entry_size, entry_data, entry_size ) ) {
+            // A file without a complete table has no quads, see region_writer.
+            fclose( file );
+            return false;
+        }
+        check_header( header );
+        const table_entry entry = get_entry( entry_data, 0 );
+        bool found = false;
+        if( entry.length > 0 ) {
+            data.resize( entry.length );
+            if( !read_at( file, entry.offset, &data[0], entry.length ) ) {
+                throw std::runtime_error( "quad outside of the region file" );
+            }
+            found = true;
+        }
+        fclose( file );
+        return found;
+    } catch( ... ) {
+        fclose( file );
+        throw;
+    }
+}
+
+void region_file::write( const std::map<point, std::string> &quads ) const
+{
+    region_writer file( path, true );
+    // Space used by the quads of the old table and by the quads written now, by offset.
+    // The old quads must stay intact until the new table is written.
+    std::map<uint32_t, uint32_t> used;
+    for( uint32_t i = 0; i < slot_count; i++ ) {
+        const table_entry entry = get_entry( file.table(), i );
+        if( entry.capacity > 0 ) {
+            used[entry.offset] = entry.capacity;
+        }
+    }
+    std::vector<std::pair<uint32_t, table_entry>> written;
+    for( auto &quad : quads ) {
+        const uint32_t index = slot_index( quad.first );
+        table_entry entry;
+        entry.length = quad.second.size();
+        entry.capacity = ( entry.length + block_size - 1 ) / block_size * block_size;
+        // First fit into the gaps between the used spaces, otherwise at the end.
+        entry.offset = data_start;
+        for( auto &space : used ) {
+            if( space.first >= entry.offset + entry.capacity ) {
+                break;
+            }
+            entry.offset = std::max( entry.offset, space.first + space.second );
+        }
+        used[entry.offset] = entry.capacity;
+        file.write_at( entry.offset, quad.second.data(), entry.length );
+        written.emplace_back( index, entry );
+    }
+    file.sync();
+    for( auto &entry : written ) {
+        put_entry( file.table(), entry.first, entry.second );
+    }
+    file.write_at( header_size, file.table(), slot_count * entry_size );
+    file.sync();
+}
+
+void region_file::remove( const std::vector<point> &slots ) const
+{
+    region_writer file( path, false );
+    if( !file.exists() ) {
+        return;
+    }
+    for( const point &slot : slots ) {
+        put_entry( file.table(), slot_index( slot ), table_entry() );
+    }
+    file.write_at( header_size, file.table(), slot_count * entry_size );
+    file.sync();
+}
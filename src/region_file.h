@@ -0,0 +1,48 @@
+#pragma once
+#ifndef REGION_FILE_H
+#define REGION_FILE_H
+
+#include "enums.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * A container file for the map quads of one segment (32x32 overmap terrain tiles on
+ * one z-level, see omt_to_seg_copy), so that big worlds don't need one file per quad.
+ *
+ * The file starts with a magic, a version and a table with the offset, length and
+ * capacity of each quad, the quads follow in any order. Writing puts the new quads into
+ * space that no quad uses (or at the end), syncs them to disk and only then updates the
+ * table, so a crash leaves the old table and the old quads intact. The space of the
+ * replaced quads is reused by later writes.
+ */
+class region_file
+{
+    public:
+        /** Quads per side of a region. */
+        static constexpr int size = 32;
+
+        explicit region_file( const std::string &path ) : path( path ) { }
+
+        /**
+         * Reads the quad at @p slot (its position in the segment) into @p data.
+         * @return false if the file or the quad does not exist.
+         * Throws std::runtime_error if the file is damaged.
+         */
+        bool read( const point &slot, std::string &data ) const;
+        /**
+         * Writes the quads (by their position in the segment). A missing file is created
+         * through a temporary file, so it always has a complete table.
+         * Throws std::runtime_error on failure.
+         */
+        void write( const std::map<point, std::string> &quads ) const;
+        /** Removes the quads from the file, if it exists. Throws std::runtime_error on failure. */
+        void remove( const std::vector<point> &slots ) const;
+
+    private:
+        std::string path;
+};
+
+#endif
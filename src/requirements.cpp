@@ -314,6 +314,15 @@ void quality_requirement::check_consistency( const std::string &display_name ) c
     }
 }
 
+itype_int_id component::type_index() const
+{
+    if( !index_cached ) {
+        cached_index = item::find_type_index( type );
+        index_cached = true;
+    }
+    return cached_index;
+}
+
 void component::check_consistency( const std::string &display_name ) const
 {
     if( !item::type_is_defined( type ) ) {
@@ -593,9 +602,9 @@ bool tool_comp::has( const inventory &crafting_inv, int batch ) const
     }
 
     if( !by_charges() ) {
-        return crafting_inv.has_tools( type, std::abs( count ) );
+        return crafting_inv.has_tools( type_index(), std::abs( count ) );
     } else {
-        return crafting_inv.has_charges( type, count * batch );
+        return crafting_inv.has_charges( type_index(), count * batch );
     }
 }
 
@@ -603,9 +612,9 @@ std::string tool_comp::get_color( bool has_one, const inventory &crafting_inv, i
 {
     if( available == a_insufficent ) {
         return "brown";
-    } else if( !by_charges() && crafting_inv.has_tools( type, std::abs( count ) ) ) {
+    } else if( !by_charges() && crafting_inv.has_tools( type_index(), std::abs( count ) ) ) {
         return "green";
-    } else if( by_charges() && crafting_inv.has_charges( type, count * batch ) ) {
+    } else if( by_charges() && crafting_inv.has_charges( type_index(), count * batch ) ) {
         return "green";
     }
     return has_one ? "dkgray" : "red";
@@ -618,10 +627,13 @@ bool item_comp::has( const inventory &crafting_inv, int batch ) const
     }
 
     const int cnt = std::abs( count ) * batch;
-    if( item::count_by_charges( type ) ) {
-        return crafting_inv.has_charges( type, cnt );
+    const itype_int_id index = type_index();
+    if( !index.is_valid() ) {
+        return false;
+    } else if( item::count_by_charges( index ) ) {
+        return crafting_inv.has_charges( index, cnt );
     } else {
-        return crafting_inv.has_components( type, cnt );
+        return crafting_inv.has_components( index, cnt );
     }
 }
 
@@ -630,11 +642,13 @@ std::string item_comp::get_color( bool has_one, const inventory &crafting_inv, i
     const int cnt = std::abs( count ) * batch;
     if( available == a_insufficent ) {
         return "brown";
-    } else if( item::count_by_charges( type ) ) {
-        if( crafting_inv.has_charges( type, cnt ) ) {
+    } else if( !type_index().is_valid() ) {
+        return has_one ? "dkgray" : "red";
+    } else if( item::count_by_charges( type_index() ) ) {
+        if( crafting_inv.has_charges( type_index(), cnt ) ) {
             return "green";
         }
-    } else if( crafting_inv.has_components( type, cnt ) ) {
+    } else if( crafting_inv.has_components( type_index(), cnt ) ) {
         return "green";
     }
     return has_one ? "dkgray" : "red";
@@ -9,6 +9,7 @@
 #include "color.h"
 #include "output.h"
 #include "string_id.h"
+#include "int_id.h"
 
 class JsonObject;
 class JsonArray;
@@ -19,6 +20,8 @@ using requirement_id = string_id<requirement_data>;
 
 // Denotes the id of an item type
 typedef std::string itype_id;
+struct itype;
+using itype_int_id = int_id<itype>;
 struct quality;
 using quality_id = string_id<quality>;
 
@@ -57,6 +60,15 @@ struct component {
     component( const itype_id &TYPE, int COUNT, bool RECOVERABLE ) :
         type( TYPE ), count( COUNT ), recoverable( RECOVERABLE ) { }
     void check_consistency( const std::string &display_name ) const;
+    /**
+     * The int id of @ref type, looked up once the item types are finalized. It's invalid if
+     * there is no such item type.
+     */
+    itype_int_id type_index() const;
+
+private:
+    mutable itype_int_id cached_index = itype_int_id( -1 );
+    mutable bool index_cached = false;
 };
 
 struct tool_comp : public component {
@@ -3,23 +3,75 @@
 #include "game_constants.h"
 #include <stdlib.h>
 #include <random>
-#include <chrono>
 
 #define _USE_MATH_DEFINES
 #include <cmath>
 
+static thread_local rng_thread_seed *thread_seed = nullptr;
+
+namespace
+{
+
+/** Makes @ref rng_rand usable with the distributions of <random>. */
+struct rng_rand_engine {
+    typedef unsigned int result_type;
+    static constexpr result_type min() {
+        return 0;
+    }
+    static constexpr result_type max() {
+        return RAND_MAX;
+    }
+    result_type operator()() {
+        return rng_rand();
+    }
+};
+
+}
+
+rng_thread_seed::rng_thread_seed( const unsigned int seed )
+    : state( seed % 2147483647 ), previous( thread_seed )
+{
+    // The generator below must not start at 0.
+    if( state == 0 ) {
+        state = 1;
+    }
+    thread_seed = this;
+}
+
+rng_thread_seed::~rng_thread_seed()
+{
+    thread_seed = previous;
+}
+
+int rng_thread_seed::next()
+{
+    // Park-Miller minimal standard generator, same as std::minstd_rand.
+    state = state * 48271 % 2147483647;
+    return static_cast<int>( state % ( static_cast<uint64_t>( RAND_MAX ) + 1 ) );
+}
+
+int rng_rand()
+{
+    return thread_seed != nullptr ? thread_seed->next() : rand();
+}
+
+long rng_index( const long n )
+{
+    return rng( 0, n - 1 );
+}
+
 long rng( long val1, long val2 )
 {
     long minVal = ( val1 < val2 ) ? val1 : val2;
     long maxVal = ( val1 < val2 ) ? val2 : val1;
-    return minVal + long( ( maxVal - minVal + 1 ) * double( rand() / double( RAND_MAX + 1.0 ) ) );
+    return minVal + long( ( maxVal - minVal + 1 ) * double( rng_rand() / double( RAND_MAX + 1.0 ) ) );
 }
 
 double rng_float( double val1, double val2 )
 {
     double minVal = ( val1 < val2 ) ? val1 : val2;
     double maxVal = ( val1 < val2 ) ? val2 : val1;
-    return minVal + ( maxVal - minVal ) * double( rand() ) / double( RAND_MAX + 1.0 );
+    return minVal + ( maxVal - minVal ) * double( rng_rand() ) / double( RAND_MAX + 1.0 );
 }
 
 bool one_in( int chance )
@@ -35,7 +87,7 @@ bool one_in_improved( double chance )
 
 bool x_in_y( double x, double y )
 {
-    return ( ( double )rand() / RAND_MAX ) <= ( ( double )x / y );
+    return ( ( double )rng_rand() / RAND_MAX ) <= ( ( double )x / y );
 }
 
 int dice( int number, int sides )
@@ -94,7 +146,6 @@ double rng_normal( double lo, double hi )
 
 double normal_roll( double mean, double stddev )
 {
-    static std::default_random_engine eng(
-        std::chrono::system_clock::now().time_since_epoch().count() );
+    rng_rand_engine eng;
     return std::normal_distribution<double>( mean, stddev )( eng );
 }
@@ -4,8 +4,40 @@
 
 #include "compatibility.h"
 
+#include <cstdint>
 #include <functional>
 
+/**
+ * Same range as rand(), but taken from the generator of the active
+ * @ref rng_thread_seed of the calling thread, if any. All functions below use this.
+ */
+int rng_rand();
+/** Returns a random index in [0, n), for use as the generator of std::random_shuffle. */
+long rng_index( long n );
+
+/**
+ * While an instance exists, the random functions called on the creating thread draw
+ * from a private generator seeded with the given value instead of the shared rand()
+ * state. Work done on worker threads becomes reproducible this way, independent of
+ * how the threads are scheduled. Instances nest and must be destroyed on the thread
+ * that created them.
+ */
+class rng_thread_seed
+{
+    public:
+        explicit rng_thread_seed( unsigned int seed );
+        ~rng_thread_seed();
+
+        rng_thread_seed( const rng_thread_seed & ) = delete;
+        rng_thread_seed &operator=( const rng_thread_seed & ) = delete;
+
+        int next();
+
+    private:
+        uint64_t state;
+        rng_thread_seed *previous;
+};
+
 long rng( long val1, long val2 );
 double rng_float( double val1, double val2 );
 bool one_in( int chance );
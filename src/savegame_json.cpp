@@ -1478,6 +1478,9 @@ void item::io( Archive& archive )
 {
 
     itype_id orig; // original ID as loaded from JSON
+    // Loading allocates the cold data (dropped below if it stays empty), saving only reads it.
+    item_cold_data no_cold_data;
+    item_cold_data &cold_data = Archive::is_input::value ? cold_mut() : cold_ ? *cold_ : no_cold_data;
     const auto load_type = [&]( const itype_id& id ) {
         orig = id;
         convert( item_controller->migrate_id( id ) );
@@ -1486,12 +1489,12 @@ void item::io( Archive& archive )
     const auto load_curammo = [this]( const std::string& id ) {
         curammo = item::find_type( id );
     };
-    const auto load_corpse = [this]( const std::string& id ) {
+    const auto load_corpse = [&cold_data]( const std::string& id ) {
         if( id == "null" ) {
             // backwards compatibility, nullptr should not be stored at all
-            corpse = nullptr;
+            cold_data.corpse = nullptr;
         } else {
-            corpse = &mtype_id( id ).obj();
+            cold_data.corpse = &mtype_id( id ).obj();
         }
     };
 
@@ -1509,8 +1512,8 @@ void item::io( Archive& archive )
     archive.io( "bday", bday, 0 );
     archive.io( "mission_id", mission_id, -1 );
     archive.io( "player_id", player_id, -1 );
-    archive.io( "item_vars", item_vars, io::empty_default_tag() );
-    archive.io( "name", corpse_name, std::string() ); // TODO: change default to empty string
+    archive.io( "item_vars", cold_data.item_vars, io::empty_default_tag() );
+    archive.io( "name", cold_data.corpse_name, std::string() ); // TODO: change default to empty string
     archive.io( "invlet", invlet, '\0' );
     archive.io( "damage", damage_, 0.0 );
     archive.io( "active", active, false );
@@ -1518,24 +1521,27 @@ void item::io( Archive& archive )
     archive.io( "fridge", fridge, 0 );
     archive.io( "rot", rot, 0 );
     archive.io( "last_rot_check", last_rot_check, 0 );
-    archive.io( "techniques", techniques, io::empty_default_tag() );
+    archive.io( "techniques", cold_data.techniques, io::empty_default_tag() );
     archive.io( "faults", faults, io::empty_default_tag() );
     archive.io( "item_tags", item_tags, io::empty_default_tag() );
     archive.io( "contents", contents, io::empty_default_tag() );
     archive.io( "components", components, io::empty_default_tag() );
     archive.template io<const itype>( "curammo", curammo, load_curammo,
                                       []( const itype& i ) { return i.get_id(); } );
-    archive.template io<const mtype>( "corpse", corpse, load_corpse,
+    archive.template io<const mtype>( "corpse", cold_data.corpse, load_corpse,
                                       []( const mtype& i ) { return i.id.str(); } );
-    archive.io( "light", light.luminance, nolight.luminance );
-    archive.io( "light_width", light.width, nolight.width );
-    archive.io( "light_dir", light.direction, nolight.direction );
-
-    item_controller->migrate_item( orig, *this );
+    archive.io( "light", cold_data.light.luminance, nolight.luminance );
+    archive.io( "light_width", cold_data.light.width, nolight.width );
+    archive.io( "light_dir", cold_data.light.direction, nolight.direction );
 
     if( !Archive::is_input::value ) {
+        item_controller->migrate_item( orig, *this );
         return;
     }
+    if( cold_data.is_default() ) {
+        cold_.reset();
+    }
+    item_controller->migrate_item( orig, *this );
     /* Loading has finished, following code is to ensure consistency and fixes bugs in saves. */
 
     // Old saves used to only contain one of those values (stored under "poison"), it would be
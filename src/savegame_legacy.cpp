@@ -173,7 +173,7 @@ std::string convert_talk_topic( talk_topic_enum const old_value )
 }
 
 ///// item.h
-bool itag2ivar( std::string &item_tag, std::map<std::string, std::string> &item_vars );
+bool itag2ivar( std::string &item_tag, item_var_map &item_vars );
 
 void item::load_info( const std::string &data )
 {
@@ -195,6 +195,7 @@ void item::load_info( const std::string &data )
 
     unset_flags();
     clear_vars();
+    item_cold_data &cold_data = cold_mut();
     std::string idtmp, ammotmp, item_tag, mode;
     int lettmp, damtmp, acttmp, corp, tag_count;
     int owned; // Ignoring an obsolete member.
@@ -202,14 +203,15 @@ void item::load_info( const std::string &data )
     for( int i = 0; i < tag_count; ++i )
     {
         dump >> item_tag;
-        if( itag2ivar(item_tag, item_vars ) == false ) {
+        if( itag2ivar(item_tag, cold_data.item_vars ) == false ) {
             item_tags.insert( item_tag );
         }
     }
 
     dump >> burnt >> poison >> ammotmp >> owned >> bday >>
          mode >> acttmp >> corp >> mission_id >> player_id;
-    corpse = NULL;
+    cold_data.corpse = NULL;
+    std::string &corpse_name = cold_data.corpse_name;
     getline(dump, corpse_name);
     if( corpse_name == " ''" ) {
         corpse_name = "";
@@ -230,6 +232,10 @@ void item::load_info( const std::string &data )
     }
     convert( idtmp );
 
+    if( cold_data.is_default() ) {
+        cold_.reset();
+    }
+
     invlet = char(lettmp);
     set_damage( damtmp );
     active = false;
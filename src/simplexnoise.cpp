@@ -468,6 +468,14 @@ float raw_noise_4d( const float x, const float y, const float z, const float w )
 }
 
 
+// 4D raw Simplex noise for several points, one after the other.
+void raw_noise_4d( const size_t count, const float *x, const float *y, const float *z, const float *w, float *result ) {
+    for( size_t i = 0; i < count; i++ ) {
+        result[i] = raw_noise_4d( x[i], y[i], z[i], w[i] );
+    }
+}
+
+
 int fastfloor( const float x ) { return x > 0 ? (int) x : (int) x - 1; }
 
 float dot( const int* g, const float x, const float y ) { return g[0]*x + g[1]*y; }
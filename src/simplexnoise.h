@@ -20,6 +20,8 @@
 #ifndef SIMPLEX_H
 #define SIMPLEX_H
 
+#include <cstddef>
+
 
 /* 2D, 3D and 4D Simplex Noise functions return 'random' values in (-1, 1).
 
@@ -120,6 +122,12 @@ float raw_noise_2d(const float x, const float y);
 float raw_noise_3d(const float x, const float y, const float z);
 float raw_noise_4d(const float x, const float y, const float, const float w);
 
+// Raw Simplex noise - `count` noise values, result[i] is the noise at (x[i], y[i], z[i], w[i]).
+// A plain loop over the single point version, so the values are exactly the same; it only
+// saves the callers from writing the loop.
+void raw_noise_4d(const size_t count, const float *x, const float *y, const float *z,
+                  const float *w, float *result);
+
 
 int fastfloor(const float x);
 
@@ -0,0 +1,36 @@
+#include "string_id.h"
+
+#include <functional>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+class string_id_table
+{
+    public:
+        std::mutex mutex;
+        std::unordered_map<std::string, string_id_entry> entries;
+};
+
+string_id_table &new_string_id_table()
+{
+    return *new string_id_table();
+}
+
+const string_id_entry &intern_string_id( string_id_table &table, std::string &&id )
+{
+    std::lock_guard<std::mutex> lock( table.mutex );
+    const auto iter = table.entries.find( id );
+    if( iter != table.entries.end() ) {
+        return iter->second;
+    }
+    const std::size_t hash = std::hash<std::string>()( id );
+    // The map is node based, neither the key nor the entry move once inserted.
+    auto &inserted = *table.entries.emplace( std::piecewise_construct,
+                     std::forward_as_tuple( std::move( id ) ), std::forward_as_tuple() ).first;
+    inserted.second.str = &inserted.first;
+    inserted.second.hash = hash;
+    inserted.second.cid.store( -1, std::memory_order_relaxed );
+    return inserted.second;
+}
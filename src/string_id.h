@@ -2,17 +2,47 @@
 #ifndef STRING_ID_H
 #define STRING_ID_H
 
+#include <atomic>
+#include <cstddef>
 #include <string>
 #include <type_traits>
 
 template<typename T>
 class int_id;
 
+/**
+ * The single shared copy of an id string, see @ref string_id. Entries are created on demand
+ * and never removed, so pointers to them stay valid for the whole program.
+ */
+struct string_id_entry {
+    /** The id itself. */
+    const std::string *str;
+    /** `std::hash<std::string>` of @ref str. */
+    std::size_t hash;
+    /** The int id the generic_factory found for this id the last time, may be stale. */
+    mutable std::atomic<int> cid;
+};
+
+/** The interned strings of one id type, one of these exists for each `string_id<T>`. */
+class string_id_table;
+/** Creates an empty table, it is never destroyed. */
+string_id_table &new_string_id_table();
+/**
+ * Returns the entry of `id` in `table`, creating it if needed. This may be called
+ * from any thread.
+ */
+const string_id_entry &intern_string_id( string_id_table &table, std::string &&id );
+
 /**
  * This represents an identifier (implemented as std::string) of some object.
  * It can be used for all type of objects, one just needs to specify a type as
  * template parameter T, which separates the different identifier types.
  *
+ * The string is interned: every id of the same type and text points to the same
+ * @ref string_id_entry, so comparing ids for equality and hashing them does not have
+ * to look at the string at all. Creating an id from a string does, it has to look up the
+ * string in the table of its type. Ids that are used often should be created once.
+ *
  * The constructor is explicit on purpose, you have to write
  * \code
  * auto someid = mtype_id("mon_dog");
@@ -51,38 +81,43 @@ class string_id
         // a std::string, otherwise a "no matching function to call..." error is generated.
         template<typename S, class = typename
                  std::enable_if< std::is_convertible<S, std::string >::value>::type >
-        explicit string_id( S && id, int cid = -1 ) : _id( std::forward<S>( id ) ), _cid( cid ) {
+        explicit string_id( S && id, int cid = -1 ) :
+            entry( &intern_string_id( table(), std::string( std::forward<S>( id ) ) ) ) {
+            if( cid != -1 ) {
+                entry->cid.store( cid, std::memory_order_relaxed );
+            }
         }
         /**
          * Default constructor constructs an empty id string.
          * Note that this id class does not enforce empty id strings (or any specific string at all)
          * to be special. Every string (including the empty one) may be a valid id.
          */
-        string_id() : _id(), _cid( -1 ) {}
+        string_id() : entry( &empty_entry() ) {}
         /**
          * Comparison, only useful when the id is used in std::map or std::set as key. Compares
-         * the string id as with the strings comparison.
+         * the string id as with the strings comparison, so the order does not depend on when
+         * the ids were interned.
          */
         bool operator<( const This &rhs ) const {
-            return _id < rhs._id;
+            return entry != rhs.entry && *entry->str < *rhs.entry->str;
         }
         /**
-         * The usual comparator, compares the string id as usual.
+         * The usual comparator, equal ids share their entry.
          */
         bool operator==( const This &rhs ) const {
-            return _id == rhs._id;
+            return entry == rhs.entry;
         }
         /**
-         * The usual comparator, compares the string id as usual.
+         * The usual comparator, equal ids share their entry.
          */
         bool operator!=( const This &rhs ) const {
-            return _id != rhs._id;
+            return entry != rhs.entry;
         }
         /**
          * The unusual comparator, compares the string id to char *
          */
         bool operator==( const char *rhs ) const {
-            return _id == rhs;
+            return *entry->str == rhs;
         }
         /**
          * Interface to the plain C-string of the id. This function mimics the std::string
@@ -90,7 +125,7 @@ class string_id
          * to be included in the format string, e.g. debugmsg("invalid id: %s", id.c_str())
          */
         const char *c_str() const {
-            return _id.c_str();
+            return entry->str->c_str();
         }
         /**
          * Returns the identifier as plain std::string. Use with care, the plain string does not
@@ -98,11 +133,17 @@ class string_id
          * the class).
          */
         const std::string &str() const {
-            return _id;
+            return *entry->str;
         }
 
         explicit operator std::string() const {
-            return _id;
+            return *entry->str;
+        }
+        /**
+         * The hash of the id string, computed when it was interned.
+         */
+        std::size_t hash() const {
+            return entry->hash;
         }
 
         // Those are optional, you need to implement them on your own if you want to use them.
@@ -135,7 +176,7 @@ class string_id
          * keep consistency with the rest is_.. functions
          */
         bool is_empty() const {
-            return _id.empty();
+            return entry == &empty_entry();
         }
         /**
          * Returns a null id whose `string_id<T>::is_null()` must always return true. See @ref is_null.
@@ -176,30 +217,38 @@ class string_id
         // @todo Exposed for now. Hide these and make them accessible to the generic_factory only
 
         /**
-         * Assigns a new value for the cached int id.
+         * Assigns a new value for the cached int id, it's shared by all equal ids.
          */
         void set_cid( const int_id<T> &cid ) const {
-            _cid = cid.to_i();
+            entry->cid.store( cid.to_i(), std::memory_order_relaxed );
         }
         /**
          * Returns the current value of cached id
          */
         int_id<T> get_cid() const {
-            return int_id<T>( _cid );
+            return int_id<T>( entry->cid.load( std::memory_order_relaxed ) );
         }
 
     private:
-        std::string _id;
-        mutable int _cid;
+        static string_id_table &table() {
+            static string_id_table &instance = new_string_id_table();
+            return instance;
+        }
+        static const string_id_entry &empty_entry() {
+            static const string_id_entry &instance = intern_string_id( table(), std::string() );
+            return instance;
+        }
+
+        const string_id_entry *entry;
 };
 
-// Support hashing of string based ids by forwarding the hash of the string.
+// Support hashing of string based ids by forwarding the (precomputed) hash of the string.
 namespace std
 {
 template<typename T>
 struct hash< string_id<T> > {
     std::size_t operator()( const string_id<T> &v ) const {
-        return hash<std::string>()( v.str() );
+        return v.hash();
     }
 };
 }
@@ -32,6 +32,44 @@ void submap::delete_vehicles()
     vehicles.clear();
 }
 
+const std::list<item> &submap::get_items( const int x, const int y ) const
+{
+    const auto it = itm.find( point( x, y ) );
+    if( it == itm.end() ) {
+        static const std::list<item> no_items;
+        return no_items;
+    }
+    return it->second;
+}
+
+std::list<item> &submap::get_items( const int x, const int y )
+{
+    return itm[point( x, y )];
+}
+
+bool submap::is_modified() const
+{
+    return modified_generation != saved_generation || !vehicles.empty() || comp != nullptr ||
+           camp.is_valid() || !active_items.empty();
+}
+
+bool submap::has_items( const int x, const int y ) const
+{
+    const auto it = itm.find( point( x, y ) );
+    return it != itm.end() && !it->second.empty();
+}
+
+void submap::remove_empty_item_lists()
+{
+    for( auto it = itm.begin(); it != itm.end(); ) {
+        if( it->second.empty() ) {
+            it = itm.erase( it );
+        } else {
+            ++it;
+        }
+    }
+}
+
 static const std::string COSMETICS_GRAFFITI( "GRAFFITI" );
 
 bool submap::has_graffiti( int x, int y ) const
@@ -53,10 +91,12 @@ void submap::set_graffiti( int x, int y, const std::string &new_graffiti )
 {
     is_uniform = false;
     cosmetics[x][y][COSMETICS_GRAFFITI] = new_graffiti;
+    mark_modified();
 }
 
 void submap::delete_graffiti( int x, int y )
 {
     is_uniform = false;
     cosmetics[x][y].erase( COSMETICS_GRAFFITI );
+    mark_modified();
 }
@@ -17,6 +17,7 @@
 #include <map>
 #include <string>
 #include <memory>
+#include <type_traits>
 
 class map;
 class vehicle;
@@ -55,6 +56,7 @@ struct submap {
     void set_trap( const int x, const int y, trap_id trap ) {
         is_uniform = false;
         trp[x][y] = trap;
+        mark_modified();
     }
 
     furn_id get_furn( const int x, const int y ) const {
@@ -64,6 +66,7 @@ struct submap {
     void set_furn( const int x, const int y, furn_id furn ) {
         is_uniform = false;
         frn[x][y] = furn;
+        mark_modified();
     }
 
     ter_id get_ter( const int x, const int y ) const {
@@ -73,6 +76,7 @@ struct submap {
     void set_ter( const int x, const int y, ter_id terr ) {
         is_uniform = false;
         ter[x][y] = terr;
+        mark_modified();
     }
 
     int get_radiation( const int x, const int y ) const {
@@ -82,6 +86,7 @@ struct submap {
     void set_radiation( const int x, const int y, const int radiation ) {
         is_uniform = false;
         rad[x][y] = radiation;
+        mark_modified();
     }
 
     void update_lum_add( item const &i, int const x, int const y ) {
@@ -103,7 +108,7 @@ struct submap {
         // Have to scan through all items to be sure removing i will actally lower
         // the count below 255.
         int count = 0;
-        for (auto const &it : itm[x][y]) {
+        for (auto const &it : get_items( x, y )) {
             if (it.is_emissive()) {
                 count++;
             }
@@ -114,6 +119,28 @@ struct submap {
         }
     }
 
+    /** Items on the square, an empty list if there are none. */
+    const std::list<item> &get_items( int x, int y ) const;
+    /**
+     * Items on the square that may be changed. The list is created if the square
+     * had no items, it stays valid until @ref remove_empty_item_lists is called.
+     */
+    std::list<item> &get_items( int x, int y );
+    bool has_items( int x, int y ) const;
+    /** Squares that have (or had) items, with their items. */
+    const std::map<point, std::list<item>> &get_item_lists() const {
+        return itm;
+    }
+    /** Same, the lists may be changed, but squares must not be added or removed. */
+    std::map<point, std::list<item>> &get_item_lists() {
+        return itm;
+    }
+    /**
+     * Drop the lists of squares that have no items anymore. References to those
+     * lists (e.g. in a @ref map_stack) become invalid.
+     */
+    void remove_empty_item_lists();
+
     bool has_graffiti( int x, int y ) const;
     const std::string &get_graffiti( int x, int y ) const;
     void set_graffiti( int x, int y, const std::string &new_graffiti );
@@ -144,18 +171,19 @@ struct submap {
     void set_signage( const int x, const int y, std::string s) {
         is_uniform = false;
         cosmetics[x][y]["SIGNAGE"] = s;
+        mark_modified();
     }
     // Can be used anytime (prevents code from needing to place sign first.)
     void delete_signage( const int x, const int y) {
         is_uniform = false;
         cosmetics[x][y].erase("SIGNAGE");
+        mark_modified();
     }
 
     // TODO: make trp private once the horrible hack known as editmap is resolved
     ter_id          ter[SEEX][SEEY];  // Terrain on each square
     furn_id         frn[SEEX][SEEY];  // Furniture on each square
     std::uint8_t    lum[SEEX][SEEY];  // Number of items emitting light on each square
-    std::list<item> itm[SEEX][SEEY];  // Items on each square
     field           fld[SEEX][SEEY];  // Field on each square
     trap_id         trp[SEEX][SEEY];  // Trap on each square
     int             rad[SEEX][SEEY];  // Irradiation of each square
@@ -164,6 +192,24 @@ struct submap {
     // Uniform submaps aren't saved/loaded, because regenerating them is faster
     bool is_uniform;
 
+    /**
+     * Counts the changes to this submap, the mutators increment it. Saving skips quads
+     * whose submaps did not change since they were loaded or last saved.
+     */
+    unsigned int modified_generation = 1;
+    /** @ref modified_generation as of the last load or save, 0 if it was never saved. */
+    unsigned int saved_generation = 0;
+    void mark_modified() {
+        modified_generation++;
+    }
+    /**
+     * Whether saving has to write this submap. Vehicles, computers, camps and active items
+     * change in too many places to track, submaps that have them are always written.
+     */
+    bool is_modified() const;
+    /** Value of the lookup counter of the mapbuffer when this was last looked up, see mapbuffer::evict. */
+    unsigned long last_lookup = 0;
+
     std::map<std::string, std::string> cosmetics[SEEX][SEEY]; // Textual "visuals" for each square.
 
     active_item_cache active_items;
@@ -186,24 +232,40 @@ struct submap {
     ~submap();
     // delete vehicles and clear the vehicles vector
     void delete_vehicles();
+
+private:
+    // Items of the squares that have any, most squares don't have items.
+    std::map<point, std::list<item>> itm;
 };
 
 /**
  * A wrapper for a submap point. Allows getting multiple map features
  * (terrain, furniture etc.) without directly accessing submaps or
  * doing multiple bounds checks and submap gets.
+ * @ref const_maptile refers to a const submap (which may be shared between several
+ * places, see @ref mapbuffer::lookup_shared_submap) and can only read it.
  */
-struct maptile {
+template<typename Submap>
+class maptile_impl
+{
 private:
     friend map; // To allow "sliding" the tile in x/y without bounds checks
     friend submap;
-    submap *const sm;
+    Submap *const sm;
     size_t x;
     size_t y;
 
-    maptile( submap *sub, const size_t nx, const size_t ny ) :
+    maptile_impl( Submap *sub, const size_t nx, const size_t ny ) :
         sm( sub ), x( nx ), y( ny ) { }
 public:
+    /** A writable tile can be used as a read only tile. */
+    template<typename OtherSubmap, typename = typename std::enable_if<
+                 std::is_convertible<OtherSubmap *, Submap *>::value>::type>
+    maptile_impl( const maptile_impl<OtherSubmap> &other ) :
+        sm( other.sm ), x( other.x ), y( other.y ) { }
+    template<typename OtherSubmap>
+    friend class maptile_impl;
+
     trap_id get_trap() const
     {
         return sm->get_trap( x, y );
@@ -281,13 +343,16 @@ public:
     // For map::draw_maptile
     size_t get_item_count() const
     {
-        return sm->itm[x][y].size();
+        return sm->get_items( x, y ).size();
     }
 
     const item &get_uppermost_item() const
     {
-        return sm->itm[x][y].back();
+        return sm->get_items( x, y ).back();
     }
 };
 
+using maptile = maptile_impl<submap>;
+using const_maptile = maptile_impl<const submap>;
+
 #endif
@@ -3659,6 +3659,21 @@ void vehicle::power_parts()
     }
 }
 
+bool vehicle::needs_processing_off_map() const
+{
+    // power_parts
+    if( engine_on || is_alarm_on || camera_on || has_part( "REACTOR", true ) ||
+        !get_parts( VPFLAG_ENABLED_DRAINS_EPOWER, true ).empty() ) {
+        return true;
+    }
+    // idle, in the same order, the alarm and update_time only run on the map.
+    // An enabled planter is turned off once it gets too cold, which can happen at any time.
+    if( has_part( "PLANTER", true ) ) {
+        return true;
+    }
+    return has_part( "STEREO", true ) || has_part( "CHIMES", true );
+}
+
 vehicle* vehicle::find_vehicle( const tripoint &where )
 {
     // Is it in the reality bubble?
@@ -3673,7 +3688,7 @@ vehicle* vehicle::find_vehicle( const tripoint &where )
     point veh_in_sm = point( where.x, where.y );
     point veh_sm = ms_to_sm_remain( veh_in_sm );
 
-    auto sm = MAPBUFFER.lookup_submap( veh_sm.x, veh_sm.y, where.z );
+    const submap *sm = MAPBUFFER.lookup_shared_submap( tripoint( veh_sm.x, veh_sm.y, where.z ) );
     if( sm == nullptr ) {
         return nullptr;
     }
@@ -5971,7 +5986,7 @@ bool is_sm_tile_outside( const tripoint &real_global_pos )
     const tripoint smp = ms_to_sm_copy( real_global_pos );
     const int px = modulo( real_global_pos.x, SEEX );
     const int py = modulo( real_global_pos.y, SEEY );
-    auto sm = MAPBUFFER.lookup_submap( smp );
+    const submap *sm = MAPBUFFER.lookup_shared_submap( smp );
     if( sm == nullptr ) {
         debugmsg( "is_sm_tile_outside(): couldn't find submap %d,%d,%d", smp.x, smp.y, smp.z );
         return false;
@@ -842,6 +842,13 @@ public:
     std::vector<vehicle_part *> lights( bool active = false );
 
     void power_parts();
+    /**
+     * Whether @ref power_parts or @ref idle change anything while the vehicle is outside
+     * the reality bubble: an engine, the alarm, the cameras, a reactor, a stereo, chimes
+     * or an electric consumer is on, or a planter is on (idle turns it off when it gets
+     * too cold).
+     */
+    bool needs_processing_off_map() const;
 
     /**
      * Try to charge our (and, optionally, connected vehicles') batteries by the given amount.
@@ -1304,6 +1311,7 @@ public:
     bool check_environmental_effects= false; // has bloody or smoking parts
     bool insides_dirty              = true;  // "inside" flags are outdated and need refreshing
     bool falling                    = false; // Is the vehicle hanging in the air and expected to fall down in the next turn?
+    bool asleep                     = false; // not processed outside the reality bubble, see game::do_turn
 
 private:
     void refresh_pivot() const;                // refresh pivot_cache, clear pivot_dirty
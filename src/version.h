@@ -0,0 +1 @@
+#define VERSION "41a938d-dirty"
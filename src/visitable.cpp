@@ -3,6 +3,7 @@
 #include "string_id.h"
 #include "debug.h"
 #include "item.h"
+#include "flag.h"
 #include "inventory.h"
 #include "character.h"
 #include "map_selector.h"
@@ -638,8 +639,13 @@ std::list<item> visitable<map_cursor>::remove_items_with( const
     // fetch the appropriate item stack
     int x, y;
     submap *sub = g->m.get_submap_at( *cur, x, y );
+    if( !sub->has_items( x, y ) ) {
+        return res;
+    }
+    sub->mark_modified();
 
-    for( auto iter = sub->itm[ x ][ y ].begin(); iter != sub->itm[ x ][ y ].end(); ) {
+    auto &items = sub->get_items( x, y );
+    for( auto iter = items.begin(); iter != items.end(); ) {
         if( filter( *iter ) ) {
             // check for presence in the active items cache
             if( sub->active_items.has( iter, point( x, y ) ) ) {
@@ -650,7 +656,7 @@ std::list<item> visitable<map_cursor>::remove_items_with( const
             sub->update_lum_rem( *iter, x, y );
 
             // finally remove the item
-            res.splice( res.end(), sub->itm[ x ][ y ], iter++ );
+            res.splice( res.end(), items, iter++ );
 
             if( --count == 0 ) {
                 return res;
@@ -743,21 +749,23 @@ std::list<item> visitable<vehicle_selector>::remove_items_with( const
     return res;
 }
 
+static const flag_int_id flag_PSEUDO = json_flag::intern( "PSEUDO" );
+
 template <typename T>
-static long charges_of_internal( const T &self, const itype_id &id, long limit )
+static long charges_of_internal( const T &self, const itype_int_id &id, long limit )
 {
     long qty = 0;
 
     self.visit_items( [&]( const item * e ) {
         if( e->is_tool() ) {
-            if( e->typeId() == id ) {
+            if( e->typeIndex() == id ) {
                 // includes charges from any included magazine.
                 qty = sum_no_wrap( qty, e->ammo_remaining() );
             }
             return qty < limit ? VisitResponse::SKIP : VisitResponse::ABORT;
 
         } else if( e->count_by_charges() ) {
-            if( e->typeId() == id ) {
+            if( e->typeIndex() == id ) {
                 qty = sum_no_wrap( qty, e->charges );
             }
             // items counted by charges are not themselves expected to be containers
@@ -774,13 +782,20 @@ static long charges_of_internal( const T &self, const itype_id &id, long limit )
 /** @relates visitable */
 template <typename T>
 long visitable<T>::charges_of( const std::string &what, long limit ) const
+{
+    return charges_of( item::find_type_index( what ), limit );
+}
+
+/** @relates visitable */
+template <typename T>
+long visitable<T>::charges_of( const itype_int_id &what, long limit ) const
 {
     return charges_of_internal( *this, what, limit );
 }
 
 /** @relates visitable */
 template <>
-long visitable<inventory>::charges_of( const std::string &what, long limit ) const
+long visitable<inventory>::charges_of( const itype_int_id &what, long limit ) const
 {
     const auto &binned = static_cast<const inventory *>( this )->get_binned_items();
     const auto iter = binned.find( what );
@@ -824,15 +839,23 @@ long visitable<Character>::charges_of( const std::string &what, long limit ) con
         return std::min( qty, limit );
     }
 
-    return charges_of_internal( *this, what, limit );
+    return charges_of_internal( *this, item::find_type_index( what ), limit );
+}
+
+/** @relates visitable */
+template <>
+long visitable<Character>::charges_of( const itype_int_id &what, long limit ) const
+{
+    // The pseudo items provided by bionics are handled by their string id.
+    return what.is_valid() ? charges_of( what->get_id(), limit ) : 0;
 }
 
 template <typename T>
-static int amount_of_internal( const T &self, const itype_id &id, bool pseudo, int limit )
+static int amount_of_internal( const T &self, const itype_int_id &id, bool pseudo, int limit )
 {
     int qty = 0;
     self.visit_items( [&qty, &id, &pseudo, &limit]( const item * e ) {
-        if( e->typeId() == id && e->allow_crafting_component() && ( pseudo || !e->has_flag( "PSEUDO" ) ) ) {
+        if( e->typeIndex() == id && e->allow_crafting_component() && ( pseudo || !e->has_flag( flag_PSEUDO ) ) ) {
             qty = sum_no_wrap( qty, 1 );
         }
         return qty != limit ? VisitResponse::NEXT : VisitResponse::ABORT;
@@ -843,13 +866,20 @@ static int amount_of_internal( const T &self, const itype_id &id, bool pseudo, i
 /** @relates visitable */
 template <typename T>
 int visitable<T>::amount_of( const std::string &what, bool pseudo, int limit ) const
+{
+    return amount_of( item::find_type_index( what ), pseudo, limit );
+}
+
+/** @relates visitable */
+template <typename T>
+int visitable<T>::amount_of( const itype_int_id &what, bool pseudo, int limit ) const
 {
     return amount_of_internal( *this, what, pseudo, limit );
 }
 
 /** @relates visitable */
 template <>
-int visitable<inventory>::amount_of( const std::string &what, bool pseudo, int limit ) const
+int visitable<inventory>::amount_of( const itype_int_id &what, bool pseudo, int limit ) const
 {
     const auto &binned = static_cast<const inventory *>( this )->get_binned_items();
     const auto iter = binned.find( what );
@@ -886,7 +916,15 @@ int visitable<Character>::amount_of( const std::string &what, bool pseudo, int l
         return std::min( qty, limit );
     }
 
-    return amount_of_internal( *this, what, pseudo, limit );
+    return amount_of_internal( *this, item::find_type_index( what ), pseudo, limit );
+}
+
+/** @relates visitable */
+template <>
+int visitable<Character>::amount_of( const itype_int_id &what, bool pseudo, int limit ) const
+{
+    // The pseudo items provided by bionics are handled by their string id.
+    return what.is_valid() ? amount_of( what->get_id(), pseudo, limit ) : 0;
 }
 
 // explicit template initialization for all classes implementing the visitable interface
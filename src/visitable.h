@@ -11,8 +11,12 @@
 class item;
 template<typename T>
 class string_id;
+template<typename T>
+class int_id;
 struct quality;
 using quality_id = string_id<quality>;
+struct itype;
+using itype_int_id = int_id<itype>;
 
 enum class VisitResponse {
     ABORT, // Stop processing after this node
@@ -76,6 +80,8 @@ class visitable
          * @param limit stop searching after this many charges have been found
          */
         long charges_of( const std::string &what, long limit = std::numeric_limits<long>::max() ) const;
+        /** @copydoc charges_of(const std::string &, long) const */
+        long charges_of( const itype_int_id &what, long limit = std::numeric_limits<long>::max() ) const;
 
         /**
          * Count items matching id including both this instance and any contained items
@@ -86,11 +92,18 @@ class visitable
          */
         int amount_of( const std::string &what, bool pseudo = true,
                        int limit = std::numeric_limits<int>::max() ) const;
+        /** @copydoc amount_of(const std::string &, bool, int) const */
+        int amount_of( const itype_int_id &what, bool pseudo = true,
+                       int limit = std::numeric_limits<int>::max() ) const;
 
         /** Check instance provides at least qty of an item (@see amount_of) */
         bool has_amount( const std::string &what, int qty, bool pseudo = true ) const {
             return amount_of( what, pseudo, qty ) == qty;
         }
+        /** @copydoc has_amount(const std::string &, int, bool) const */
+        bool has_amount( const itype_int_id &what, int qty, bool pseudo = true ) const {
+            return amount_of( what, pseudo, qty ) == qty;
+        }
 
         /** Returns all items (including those within a container) matching the filter */
         std::vector<item *> items_with( const std::function<bool( const item & )> &filter );
@@ -16,8 +16,10 @@
 #include "cata_utility.h"
 #include "player.h"
 
+#include <cmath>
 #include <vector>
 #include <sstream>
+#include <unordered_map>
 
 const efftype_id effect_glare( "glare" );
 const efftype_id effect_blind( "blind" );
@@ -117,32 +119,149 @@ inline void proc_weather_sum( const weather_type wtype, weather_sum &data,
     data.sunlight += std::max<float>( 0.0f, tick_size * tick_sunlight );
 }
 
-////// Funnels.
-weather_sum sum_conditions( const calendar &startturn,
-                            const calendar &endturn,
-                            const tripoint &location )
+namespace
 {
-    int tick_size = MINUTES(1);
-    weather_sum data;
 
-    const auto wgen = g->get_cur_weather_gen();
-    for( calendar turn(startturn); turn < endturn; turn += tick_size ) {
-        const int diff = endturn - startturn;
-        if( diff <= 0 ) {
+int divide( int v, int m )
+{
+    if( v >= 0 ) {
+        return v / m;
+    }
+    return ( v - m + 1 ) / m;
+}
+
+/**
+ * The weather conditions of one generator, sampled every @ref sample_turns turns for cells of
+ * @ref cell_size squares, with running totals so the weather between any two turns can be
+ * summed up in constant time.
+ * The weather is taken to be the same during a whole sample, partial samples count pro rata.
+ */
+class weather_timeline
+{
+    public:
+        static constexpr int sample_turns = MINUTES( 10 );
+        static constexpr int cell_size = 5 * SEEX * 2;
+
+        weather_sum sum( const weather_generator &wgen, unsigned seed, int startturn, int endturn,
+                         const tripoint &location ) {
+            if( &wgen != gen || seed != gen_seed || calendar::season_length() != gen_season_length ) {
+                cells.clear();
+                gen = &wgen;
+                gen_seed = seed;
+                gen_season_length = calendar::season_length();
+            }
+            if( cells.size() > max_cells ) {
+                cells.clear();
+            }
+            const point pos( divide( location.x, cell_size ), divide( location.y, cell_size ) );
+            cell &c = cells[pos];
+            cover( c, pos, divide( startturn, sample_turns ), divide( endturn, sample_turns ) );
+
+            const totals from = total_at( c, startturn );
+            const totals to = total_at( c, endturn );
+            weather_sum data;
+            data.rain_amount = std::lround( to.rain - from.rain );
+            data.acid_amount = std::lround( to.acid - from.acid );
+            data.sunlight = to.sunlight - from.sunlight;
             return data;
-        } else if( diff < 10 ) {
-            tick_size = 1;
-        } else if( diff > DAYS(7) ) {
-            tick_size = HOURS(1);
-        } else {
-            tick_size = MINUTES(1);
         }
 
-        const auto wtype = wgen.get_weather_conditions( location, turn, g->get_seed() );
-        proc_weather_sum( wtype, data, turn, tick_size );
-    }
+    private:
+        /** Cells are dropped all at once when there are more than this. */
+        static constexpr size_t max_cells = 64;
+
+        struct totals {
+            double rain = 0;
+            double acid = 0;
+            double sunlight = 0;
+        };
+        struct cell {
+            /** Index of the first sample. */
+            int first = 0;
+            /** prefix[i] is the total of the samples before `first + i`. */
+            std::vector<totals> prefix;
+        };
+
+        const weather_generator *gen = nullptr;
+        unsigned gen_seed = 0;
+        int gen_season_length = 0;
+        std::unordered_map<point, cell> cells;
+
+        totals sample( const point &pos, int index ) const {
+            const tripoint location( pos.x * cell_size + cell_size / 2, pos.y * cell_size + cell_size / 2, 0 );
+            const calendar turn( index * sample_turns + sample_turns / 2 );
+            weather_sum data;
+            proc_weather_sum( gen->get_weather_conditions( location, turn, gen_seed ), data, turn,
+                              sample_turns );
+            totals result;
+            result.rain = data.rain_amount;
+            result.acid = data.acid_amount;
+            result.sunlight = data.sunlight;
+            return result;
+        }
+
+        /** Makes sure the samples `first` to `last` (both included) of the cell exist. */
+        void cover( cell &c, const point &pos, int first, int last ) {
+            if( c.prefix.empty() ) {
+                c.first = first;
+                c.prefix.emplace_back();
+            }
+            if( first < c.first ) {
+                // Rare (only when going back in time), simply rebuild the totals.
+                std::vector<totals> prefix( 1 );
+                for( int i = first; i < c.first; i++ ) {
+                    prefix.push_back( add( prefix.back(), sample( pos, i ) ) );
+                }
+                const totals offset = prefix.back();
+                for( size_t i = 1; i < c.prefix.size(); i++ ) {
+                    prefix.push_back( add( offset, c.prefix[i] ) );
+                }
+                c.first = first;
+                c.prefix = std::move( prefix );
+            }
+            for( int i = c.first + int( c.prefix.size() ) - 1; i <= last; i++ ) {
+                c.prefix.push_back( add( c.prefix.back(), sample( pos, i ) ) );
+            }
+        }
+
+        totals total_at( const cell &c, int turn ) const {
+            const int index = divide( turn, sample_turns ) - c.first;
+            const double part = double( turn - divide( turn, sample_turns ) * sample_turns ) / sample_turns;
+            const totals &before = c.prefix[index];
+            const totals &after = c.prefix[index + 1];
+            totals result;
+            result.rain = before.rain + ( after.rain - before.rain ) * part;
+            result.acid = before.acid + ( after.acid - before.acid ) * part;
+            result.sunlight = before.sunlight + ( after.sunlight - before.sunlight ) * part;
+            return result;
+        }
+
+        static totals add( const totals &a, const totals &b ) {
+            totals result;
+            result.rain = a.rain + b.rain;
+            result.acid = a.acid + b.acid;
+            result.sunlight = a.sunlight + b.sunlight;
+            return result;
+        }
+};
+
+constexpr int weather_timeline::sample_turns;
+constexpr int weather_timeline::cell_size;
+constexpr size_t weather_timeline::max_cells;
 
-    return data;
+weather_timeline timeline;
+
+} // namespace
+
+////// Funnels.
+weather_sum sum_conditions( const calendar &startturn,
+                            const calendar &endturn,
+                            const tripoint &location )
+{
+    if( endturn <= startturn ) {
+        return weather_sum();
+    }
+    return timeline.sum( g->get_cur_weather_gen(), g->get_seed(), startturn, endturn, location );
 }
 
 /**
@@ -155,8 +274,18 @@ void retroactively_fill_from_funnel( item &it, const trap &tr, int startturn, in
         return;
     }
 
+    retroactively_fill_from_funnel( it, tr, startturn, endturn,
+                                    sum_conditions( startturn, endturn, location ) );
+}
+
+void retroactively_fill_from_funnel( item &it, const trap &tr, int startturn, int endturn,
+                                     const weather_sum &data )
+{
+    if( startturn > endturn || !tr.is_funnel() ) {
+        return;
+    }
+
     it.set_birthday( endturn ); // bday == last fill check
-    auto data = sum_conditions( startturn, endturn, location );
 
     // Technically 0.0 division is OK, but it will be cleaner without it
     if( data.rain_amount > 0 ) {
@@ -561,7 +690,7 @@ std::string weather_forecast( point const &abs_sm_pos )
     int last_hour = calendar::turn - ( calendar::turn % HOURS(1) );
     for(int d = 0; d < 6; d++) {
         weather_type forecast = WEATHER_NULL;
-        const auto wgen = g->get_cur_weather_gen();
+        const auto &wgen = g->get_cur_weather_gen();
         for(calendar i(last_hour + 7200 * d); i < last_hour + 7200 * (d + 1); i += 600) {
             w_point w = wgen.get_weather( abs_ms_pos, i, g->get_seed() );
             forecast = std::max( forecast, wgen.get_weather_conditions( w ) );
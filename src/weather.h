@@ -160,6 +160,12 @@ weather_sum sum_conditions( const calendar &startturn,
  */
 void retroactively_fill_from_funnel( item &it, const trap &tr, int startturn, int endturn,
                                      const tripoint &pos );
+/**
+ * Same as above, but with the weather from `startturn` to `endturn` already summed up by
+ * @ref sum_conditions, so that funnels close to each other can share it.
+ */
+void retroactively_fill_from_funnel( item &it, const trap &tr, int startturn, int endturn,
+                                     const weather_sum &weather );
 
 double funnel_charges_per_turn( double surface_area_mm2, double rain_depth_mm_per_hour );
 
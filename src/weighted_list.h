@@ -93,7 +93,7 @@ template <typename W, typename T> struct weighted_list {
             }
         }
         const T *pick() const {
-            return pick( rand() );
+            return pick( rng_rand() );
         }
 
         /**
@@ -110,7 +110,7 @@ template <typename W, typename T> struct weighted_list {
             }
         }
         T *pick() {
-            return pick( rand() );
+            return pick( rng_rand() );
         }
 
         /**
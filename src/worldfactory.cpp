@@ -257,6 +257,7 @@ WORLDPTR worldfactory::convert_to_world(std::string origin_path)
 void worldfactory::set_active_world(WORLDPTR world)
 {
     world_generator->active_world = world;
+    options_manager::changed();
 }
 
 bool worldfactory::save_world(WORLDPTR world, bool is_conversion)
@@ -591,6 +592,7 @@ void worldfactory::remove_world(std::string worldname)
         WORLDPTR wptr = it->second;
         if( active_world == wptr ) {
             active_world = nullptr;
+            options_manager::changed();
         }
         delete wptr;
         all_worlds.erase( it );
@@ -1406,6 +1408,7 @@ void WORLD::load_legacy_options( std::istream &fin )
 bool worldfactory::load_world_options(WORLDPTR &world)
 {
     world->WORLD_OPTIONS = get_options().get_world_defaults();
+    options_manager::changed();
 
     using namespace std::placeholders;
     const auto path = world->world_path + "/" + FILENAMES["worldoptions"];
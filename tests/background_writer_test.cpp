@@ -0,0 +1,61 @@
+#include "catch/catch.hpp"
+
+#include "background_writer.h"
+#include "filesystem.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+static std::string file_contents( const std::string &path )
+{
+    std::ifstream fin( path, std::ios::binary );
+    std::ostringstream contents;
+    contents << fin.rdbuf();
+    return contents.str();
+}
+
+TEST_CASE( "write_file_atomic_replaces_the_file" )
+{
+    const std::string path = "background_writer_test.txt";
+    write_file_atomic( path, "old" );
+    write_file_atomic( path, "new contents" );
+    CHECK( file_contents( path ) == "new contents" );
+    CHECK_FALSE( file_exist( path + ".tmp" ) );
+    remove_file( path );
+}
+
+TEST_CASE( "background_writer_writes_in_order" )
+{
+    const std::string path = "background_writer_test.txt";
+    background_writer writer;
+    writer.add( path, "first" );
+    writer.add( path, "second" );
+    writer.start();
+    writer.wait_for( path );
+    CHECK( file_contents( path ) == "second" );
+
+    writer.add( path, "third" );
+    writer.wait();
+    CHECK( file_contents( path ) == "third" );
+    remove_file( path );
+
+    writer.add( "no_such_directory/file.txt", "contents" );
+    writer.start();
+    CHECK_THROWS( writer.wait() );
+    // The error is only reported once.
+    CHECK_NOTHROW( writer.wait() );
+}
+
+TEST_CASE( "background_writer_discards_unstarted_files" )
+{
+    const std::string path = "background_writer_test.txt";
+    background_writer writer;
+    writer.add( path, "written" );
+    writer.start();
+    writer.add( path, "discarded" );
+    writer.discard();
+    writer.wait();
+    CHECK( file_contents( path ) == "written" );
+    remove_file( path );
+}
@@ -0,0 +1,60 @@
+#include "catch/catch.hpp"
+
+#include "calendar.h"
+#include "flag.h"
+#include "item.h"
+#include "itype.h"
+
+#include <set>
+#include <string>
+
+TEST_CASE( "flag_set_behaves_like_a_set_of_names" )
+{
+    flag_set flags;
+    CHECK( flags.empty() );
+
+    flags.insert( "TEST_FLAG_B" );
+    flags.insert( "TEST_FLAG_A" );
+    flags.insert( "TEST_FLAG_A" );
+    CHECK( flags.size() == 2 );
+    CHECK( flags.count( "TEST_FLAG_A" ) == 1 );
+    CHECK( flags.count( json_flag::find( "TEST_FLAG_B" ) ) == 1 );
+    CHECK( flags.count( "TEST_FLAG_NEVER_USED" ) == 0 );
+    CHECK_FALSE( json_flag::find( "TEST_FLAG_NEVER_USED" ).is_valid() );
+    CHECK( flags.names() == std::set<std::string>( { "TEST_FLAG_A", "TEST_FLAG_B" } ) );
+
+    // Flags that don't fit into the bits are kept separately.
+    flag_set many;
+    for( size_t i = 0; i < flag_set::bit_count + 10; i++ ) {
+        many.insert( "TEST_FLAG_" + std::to_string( i ) );
+    }
+    CHECK( many.size() == flag_set::bit_count + 10 );
+    const std::string last = "TEST_FLAG_" + std::to_string( flag_set::bit_count + 9 );
+    CHECK( many.count( last ) == 1 );
+    many.erase( last );
+    CHECK( many.count( last ) == 0 );
+    CHECK( many.size() == flag_set::bit_count + 9 );
+
+    flags.erase( "TEST_FLAG_A" );
+    flags.erase( "TEST_FLAG_B" );
+    CHECK( flags.empty() );
+    CHECK( flags == flag_set() );
+}
+
+TEST_CASE( "item_flags_by_int_id" )
+{
+    item rock( "rock", calendar::turn );
+    const flag_int_id wet = json_flag::intern( "WET" );
+
+    CHECK_FALSE( rock.has_flag( wet ) );
+    rock.set_flag( "WET" );
+    CHECK( rock.has_flag( wet ) );
+    CHECK( rock.has_flag( "WET" ) );
+    rock.unset_flag( "WET" );
+    CHECK_FALSE( rock.has_flag( wet ) );
+
+    // Flags of the item type.
+    for( const std::string &flag : rock.type->item_tags ) {
+        CHECK( rock.has_flag( json_flag::find( flag ) ) );
+    }
+}
@@ -0,0 +1,88 @@
+#include "catch/catch.hpp"
+
+#include "calendar.h"
+#include "item.h"
+#include "mtype.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+TEST_CASE( "item_copies_keep_their_own_rare_data" )
+{
+    item rock( "rock" );
+    rock.set_var( "test_var", 1 );
+    item copy = rock;
+    CHECK( copy.get_var( "test_var", 0 ) == 1 );
+
+    copy.set_var( "test_var", 2 );
+    CHECK( rock.get_var( "test_var", 0 ) == 1 );
+    CHECK( copy.get_var( "test_var", 0 ) == 2 );
+    CHECK_FALSE( rock.stacks_with( copy ) );
+
+    copy.set_var( "test_var", 1 );
+    CHECK( rock.stacks_with( copy ) );
+    copy.erase_var( "test_var" );
+    CHECK_FALSE( copy.has_var( "test_var" ) );
+    CHECK( rock.has_var( "test_var" ) );
+
+    const item corpse = item::make_corpse( mtype_id( "mon_zombie" ), calendar::turn, "Bob" );
+    const item corpse_copy = corpse;
+    CHECK( corpse_copy.get_mtype() == corpse.get_mtype() );
+    CHECK( corpse_copy.tname() == corpse.tname() );
+}
+
+TEST_CASE( "item_vars_keep_their_saved_strings" )
+{
+    item it( "rock" );
+    it.set_var( "int_var", 42 );
+    it.set_var( "long_var", -7L );
+    it.set_var( "real_var", 1.5 );
+    it.set_var( "text_var", "some text" );
+    it.set_var( "number_text_var", "3.25" );
+
+    // Numbers read as strings look like they always did.
+    CHECK( it.get_var( "int_var" ) == "42" );
+    CHECK( it.get_var( "long_var" ) == "-7" );
+    CHECK( it.get_var( "real_var" ) == "1.500000" );
+    CHECK( it.get_var( "int_var", 0.0 ) == 42 );
+    CHECK( it.get_var( "real_var", 0.0 ) == 1.5 );
+    CHECK( it.get_var( "number_text_var", 0.0 ) == 3.25 );
+    CHECK( it.get_var( "text_var", 0.0 ) == 0 );
+    CHECK( it.get_var( "unset_var", 2.0 ) == 2 );
+    CHECK( it.get_var( "unset_var", "default" ) == "default" );
+
+    // A number and the same number as string are the same variable value.
+    item other( "rock" );
+    other.set_var( "int_var", "42" );
+    other.set_var( "long_var", -7 );
+    other.set_var( "real_var", "1.500000" );
+    other.set_var( "text_var", "some text" );
+    other.set_var( "number_text_var", "3.25" );
+    CHECK( it.stacks_with( other ) );
+
+    item loaded;
+    loaded.deserialize( it.serialize() );
+    CHECK( loaded.get_var( "int_var" ) == "42" );
+    CHECK( loaded.get_var( "real_var" ) == "1.500000" );
+    CHECK( loaded.get_var( "text_var" ) == "some text" );
+    CHECK( loaded.get_var( "number_text_var" ) == "3.25" );
+    CHECK( loaded.stacks_with( it ) );
+    CHECK( loaded.serialize() == it.serialize() );
+
+    it.erase_var( "int_var" );
+    CHECK_FALSE( it.has_var( "int_var" ) );
+    CHECK( it.has_var( "long_var" ) );
+}
+
+TEST_CASE( "item_memory_use", "[.][benchmark]" )
+{
+    std::vector<item> items( 100000, item( "rock" ) );
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<item> copies = items;
+    const std::chrono::duration<double, std::milli> copy_time = std::chrono::steady_clock::now() - start;
+    printf( "sizeof( item ) = %zu, sizeof( item_cold_data ) = %zu\n", sizeof( item ),
+            sizeof( item_cold_data ) );
+    printf( "%zu items use %zu bytes inline, copying them took %.2f ms\n", copies.size(),
+            copies.size() * sizeof( item ), copy_time.count() );
+}
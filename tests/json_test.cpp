@@ -0,0 +1,130 @@
+#include "catch/catch.hpp"
+
+#include "json.h"
+
+#include <sstream>
+#include <string>
+
+/** Parses @p text with a JsonIn on the text in memory. */
+template<typename F>
+static void parse( const std::string &text, F f )
+{
+    JsonIn jsin( text.data(), text.size() );
+    f( jsin );
+}
+
+/** The message of the JsonError thrown by @p f on @p text. */
+template<typename F>
+static std::string parse_error( const std::string &text, F f )
+{
+    try {
+        parse( text, f );
+    } catch( const JsonError &err ) {
+        return err.what();
+    }
+    return "no error";
+}
+
+TEST_CASE( "json_strings_with_escapes" )
+{
+    parse( R"("a\"b\\c\/d\b\f\n\r\t\u00e9\u20ac")", []( JsonIn & jsin ) {
+        CHECK( jsin.get_string() == "a\"b\\c/d\b\f\n\r\t\xc3\xa9\xe2\x82\xac" );
+    } );
+    // Long enough to be scanned eight bytes at a time, with bytes above 0x7f.
+    const std::string utf8 = "\xc3\xa4\xc3\xb6\xc3\xbc\xc3\x9f \xe2\x82\xac\xe2\x82\xac\xe2\x82\xac";
+    parse( "\"" + utf8 + utf8 + "\\\"" + utf8 + "\" ", [&utf8]( JsonIn & jsin ) {
+        CHECK( jsin.get_string() == utf8 + utf8 + "\"" + utf8 );
+    } );
+    parse( "[\"" + utf8 + utf8 + "\", 1]", []( JsonIn & jsin ) {
+        jsin.start_array();
+        jsin.skip_value();
+        CHECK( jsin.get_int() == 1 );
+    } );
+    CHECK( parse_error( "\"" + utf8 + utf8 + "\nrest\"", []( JsonIn & jsin ) {
+        jsin.get_string();
+    } ).find( "reached end of line" ) != std::string::npos );
+}
+
+TEST_CASE( "json_strings_cut_off_at_the_end" )
+{
+    CHECK( parse_error( R"("unterminated)", []( JsonIn & jsin ) {
+        jsin.get_string();
+    } ).find( "couldn't find end of string" ) != std::string::npos );
+    CHECK( parse_error( R"("trailing backslash\)", []( JsonIn & jsin ) {
+        jsin.get_string();
+    } ).find( "couldn't find end of string" ) != std::string::npos );
+    // Skipping doesn't check the string, it just ends with the data.
+    parse( R"(["unterminated)", []( JsonIn & jsin ) {
+        jsin.start_array();
+        jsin.skip_value();
+        CHECK_FALSE( jsin.good() );
+        CHECK( jsin.line_number() == "EOF" );
+    } );
+}
+
+TEST_CASE( "json_values_at_the_end_of_the_data" )
+{
+    parse( "123", []( JsonIn & jsin ) {
+        CHECK( jsin.get_int() == 123 );
+        CHECK_FALSE( jsin.good() );
+    } );
+    parse( "-1.5e2", []( JsonIn & jsin ) {
+        CHECK( jsin.get_float() == Approx( -150.0 ) );
+    } );
+    parse( "true", []( JsonIn & jsin ) {
+        CHECK( jsin.get_bool() );
+    } );
+
+    // Reading beyond the end is reported as such.
+    CHECK( parse_error( "tru", []( JsonIn & jsin ) {
+        jsin.get_bool();
+    } ).find( "EOF" ) == 0 );
+    CHECK( parse_error( "fals", []( JsonIn & jsin ) {
+        jsin.get_bool();
+    } ).find( "EOF" ) == 0 );
+    CHECK( parse_error( "[nul", []( JsonIn & jsin ) {
+        jsin.start_array();
+        jsin.skip_value();
+    } ).find( "EOF" ) == 0 );
+    CHECK( parse_error( "[tr", []( JsonIn & jsin ) {
+        jsin.start_array();
+        jsin.skip_value();
+    } ).find( "EOF" ) == 0 );
+}
+
+TEST_CASE( "json_line_number_is_eof_only_after_reading_past_the_end" )
+{
+    parse( "[1,\n2]", []( JsonIn & jsin ) {
+        jsin.seek( 6 );
+        CHECK( jsin.line_number() == "line 2:3" );
+        jsin.peek();
+        CHECK( jsin.line_number() == "EOF" );
+        jsin.seek( 4 );
+        CHECK( jsin.line_number() == "line 2:1" );
+    } );
+}
+
+TEST_CASE( "json_from_a_stream_leaves_it_after_the_value" )
+{
+    std::istringstream in( "prefix [1, 2], rest" );
+    std::string word;
+    in >> word;
+    {
+        JsonIn jsin( in );
+        // Positions are offsets into the whole stream.
+        CHECK( jsin.tell() == 6 );
+        jsin.start_array();
+        CHECK( jsin.get_int() == 1 );
+        CHECK( jsin.get_int() == 2 );
+        CHECK( jsin.end_array() );
+    }
+    in >> word;
+    CHECK( word == "rest" );
+
+    std::istringstream number( "42" );
+    {
+        JsonIn jsin( number );
+        CHECK( jsin.get_int() == 42 );
+    }
+    CHECK( number.eof() );
+}
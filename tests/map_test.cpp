@@ -1,11 +1,22 @@
 #include "catch/catch.hpp"
 
+#include "background_writer.h"
+#include "coordinate_conversions.h"
 #include "game.h"
 #include "map.h"
+#include "mapbuffer.h"
+#include "field.h"
+#include "flag.h"
+#include "mapdata.h"
+#include "options.h"
 #include "player.h"
+#include "trap.h"
+#include "submap.h"
 
 #include "map_helpers.h"
 
+#include <algorithm>
+
 TEST_CASE( "destroy_grabbed_furniture" )
 {
     clear_map();
@@ -25,3 +36,254 @@ TEST_CASE( "destroy_grabbed_furniture" )
         }
     }
 }
+
+TEST_CASE( "uniform_submaps_are_shared_until_written" )
+{
+    const tripoint first( -5000, -5000, -5 );
+    const tripoint second( -5000, -4999, -5 );
+    REQUIRE( MAPBUFFER.add_uniform_submap( first, t_rock ) );
+    REQUIRE( MAPBUFFER.add_uniform_submap( second, t_rock ) );
+    CHECK_FALSE( MAPBUFFER.add_uniform_submap( first, t_rock ) );
+
+    const submap *shared = MAPBUFFER.lookup_shared_submap( first );
+    REQUIRE( shared != nullptr );
+    CHECK( MAPBUFFER.is_shared( shared ) );
+    CHECK( MAPBUFFER.lookup_shared_submap( second ) == shared );
+
+    submap *const own = MAPBUFFER.lookup_submap( first );
+    REQUIRE( own != nullptr );
+    CHECK_FALSE( MAPBUFFER.is_shared( own ) );
+    CHECK( own->is_uniform );
+    CHECK( own->get_ter( 5, 5 ) == t_rock );
+    CHECK( MAPBUFFER.lookup_shared_submap( first ) == own );
+
+    own->set_ter( 5, 5, t_rock_floor );
+    CHECK( MAPBUFFER.lookup_shared_submap( second )->get_ter( 5, 5 ) == t_rock );
+}
+
+TEST_CASE( "maps_see_shared_submaps_copied_by_others" )
+{
+    const tripoint origin( -6000, -6000, -5 );
+    for( int x = 0; x < 2; x++ ) {
+        for( int y = 0; y < 2; y++ ) {
+            REQUIRE( MAPBUFFER.add_uniform_submap( origin + tripoint( x, y, 0 ), t_rock ) );
+        }
+    }
+    tinymap reader;
+    reader.load( origin.x, origin.y, origin.z, false );
+    const map &view = reader;
+    const tripoint p( 5, 5, origin.z );
+    REQUIRE( view.ter( p ) == t_rock );
+
+    // Another map writes to the same position, which gives it its own submap.
+    MAPBUFFER.lookup_submap( origin )->set_ter( 5, 5, t_rock_floor );
+    CHECK( view.ter( p ) == t_rock_floor );
+    CHECK( reader.ter( p ) == t_rock_floor );
+}
+
+TEST_CASE( "map_items_on_sparse_tiles" )
+{
+    clear_map();
+    const tripoint p( 60, 60, 0 );
+    // clear_map keeps items, like the debris of furniture destroyed by other tests.
+    g->m.i_clear( p );
+    g->m.i_clear( p + tripoint( 1, 0, 0 ) );
+    CHECK_FALSE( g->m.has_items( p ) );
+    CHECK( g->m.i_at( p ).empty() );
+    CHECK_FALSE( g->m.has_items( p ) );
+
+    g->m.add_item( p, item( "rock" ) );
+    g->m.add_item( p, item( "steel_chunk" ) );
+    REQUIRE( g->m.i_at( p ).size() == 2 );
+    CHECK( g->m.i_at( p ).front().typeId() == "rock" );
+    CHECK_FALSE( g->m.has_items( p + tripoint( 1, 0, 0 ) ) );
+
+    g->m.i_clear( p );
+    CHECK_FALSE( g->m.has_items( p ) );
+    CHECK( g->m.i_at( p ).empty() );
+
+    // Looking at a square doesn't store an item list for it.
+    const tripoint empty( 62, 60, 0 );
+    const submap *const sm = MAPBUFFER.lookup_shared_submap( ms_to_sm_copy( g->m.getabs( empty ) ) );
+    REQUIRE( sm != nullptr );
+    const size_t lists = sm->get_item_lists().size();
+    map_stack stack = g->m.i_at( empty );
+    CHECK( stack.empty() );
+    CHECK( sm->get_item_lists().size() == lists );
+    // Items added through the stack show up in it.
+    stack.push_back( item( "rock" ) );
+    CHECK( stack.size() == 1 );
+    CHECK( g->m.i_at( empty ).size() == 1 );
+    g->m.i_clear( empty );
+}
+
+TEST_CASE( "only_changing_map_items_marks_submaps_modified" )
+{
+    clear_map();
+    const tripoint p( 60, 60, 0 );
+    g->m.add_item( p, item( "rock" ) );
+    submap *const sm = MAPBUFFER.lookup_submap( ms_to_sm_copy( g->m.getabs( p ) ) );
+    REQUIRE( sm != nullptr );
+    REQUIRE( sm->active_items.empty() );
+    sm->saved_generation = sm->modified_generation;
+    REQUIRE_FALSE( sm->is_modified() );
+
+    // Looking at the items doesn't change them.
+    CHECK( g->m.i_at( p ).size() == 1 );
+    CHECK_FALSE( sm->is_modified() );
+
+    g->m.i_at( p ).push_back( item( "rock" ) );
+    CHECK( sm->is_modified() );
+    sm->saved_generation = sm->modified_generation;
+    g->m.i_rem( p, 0 );
+    CHECK( sm->is_modified() );
+    sm->saved_generation = sm->modified_generation;
+    g->m.i_clear( p );
+    CHECK( sm->is_modified() );
+}
+
+TEST_CASE( "reading_temperature_does_not_modify_submaps" )
+{
+    const tripoint p( 60, 60, 0 );
+    submap *const sm = MAPBUFFER.lookup_submap( ms_to_sm_copy( g->m.getabs( p ) ) );
+    REQUIRE( sm != nullptr );
+    g->m.set_temperature( p, 10 );
+    sm->saved_generation = sm->modified_generation;
+    CHECK( g->m.temperature( p ) == 10 );
+    CHECK( sm->modified_generation == sm->saved_generation );
+    g->m.set_temperature( p, 20 );
+    CHECK( g->m.temperature( p ) == 20 );
+    CHECK( sm->modified_generation != sm->saved_generation );
+}
+
+TEST_CASE( "submaps_survive_saving_and_loading" )
+{
+    // Far away from the map, so saving frees the submap and looking it up reads the file.
+    const tripoint p( 1000, 1000, 0 );
+    std::unique_ptr<submap> sm( new submap() );
+    for( int x = 0; x < SEEX; x++ ) {
+        for( int y = 0; y < SEEY; y++ ) {
+            sm->ter[x][y] = ter_id( "t_dirt" );
+        }
+    }
+    sm->ter[1][2] = ter_id( "t_floor" );
+    sm->frn[3][4] = furn_id( "f_chair" );
+    sm->trp[5][6] = trap_str_id( "tr_beartrap" ).id();
+    sm->set_radiation( 7, 8, 10 );
+    sm->fld[9][10].addField( fd_blood, 2, 30 );
+    sm->field_count++;
+    sm->get_items( 11, 11 ).push_back( item( "rock" ) );
+    REQUIRE( MAPBUFFER.add_submap( p, sm ) );
+    MAPBUFFER.save();
+
+    const submap *loaded = MAPBUFFER.lookup_submap( p );
+    REQUIRE( loaded != nullptr );
+    CHECK( loaded->ter[0][0] == ter_id( "t_dirt" ) );
+    CHECK( loaded->ter[1][2] == ter_id( "t_floor" ) );
+    CHECK( loaded->frn[3][4] == furn_id( "f_chair" ) );
+    CHECK( loaded->frn[4][3] == f_null );
+    CHECK( loaded->trp[5][6] == trap_str_id( "tr_beartrap" ).id() );
+    CHECK( loaded->get_radiation( 7, 8 ) == 10 );
+    CHECK( loaded->get_radiation( 8, 7 ) == 0 );
+    REQUIRE( loaded->fld[9][10].findField( fd_blood ) != nullptr );
+    CHECK( loaded->fld[9][10].findField( fd_blood )->getFieldDensity() == 2 );
+    CHECK( loaded->field_count == 1 );
+    REQUIRE( loaded->get_items( 11, 11 ).size() == 1 );
+    CHECK( loaded->get_items( 11, 11 ).front().typeId() == "rock" );
+}
+
+TEST_CASE( "saving_tracks_modified_submaps" )
+{
+    const tripoint p( 1000, 1004, 0 );
+    std::unique_ptr<submap> sm( new submap() );
+    sm->set_ter( 0, 0, ter_id( "t_floor" ) );
+    CHECK( sm->is_modified() );
+    REQUIRE( MAPBUFFER.add_submap( p, sm ) );
+    MAPBUFFER.save();
+
+    submap *const loaded = MAPBUFFER.lookup_submap( p );
+    REQUIRE( loaded != nullptr );
+    CHECK_FALSE( loaded->is_modified() );
+    loaded->set_furn( 1, 1, furn_id( "f_chair" ) );
+    CHECK( loaded->is_modified() );
+    MAPBUFFER.save();
+    // Saving frees the submap, so it is read from the file again.
+    const submap *const reloaded = MAPBUFFER.lookup_submap( p );
+    REQUIRE( reloaded != nullptr );
+    CHECK_FALSE( reloaded->is_modified() );
+    CHECK( reloaded->get_furn( 1, 1 ) == furn_id( "f_chair" ) );
+}
+
+static bool is_loaded( const tripoint &p )
+{
+    return std::any_of( MAPBUFFER.begin(), MAPBUFFER.end(),
+    [&p]( const std::pair<const tripoint, submap *> &elem ) {
+        return elem.first == p;
+    } );
+}
+
+/** Adds a submap at @p p (far away from the main map, in a quad of its own) and evicts it. */
+static void evict_test_submap( const tripoint &p )
+{
+    std::unique_ptr<submap> sm( new submap() );
+    sm->set_ter( 2, 3, ter_id( "t_floor" ) );
+    REQUIRE( MAPBUFFER.add_submap( p, sm ) );
+
+    // Even one MiB is less than the main map needs.
+    auto &limit = get_options().get_option( "MAP_MEMORY_LIMIT" );
+    const std::string old_limit = limit.getValue();
+    limit.setValue( "1" );
+    MAPBUFFER.evict();
+    limit.setValue( old_limit );
+    REQUIRE_FALSE( is_loaded( p ) );
+}
+
+TEST_CASE( "cold_submaps_are_evicted_and_reloaded" )
+{
+    const tripoint p( 1000, 1008, 0 );
+    evict_test_submap( p );
+    background_saves.wait();
+    MAPBUFFER.write_confirmed();
+
+    const submap *const loaded = MAPBUFFER.lookup_submap( p );
+    REQUIRE( loaded != nullptr );
+    CHECK( loaded->get_ter( 2, 3 ) == ter_id( "t_floor" ) );
+    CHECK( is_loaded( p ) );
+}
+
+TEST_CASE( "evicted_submaps_are_kept_until_they_are_written" )
+{
+    const tripoint p( 1000, 1012, 0 );
+    evict_test_submap( p );
+    // Taken back without waiting for the file.
+    const submap *const loaded = MAPBUFFER.lookup_submap( p );
+    REQUIRE( loaded != nullptr );
+    CHECK( loaded->get_ter( 2, 3 ) == ter_id( "t_floor" ) );
+    CHECK( is_loaded( p ) );
+    background_saves.wait();
+
+    const tripoint failed( 1000, 1016, 0 );
+    evict_test_submap( failed );
+    background_saves.wait();
+    MAPBUFFER.write_failed();
+    CHECK( is_loaded( failed ) );
+}
+
+TEST_CASE( "terrain_and_furniture_flags_by_int_id" )
+{
+    clear_map();
+    const tripoint p( 60, 60, 0 );
+    g->m.furn_set( p, furn_id( "f_chair" ) );
+    const flag_int_id mountable = json_flag::intern( "MOUNTABLE" );
+    const flag_int_id unknown = json_flag::find( "TEST_FLAG_ON_NO_TERRAIN" );
+
+    CHECK( furn_id( "f_chair" ).obj().has_flag( mountable ) );
+    CHECK( g->m.has_flag_furn( mountable, p ) );
+    CHECK( g->m.has_flag_ter_or_furn( mountable, p ) );
+    CHECK( g->m.has_flag( mountable, p ) == g->m.has_flag( "MOUNTABLE", p ) );
+    CHECK_FALSE( g->m.has_flag_ter( mountable, p ) );
+    CHECK_FALSE( g->m.has_flag( mountable, p + tripoint( 1, 0, 0 ) ) );
+    CHECK_FALSE( g->m.has_flag( unknown, p ) );
+    CHECK_FALSE( g->m.has_flag( "TEST_FLAG_ON_NO_TERRAIN", p ) );
+    CHECK_FALSE( g->m.has_flag( mountable, tripoint( -1, -1, 0 ) ) );
+}
@@ -0,0 +1,26 @@
+#include "catch/catch.hpp"
+
+#include "options.h"
+
+#include <string>
+
+TEST_CASE( "cached_options_follow_option_changes" )
+{
+    auto &opt = get_options().get_option( "AUTOSAVE_TURNS" );
+    const std::string old_value = opt.getValue();
+    const cached_option<int> turns( "AUTOSAVE_TURNS" );
+
+    opt.setValue( 12 );
+    CHECK( turns == 12 );
+    const unsigned long seen = options_manager::generation();
+    CHECK( turns == 12 );
+    CHECK( options_manager::generation() == seen );
+
+    opt.setValue( "34" );
+    CHECK( options_manager::generation() != seen );
+    CHECK( turns == 34 );
+    CHECK( turns.get() == get_option<int>( "AUTOSAVE_TURNS" ) );
+
+    opt.setValue( old_value );
+    CHECK( turns.get() == get_option<int>( "AUTOSAVE_TURNS" ) );
+}
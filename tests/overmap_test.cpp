@@ -1,9 +1,12 @@
 #include "catch/catch.hpp"
 
+#include "filesystem.h"
 #include "map.h"
 #include "overmap.h"
 #include "overmapbuffer.h"
 
+#include <algorithm>
+
 TEST_CASE( "set_and_get_overmap_scents" )
 {
     std::unique_ptr<overmap> test_overmap = std::unique_ptr<overmap>( new overmap( 0, 0 ) );
@@ -45,3 +48,85 @@ TEST_CASE( "default_overmap_generation_always_succeeds" )
         }
     }
 }
+
+TEST_CASE( "overmap_requested_in_background_matches_neighbours" )
+{
+    // Find an ungenerated overmap next to a generated one.
+    point target;
+    for( point candidate_addr : closest_points_first( 10, { 0, 0 } ) ) {
+        if( !overmap_buffer.has( candidate_addr.x, candidate_addr.y ) ) {
+            target = candidate_addr;
+            break;
+        }
+    }
+    const overmap_handle handle = overmap_buffer.request( target.x, target.y );
+    CHECK( handle.pos() == target );
+    overmap &om = handle.get();
+    CHECK( handle.ready() );
+    CHECK( om.pos() == target );
+    CHECK( overmap_buffer.has( target.x, target.y ) );
+    CHECK( &overmap_buffer.get( target.x, target.y ) == &om );
+
+    // Rivers and roads continue across the edges to the existing neighbours.
+    for( const om_direction::type dir : om_direction::all ) {
+        const point np = target + om_direction::displace( dir );
+        const overmap *const neighbour = overmap_buffer.get_existing( np.x, np.y );
+        if( neighbour == nullptr ) {
+            continue;
+        }
+        const overmap_border theirs = neighbour->get_border( om_direction::opposite( dir ) );
+        const overmap_border ours = om.get_border( dir );
+        for( size_t i = 2; i + 2 < theirs.river.size(); i++ ) {
+            CHECK( ( !theirs.river[i] || ours.river[i] ) );
+        }
+        for( const int road : theirs.roads ) {
+            CHECK( std::count( ours.roads.begin(), ours.roads.end(), road ) > 0 );
+        }
+    }
+}
+
+TEST_CASE( "pregenerated_overmaps_do_not_depend_on_thread_count" )
+{
+    // Large enough that some overmaps can't fit all their specials, the leftovers
+    // are moved to other overmaps while the batch is being finished.
+    const point min( 40, 40 );
+    const point max( 43, 43 );
+    const auto generate = [&]( const unsigned int threads, int &leftovers ) {
+        overmap_buffer.clear();
+        for( int x = min.x - 2; x <= max.x + 2; x++ ) {
+            for( int y = min.y - 2; y <= max.y + 2; y++ ) {
+                remove_file( overmapbuffer::terrain_filename( x, y ) );
+                remove_file( overmapbuffer::player_filename( x, y ) );
+            }
+        }
+        overmap_buffer.generate_area( min, max, 1, threads, nullptr );
+        std::vector<oter_id> result;
+        leftovers = 0;
+        // Including the overmaps around the area that only got leftover specials.
+        for( int omx = min.x - 2; omx <= max.x + 2; omx++ ) {
+            for( int omy = min.y - 2; omy <= max.y + 2; omy++ ) {
+                const bool outside = omx < min.x || omx > max.x || omy < min.y || omy > max.y;
+                if( outside ) {
+                    if( !overmap_buffer.has( omx, omy ) ) {
+                        continue;
+                    }
+                    leftovers++;
+                }
+                const overmap &om = overmap_buffer.get( omx, omy );
+                for( int x = 0; x < OMAPX; x++ ) {
+                    for( int y = 0; y < OMAPY; y++ ) {
+                        result.push_back( om.get_ter( x, y, 0 ) );
+                    }
+                }
+            }
+        }
+        return result;
+    };
+    int single_leftovers = 0;
+    int multiple_leftovers = 0;
+    const std::vector<oter_id> single = generate( 1, single_leftovers );
+    const std::vector<oter_id> multiple = generate( 4, multiple_leftovers );
+    REQUIRE( single_leftovers > 0 );
+    CHECK( single_leftovers == multiple_leftovers );
+    CHECK( single == multiple );
+}
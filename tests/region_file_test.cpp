@@ -0,0 +1,57 @@
+#include "catch/catch.hpp"
+
+#include "filesystem.h"
+#include "region_file.h"
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+TEST_CASE( "region_file_keeps_quads_across_writes" )
+{
+    const std::string path = "region_file_test.region";
+    const region_file region( path );
+    std::string data;
+    CHECK_FALSE( region.read( point( 0, 0 ), data ) );
+
+    region.write( { { point( 0, 0 ), "first" }, { point( 31, 31 ), std::string( 1000, 'x' ) } } );
+    REQUIRE( region.read( point( 0, 0 ), data ) );
+    CHECK( data == "first" );
+    REQUIRE( region.read( point( 31, 31 ), data ) );
+    CHECK( data == std::string( 1000, 'x' ) );
+    CHECK_FALSE( region.read( point( 1, 0 ), data ) );
+
+    // A bigger version of a quad doesn't overwrite its neighbours.
+    region.write( { { point( 0, 0 ), std::string( 2000, 'y' ) }, { point( 1, 0 ), "new" } } );
+    REQUIRE( region.read( point( 0, 0 ), data ) );
+    CHECK( data == std::string( 2000, 'y' ) );
+    REQUIRE( region.read( point( 1, 0 ), data ) );
+    CHECK( data == "new" );
+    REQUIRE( region.read( point( 31, 31 ), data ) );
+    CHECK( data == std::string( 1000, 'x' ) );
+
+    region.remove( { point( 0, 0 ) } );
+    CHECK_FALSE( region.read( point( 0, 0 ), data ) );
+    CHECK( region.read( point( 1, 0 ), data ) );
+
+    CHECK_THROWS( region.read( point( 32, 0 ), data ) );
+    remove_file( path );
+}
+
+TEST_CASE( "region_file_without_table_is_empty" )
+{
+    const std::string path = "region_file_test_short.region";
+    {
+        std::ofstream fout( path, std::ios::binary );
+        fout << "CDDAREG";
+    }
+    const region_file region( path );
+    std::string data;
+    CHECK_FALSE( region.read( point( 0, 0 ), data ) );
+
+    region.write( { { point( 2, 3 ), "quad" } } );
+    REQUIRE( region.read( point( 2, 3 ), data ) );
+    CHECK( data == "quad" );
+    remove_file( path );
+}
@@ -0,0 +1,33 @@
+#include "catch/catch.hpp"
+
+#include "string_id.h"
+
+#include <functional>
+#include <string>
+
+struct string_id_test_type;
+using test_id = string_id<string_id_test_type>;
+
+TEST_CASE( "string_ids_are_interned" )
+{
+    const std::string text = "test_id_a";
+    const test_id a( text );
+    const test_id same( "test_id_a" );
+    const test_id other( "test_id_b" );
+
+    CHECK( a == same );
+    CHECK( a != other );
+    CHECK( a < other );
+    CHECK_FALSE( other < a );
+    CHECK_FALSE( a < same );
+    CHECK( a == "test_id_a" );
+    CHECK( a.str() == text );
+    CHECK( &a.str() == &same.str() );
+    CHECK( std::hash<test_id>()( a ) == std::hash<std::string>()( text ) );
+    CHECK( sizeof( test_id ) == sizeof( void * ) );
+
+    CHECK( test_id().is_empty() );
+    CHECK( test_id( "" ).is_empty() );
+    CHECK( test_id() == test_id( "" ) );
+    CHECK_FALSE( a.is_empty() );
+}
@@ -1,11 +1,16 @@
 #include "catch/catch.hpp"
 
+#include "coordinate_conversions.h"
 #include "game.h"
 #include "map.h"
+#include "mapbuffer.h"
+#include "submap.h"
 #include "vehicle.h"
 #include "veh_type.h"
 #include "player.h"
 
+#include <algorithm>
+
 TEST_CASE( "destroy_grabbed_vehicle_section" )
 {
     GIVEN( "A vehicle grabbed by the player" ) {
@@ -26,3 +31,22 @@ TEST_CASE( "destroy_grabbed_vehicle_section" )
         }
     }
 }
+
+TEST_CASE( "vehicles_are_registered_with_their_submap" )
+{
+    const tripoint origin( 30, 30, 0 );
+    vehicle *veh_ptr = g->m.add_vehicle( vproto_id( "bicycle" ), origin, 0 );
+    REQUIRE( veh_ptr != nullptr );
+    const tripoint sm_pos = ms_to_sm_copy( g->m.getabs( veh_ptr->global_pos3() ) );
+    const auto registered = MAPBUFFER.vehicle_submaps();
+    CHECK( std::any_of( registered.begin(), registered.end(),
+    [&]( const std::pair<tripoint, submap *> &elem ) {
+        return elem.first == sm_pos &&
+               std::count( elem.second->vehicles.begin(), elem.second->vehicles.end(), veh_ptr ) == 1;
+    } ) );
+
+    CHECK_FALSE( veh_ptr->needs_processing_off_map() );
+    veh_ptr->is_alarm_on = true;
+    CHECK( veh_ptr->needs_processing_off_map() );
+    g->m.destroy_vehicle( veh_ptr );
+}
@@ -3,6 +3,7 @@
 #include "calendar.h"
 #include "inventory.h"
 #include "item.h"
+#include "itype.h"
 
 
 TEST_CASE( "visitable_summation" )
@@ -20,3 +21,33 @@ TEST_CASE( "visitable_summation" )
 
     CHECK( test_inv.charges_of( "water", item::INFINITE_CHARGES ) > 1 );
 }
+
+TEST_CASE( "visitable_counts_by_int_id" )
+{
+    inventory test_inv;
+
+    item bottle_of_water( "bottle_plastic", calendar::turn );
+    item water_in_bottle( "water", calendar::turn );
+    water_in_bottle.charges = bottle_of_water.get_remaining_capacity_for_liquid( water_in_bottle );
+    bottle_of_water.put_in( water_in_bottle );
+    test_inv.add_item( bottle_of_water );
+    test_inv.add_item( item( "bottle_plastic", calendar::turn ) );
+
+    const itype_int_id water = item::find_type_index( "water" );
+    const itype_int_id bottle = item::find_type_index( "bottle_plastic" );
+    REQUIRE( water.is_valid() );
+    REQUIRE( bottle.is_valid() );
+    CHECK( water != bottle );
+    CHECK( water->get_id() == "water" );
+    CHECK( bottle_of_water.typeIndex() == bottle );
+
+    CHECK( test_inv.charges_of( water ) == test_inv.charges_of( "water" ) );
+    CHECK( test_inv.charges_of( water ) == water_in_bottle.charges );
+    // The bottle with water in it is no crafting component.
+    CHECK( test_inv.amount_of( bottle ) == 1 );
+    CHECK( test_inv.amount_of( bottle ) == test_inv.amount_of( "bottle_plastic" ) );
+    CHECK( bottle_of_water.charges_of( water ) == water_in_bottle.charges );
+
+    CHECK_FALSE( item::find_type_index( "no_such_item_type" ).is_valid() );
+    CHECK( test_inv.amount_of( "no_such_item_type" ) == 0 );
+}
@@ -0,0 +1,58 @@
+#include "catch/catch.hpp"
+
+#include "calendar.h"
+#include "enums.h"
+#include "simplexnoise.h"
+#include "weather.h"
+
+#include <cstdlib>
+
+static void check_sum( const weather_sum &whole, const weather_sum &first, const weather_sum &second )
+{
+    // Partial samples are rounded, so the parts may be off by one each.
+    CHECK( std::abs( whole.rain_amount - first.rain_amount - second.rain_amount ) <= 1 );
+    CHECK( std::abs( whole.acid_amount - first.acid_amount - second.acid_amount ) <= 1 );
+    CHECK( whole.sunlight == Approx( first.sunlight + second.sunlight ).epsilon( 0.001 ) );
+}
+
+TEST_CASE( "weather_sums_add_up" )
+{
+    const tripoint location( 1234, -567, 0 );
+    const int start = HOURS( 3 ) + 7;
+    const int middle = DAYS( 2 ) + MINUTES( 13 ) + 4;
+    const int end = DAYS( 9 ) + 1;
+
+    // Ask for the later part first, so the earlier one has to be prepended.
+    const weather_sum second = sum_conditions( middle, end, location );
+    const weather_sum first = sum_conditions( start, middle, location );
+    const weather_sum whole = sum_conditions( start, end, location );
+    check_sum( whole, first, second );
+
+    CHECK( whole.sunlight > 0.0f );
+
+    const weather_sum nothing = sum_conditions( middle, middle, location );
+    CHECK( nothing.rain_amount == 0 );
+    CHECK( nothing.acid_amount == 0 );
+    CHECK( nothing.sunlight == 0.0f );
+
+    // Squares of the same cell share their weather.
+    const weather_sum close = sum_conditions( start, end, location + tripoint( 1, 1, 0 ) );
+    CHECK( close.rain_amount == whole.rain_amount );
+    CHECK( close.sunlight == whole.sunlight );
+}
+
+TEST_CASE( "batch_noise_matches_single_points" )
+{
+    const size_t count = 9;
+    float x[count], y[count], z[count], w[count], result[count];
+    for( size_t i = 0; i < count; i++ ) {
+        x[i] = i * 0.37f - 1.5f;
+        y[i] = i * -0.11f + 0.25f;
+        z[i] = i * 1.7f;
+        w[i] = 12345.0f + i * 101;
+    }
+    raw_noise_4d( count, x, y, z, w, result );
+    for( size_t i = 0; i < count; i++ ) {
+        CHECK( result[i] == raw_noise_4d( x[i], y[i], z[i], w[i] ) );
+    }
+}
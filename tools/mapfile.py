@@ -0,0 +1,315 @@
+#!/usr/bin/env python
+"""Run this script with -h for usage info and docs.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import struct
+import sys
+
+parser = argparse.ArgumentParser(description="""Convert map quad files (save/<world>/maps/*/*.map)
+between the binary format written by the game and the JSON format of older versions,
+and convert map directories between one file per quad and region files.
+
+The game reads both formats, so a quad can be exported, inspected or edited, and imported
+again. Quads in the JSON format are converted to the binary format when the game saves them.
+
+The game also reads both layouts of the maps directory: region files (save/<world>/maps/*.region,
+each holding the quads of one 32x32 segment) and one file per quad. Quads are converted to
+the layout that is selected by the "Pack map files" option when the game saves them, pack
+and unpack convert a whole world at once. Don't run them while the world is loaded.
+
+Example usages:
+
+    # Print a quad as JSON.
+    %(prog)s export 0.0.0/3.4.0.map
+
+    # Replace a quad with an edited JSON version of it.
+    %(prog)s import 3.4.0.json 0.0.0/3.4.0.map
+
+    # Move all quads of a world into region files, and back.
+    %(prog)s pack save/World/maps
+    %(prog)s unpack save/World/maps
+""", formatter_class=argparse.RawDescriptionHelpFormatter)
+parser.add_argument("mode",
+        choices=["export", "import", "pack", "unpack"],
+        help="export converts a binary quad to JSON, import converts a JSON quad to binary, "
+             "pack moves the quad files of a maps directory into region files, unpack does the opposite.")
+parser.add_argument("input",
+        help="file to read, or the maps directory for pack and unpack.")
+parser.add_argument("output",
+        nargs="?",
+        help="file to write, the standard output if missing (export only).")
+
+# Keep in sync with binary_map_magic and binary_map_version in src/mapbuffer.cpp.
+MAGIC = b"CDDAMAP\0"
+VERSION = 1
+SEEX = 12
+SEEY = 12
+# Keep in sync with src/region_file.cpp.
+REGION_MAGIC = b"CDDAREG\0"
+REGION_VERSION = 1
+REGION_SIZE = 32
+REGION_SLOTS = REGION_SIZE * REGION_SIZE
+REGION_DATA_START = 16 + REGION_SLOTS * 16
+REGION_BLOCK = 512
+
+
+class Reader(object):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def unpack(self, fmt):
+        fmt = "<" + fmt
+        size = struct.calcsize(fmt)
+        if self.pos + size > len(self.data):
+            raise ValueError("unexpected end of file")
+        values = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += size
+        return values if len(values) > 1 else values[0]
+
+    def string(self):
+        size = self.unpack("I")
+        if self.pos + size > len(self.data):
+            raise ValueError("unexpected end of file")
+        result = self.data[self.pos:self.pos + size].decode("utf-8")
+        self.pos += size
+        return result
+
+    def dictionary(self):
+        return [self.string() for _ in range(self.unpack("I"))]
+
+
+class Writer(object):
+    def __init__(self):
+        self.parts = []
+
+    def pack(self, fmt, *values):
+        self.parts.append(struct.pack("<" + fmt, *values))
+
+    def string(self, value):
+        data = value.encode("utf-8")
+        self.pack("I", len(data))
+        self.parts.append(data)
+
+    def data(self):
+        return b"".join(self.parts)
+
+
+class Dictionary(object):
+    def __init__(self):
+        self.ids = []
+        self.indices = {}
+
+    def index(self, id):
+        if id not in self.indices:
+            self.indices[id] = len(self.ids)
+            self.ids.append(id)
+        return self.indices[id]
+
+    def write(self, writer):
+        writer.pack("I", len(self.ids))
+        for id in self.ids:
+            writer.string(id)
+
+
+def export_quad(data):
+    if data[:len(MAGIC)] != MAGIC:
+        raise ValueError("not a binary map file")
+    reader = Reader(data[len(MAGIC):])
+    version = reader.unpack("I")
+    if version > VERSION:
+        raise ValueError("unsupported map file version %d" % version)
+    terrain_ids = reader.dictionary()
+    furniture_ids = reader.dictionary()
+    trap_ids = reader.dictionary()
+    quad = []
+    for _ in range(reader.unpack("I")):
+        sm = {}
+        x, y, z, sm["version"], sm["turn_last_touched"], sm["temperature"] = reader.unpack("6i")
+        sm["coordinates"] = [x, y, z]
+        sm["terrain"] = [terrain_ids[reader.unpack("H")] for _ in range(SEEX * SEEY)]
+        sm["furniture"] = []
+        for n in range(SEEX * SEEY):
+            furniture = furniture_ids[reader.unpack("H")]
+            if furniture != "f_null":
+                sm["furniture"].append([n % SEEX, n // SEEX, furniture])
+        sm["radiation"] = []
+        cells = 0
+        while cells < SEEX * SEEY:
+            strength, count = reader.unpack("iH")
+            sm["radiation"] += [strength, count]
+            cells += count
+        sm["traps"] = []
+        for _ in range(reader.unpack("H")):
+            i, j, trap = reader.unpack("BBH")
+            sm["traps"].append([i, j, trap_ids[trap]])
+        sm["fields"] = []
+        for _ in range(reader.unpack("H")):
+            i, j, count = reader.unpack("BBB")
+            fields = []
+            for _ in range(count):
+                fields += reader.unpack("3i")
+            sm["fields"] += [i, j, fields]
+        sm["items"] = []
+        for _ in range(reader.unpack("H")):
+            i, j = reader.unpack("BB")
+            sm["items"] += [i, j, json.loads(reader.string())]
+        sm.update(json.loads(reader.string()))
+        quad.append(sm)
+    return quad
+
+
+def import_quad(quad):
+    terrain_ids = Dictionary()
+    furniture_ids = Dictionary()
+    trap_ids = Dictionary()
+    body = Writer()
+    for sm in quad:
+        body.pack("6i", *(sm["coordinates"] + [sm.get("version", 0), sm.get("turn_last_touched", 0),
+                                               sm.get("temperature", 0)]))
+        for ter in sm["terrain"]:
+            body.pack("H", terrain_ids.index(ter))
+        furniture = ["f_null"] * (SEEX * SEEY)
+        for i, j, furn in sm.get("furniture", []):
+            furniture[j * SEEX + i] = furn
+        for furn in furniture:
+            body.pack("H", furniture_ids.index(furn))
+        radiation = sm.get("radiation", [0, SEEX * SEEY])
+        for n in range(0, len(radiation), 2):
+            body.pack("iH", radiation[n], radiation[n + 1])
+        traps = sm.get("traps", [])
+        body.pack("H", len(traps))
+        for i, j, trap in traps:
+            body.pack("BBH", i, j, trap_ids.index(trap))
+        fields = sm.get("fields", [])
+        body.pack("H", len(fields) // 3)
+        for n in range(0, len(fields), 3):
+            i, j, entries = fields[n:n + 3]
+            body.pack("BBB", i, j, len(entries) // 3)
+            body.pack("%di" % len(entries), *entries)
+        items = sm.get("items", [])
+        body.pack("H", len(items) // 3)
+        for n in range(0, len(items), 3):
+            body.pack("BB", items[n], items[n + 1])
+            body.string(json.dumps(items[n + 2], separators=(",", ":")))
+        extras = dict((k, v) for k, v in sm.items() if k in
+                      ("cosmetics", "graffiti", "spawns", "vehicles", "computers", "camp"))
+        body.string(json.dumps(extras, separators=(",", ":")))
+    result = Writer()
+    result.parts.append(MAGIC)
+    result.pack("I", VERSION)
+    terrain_ids.write(result)
+    furniture_ids.write(result)
+    trap_ids.write(result)
+    result.pack("I", len(quad))
+    return result.data() + body.data()
+
+
+def read_region(path):
+    """Returns the quads of a region file by their slot (x, y)."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < REGION_DATA_START or data[:8] != REGION_MAGIC:
+        raise ValueError("{} is not a region file".format(path))
+    version, slots = struct.unpack_from("<II", data, 8)
+    if version > REGION_VERSION or slots != REGION_SLOTS:
+        raise ValueError("{} has an unsupported version".format(path))
+    quads = {}
+    for index in range(REGION_SLOTS):
+        offset, length, _, _ = struct.unpack_from("<IIII", data, 16 + index * 16)
+        if length > 0:
+            if offset + length > len(data):
+                raise ValueError("{} is truncated".format(path))
+            quads[(index % REGION_SIZE, index // REGION_SIZE)] = data[offset:offset + length]
+    return quads
+
+
+def write_region(path, quads):
+    """Writes a new region file with the quads (by their slot), packed without gaps."""
+    table = bytearray(REGION_DATA_START - 16)
+    body = bytearray()
+    for (x, y), quad in sorted(quads.items()):
+        capacity = (len(quad) + REGION_BLOCK - 1) // REGION_BLOCK * REGION_BLOCK
+        struct.pack_into("<IIII", table, (y * REGION_SIZE + x) * 16,
+                         REGION_DATA_START + len(body), len(quad), capacity, 0)
+        body += quad + b"\0" * (capacity - len(quad))
+    with open(path + ".tmp", "wb") as f:
+        f.write(REGION_MAGIC + struct.pack("<II", REGION_VERSION, REGION_SLOTS) + table + body)
+    os.rename(path + ".tmp", path)
+
+
+def segment_of(name, suffix):
+    """Parses the segment coordinates from a "x.y.z" file or directory name."""
+    return tuple(int(value) for value in name[:len(name) - len(suffix)].split("."))
+
+
+def pack_maps(maps):
+    for name in sorted(os.listdir(maps)):
+        directory = os.path.join(maps, name)
+        if not os.path.isdir(directory):
+            continue
+        sx, sy, _ = segment_of(name, "")
+        region = directory + ".region"
+        quads = read_region(region) if os.path.exists(region) else {}
+        files = [f for f in os.listdir(directory) if f.endswith(".map")]
+        for quad_name in files:
+            x, y, _ = segment_of(quad_name, ".map")
+            with open(os.path.join(directory, quad_name), "rb") as f:
+                quads[(x - sx * REGION_SIZE, y - sy * REGION_SIZE)] = f.read()
+        write_region(region, quads)
+        for quad_name in files:
+            os.remove(os.path.join(directory, quad_name))
+        if not os.listdir(directory):
+            os.rmdir(directory)
+        print("{}: {} quads".format(region, len(quads)))
+
+
+def unpack_maps(maps):
+    for name in sorted(os.listdir(maps)):
+        if not name.endswith(".region"):
+            continue
+        sx, sy, sz = segment_of(name, ".region")
+        region = os.path.join(maps, name)
+        directory = region[:-len(".region")]
+        if not os.path.isdir(directory):
+            os.mkdir(directory)
+        quads = read_region(region)
+        for (x, y), quad in quads.items():
+            quad_name = "{}.{}.{}.map".format(sx * REGION_SIZE + x, sy * REGION_SIZE + y, sz)
+            quad_path = os.path.join(directory, quad_name)
+            # A quad file is newer than the region, the game removes the outdated copy when
+            # it saves a quad.
+            if not os.path.exists(quad_path):
+                with open(quad_path, "wb") as f:
+                    f.write(quad)
+        os.remove(region)
+        print("{}: {} quads".format(directory, len(quads)))
+
+
+if __name__ == "__main__":
+    args = parser.parse_args()
+    if args.mode == "export":
+        with open(args.input, "rb") as f:
+            quad = export_quad(f.read())
+        if args.output:
+            with open(args.output, "w") as f:
+                json.dump(quad, f, indent=2)
+        else:
+            json.dump(quad, sys.stdout, indent=2)
+            print()
+    elif args.mode == "pack":
+        pack_maps(args.input)
+    elif args.mode == "unpack":
+        unpack_maps(args.input)
+    else:
+        if not args.output:
+            parser.error("import needs an output file")
+        with open(args.input) as f:
+            data = import_quad(json.load(f))
+        with open(args.output, "wb") as f:
+            f.write(data)